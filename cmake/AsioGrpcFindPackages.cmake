@@ -34,6 +34,25 @@ endif()
 
 if(ASIO_GRPC_ENABLE_CPP20_TESTS_AND_EXAMPLES)
     find_package(unifex)
+    find_package(stdexec)
+    if(NOT TARGET STDEXEC::stdexec AND ASIO_GRPC_FETCH_STDEXEC)
+        include(FetchContent)
+        set(STDEXEC_BUILD_TESTS
+            off
+            CACHE BOOL "")
+        set(STDEXEC_BUILD_EXAMPLES
+            off
+            CACHE BOOL "")
+        FetchContent_Declare(
+            stdexec
+            GIT_REPOSITORY "https://github.com/NVIDIA/stdexec.git"
+            GIT_TAG "${ASIO_GRPC_STDEXEC_GIT_TAG}"
+            GIT_SHALLOW on)
+        FetchContent_MakeAvailable(stdexec)
+        if(NOT TARGET STDEXEC::stdexec)
+            message(FATAL_ERROR "ASIO_GRPC_FETCH_STDEXEC is enabled but stdexec did not provide STDEXEC::stdexec")
+        endif()
+    endif()
     if(${CMAKE_SYSTEM_NAME} STREQUAL "Linux")
         find_package(PkgConfig)
         pkg_check_modules(liburing IMPORTED_TARGET GLOBAL liburing)
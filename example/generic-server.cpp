@@ -20,7 +20,7 @@
 #include <agrpc/asio_grpc.hpp>
 #include <boost/asio/bind_executor.hpp>
 #include <boost/asio/detached.hpp>
-#include <boost/asio/experimental/channel.hpp>
+#include <boost/asio/experimental/as_tuple.hpp>
 #include <boost/asio/spawn.hpp>
 #include <boost/asio/thread_pool.hpp>
 #include <grpcpp/generic/async_generic_service.h>
@@ -78,7 +78,8 @@ void handle_generic_unary_request(grpc::GenericServerAsyncReaderWriter& reader_w
 // back to the client.
 // ---------------------------------------------------
 // end-snippet
-using Channel = asio::experimental::channel<agrpc::GrpcExecutor, void(boost::system::error_code, grpc::ByteBuffer)>;
+// agrpc::Channel does not lock a mutex and allocates waiting operations from the GrpcContext's memory pool.
+using Channel = agrpc::Channel<grpc::ByteBuffer>;
 
 template <class Handler>
 void reader(grpc::GenericServerAsyncReaderWriter& reader_writer, Channel& channel,
@@ -93,8 +94,7 @@ void reader(grpc::GenericServerAsyncReaderWriter& reader_writer, Channel& channe
             break;
         }
         // Send request to writer. The `max_buffer_size` of the channel acts as backpressure.
-        boost::system::error_code ec;
-        channel.async_send(boost::system::error_code{}, std::move(buffer), yield[ec]);
+        channel.send(std::move(buffer), yield);
     }
     // Signal the writer to complete.
     channel.close();
@@ -122,9 +122,8 @@ bool writer(grpc::GenericServerAsyncReaderWriter& reader_writer, Channel& channe
     bool ok{true};
     while (ok)
     {
-        boost::system::error_code ec;
-        auto buffer = channel.async_receive(yield[ec]);
-        if (ec)
+        auto [received, buffer] = channel.receive(asio::experimental::as_tuple(yield));
+        if (!received)
         {
             break;
         }
@@ -179,6 +178,28 @@ void handle_generic_bidistream_request(agrpc::GrpcContext& grpc_context,
 // ---------------------------------------------------
 //
 
+// Routes are looked up with a single hash computation and string comparison, no matter how many methods are served.
+using MethodHandler = void (*)(agrpc::GrpcContext&, grpc::GenericServerAsyncReaderWriter&, asio::thread_pool&,
+                               const asio::yield_context&);
+
+const agrpc::GenericRouter<MethodHandler>& method_router()
+{
+    static const agrpc::GenericRouter<MethodHandler> router{
+        {{agrpc::generic_method_name<agrpc::RPC<&example::v1::Example::Stub::PrepareAsyncUnary>>(),
+          [](agrpc::GrpcContext&, grpc::GenericServerAsyncReaderWriter& reader_writer, asio::thread_pool&,
+             const asio::yield_context& yield)
+          {
+              handle_generic_unary_request(reader_writer, yield);
+          }},
+         {agrpc::generic_method_name<agrpc::RPC<&example::v1::Example::Stub::PrepareAsyncBidirectionalStreaming>>(),
+          &handle_generic_bidistream_request}},
+        [](agrpc::GrpcContext&, grpc::GenericServerAsyncReaderWriter&, asio::thread_pool&, const asio::yield_context&)
+        {
+            throw std::runtime_error("Unsupport method!");
+        }};
+    return router;
+}
+
 struct GenericRequestHandler
 {
     using executor_type = agrpc::GrpcContext::executor_type;
@@ -191,19 +212,8 @@ struct GenericRequestHandler
         example::spawn(grpc_context,
                        [&, context = std::move(context)](asio::yield_context yield)
                        {
-                           const auto& method = context.server_context().method();
-                           if ("/example.v1.Example/Unary" == method)
-                           {
-                               handle_generic_unary_request(context.responder(), yield);
-                           }
-                           else if ("/example.v1.Example/BidirectionalStreaming" == method)
-                           {
-                               handle_generic_bidistream_request(grpc_context, context.responder(), thread_pool, yield);
-                           }
-                           else
-                           {
-                               throw std::runtime_error("Unsupport method!");
-                           }
+                           const auto handler = method_router().find(context.server_context().method());
+                           handler(grpc_context, context.responder(), thread_pool, yield);
                        });
     }
 
@@ -26,7 +26,10 @@
 #include <grpcpp/create_channel.h>
 
 #include <cassert>
+#include <chrono>
+#include <cstdint>
 #include <optional>
+#include <vector>
 
 namespace asio = boost::asio;
 
@@ -180,6 +183,24 @@ asio::awaitable<void> bidirectional_streaming(example::v1::Example::Stub& stub)
     silence_unused(request_ok, write_ok, writes_done_ok, write_last_ok, read_ok, finish_ok);
 }
 
+asio::awaitable<void> with_timeout(
+    agrpc::GrpcContext& grpc_context, grpc::ClientContext& client_context,
+    grpc::ClientAsyncReaderWriter<example::v1::Request, example::v1::Response>& reader_writer)
+{
+    /* [with-timeout-client-side] */
+    example::v1::Response response;
+    bool read_ok = co_await agrpc::with_timeout(
+        grpc_context, client_context, std::chrono::system_clock::now() + std::chrono::seconds(1),
+        [&](auto&& token)
+        {
+            return agrpc::read(reader_writer, response, std::move(token));
+        },
+        asio::use_awaitable);
+    /* [with-timeout-client-side] */
+
+    silence_unused(read_ok);
+}
+
 asio::awaitable<void> bidirectional_streaming_alt(example::v1::Example::Stub& stub)
 {
     /* [request-bidirectional-client-side-alt] */
@@ -316,6 +337,189 @@ asio::awaitable<void> server_streaming_cancel_safe(agrpc::GrpcContext& grpc_cont
     /* [cancel-safe-server-streaming] */
 }
 
+asio::awaitable<void> server_streaming_selector(agrpc::GrpcContext& grpc_context, example::v1::Example::Stub& stub)
+{
+    /* [selector-client-side] */
+    grpc::ClientContext client_context_a;
+    grpc::ClientContext client_context_b;
+    example::v1::Request request;
+    std::unique_ptr<grpc::ClientAsyncReader<example::v1::Response>> reader_a;
+    std::unique_ptr<grpc::ClientAsyncReader<example::v1::Response>> reader_b;
+    co_await agrpc::request(&example::v1::Example::Stub::PrepareAsyncServerStreaming, stub, client_context_a, request,
+                            reader_a);
+    co_await agrpc::request(&example::v1::Example::Stub::PrepareAsyncServerStreaming, stub, client_context_b, request,
+                            reader_b);
+
+    enum Source : std::size_t
+    {
+        STREAM_A,
+        STREAM_B,
+        TICK
+    };
+    agrpc::Selector<3> selector{grpc_context};
+
+    // Register all operations once.
+    example::v1::Response response_a;
+    example::v1::Response response_b;
+    grpc::Alarm alarm;
+    selector.initiate(STREAM_A, agrpc::read, reader_a, response_a)
+        .initiate(STREAM_B, agrpc::read, reader_b, response_b)
+        .initiate(TICK, agrpc::wait, alarm, hundred_milliseconds_from_now());
+
+    bool a_ok{true};
+    bool b_ok{true};
+    while (a_ok || b_ok)
+    {
+        const auto [source, ok] = co_await selector.next();
+        // Only the completed operation is re-initiated, the others remain armed.
+        if (STREAM_A == source)
+        {
+            a_ok = ok;
+            if (ok)
+            {
+                selector.initiate(STREAM_A, agrpc::read, reader_a, response_a);
+            }
+        }
+        else if (STREAM_B == source)
+        {
+            b_ok = ok;
+            if (ok)
+            {
+                selector.initiate(STREAM_B, agrpc::read, reader_b, response_b);
+            }
+        }
+        else
+        {
+            selector.initiate(TICK, agrpc::wait, alarm, hundred_milliseconds_from_now());
+        }
+    }
+    alarm.Cancel();
+    co_await selector.cleanup();
+    /* [selector-client-side] */
+}
+
+/* [client-middleware-interceptors] */
+struct InjectAuthorization
+{
+    void before(grpc::ClientContext& client_context) { client_context.AddMetadata("authorization", "Bearer token"); }
+};
+
+struct CountFailures
+{
+    int* failures;
+
+    void after(grpc::ClientContext&, const grpc::Status& status) noexcept
+    {
+        if (!status.ok())
+        {
+            ++*failures;
+        }
+    }
+};
+/* [client-middleware-interceptors] */
+
+asio::awaitable<void> client_middleware(agrpc::GrpcContext& grpc_context, example::v1::Example::Stub& stub)
+{
+    /* [client-middleware] */
+    int failures{};
+    const agrpc::ClientMiddleware client{stub, InjectAuthorization{}, CountFailures{&failures}};
+    grpc::ClientContext client_context;
+    example::v1::Request request;
+    example::v1::Response response;
+    grpc::Status status = co_await client.request<&example::v1::Example::Stub::PrepareAsyncUnary>(
+        grpc_context, client_context, request, response);
+    /* [client-middleware] */
+
+    silence_unused(status);
+}
+
+/* [task-request] */
+agrpc::Task<int> unary_with_task(agrpc::GrpcContext& grpc_context, example::v1::Example::Stub& stub)
+{
+    grpc::ClientContext client_context;
+    client_context.set_deadline(std::chrono::system_clock::now() + std::chrono::seconds(5));
+    example::v1::Request request;
+    example::v1::Response response;
+    const grpc::Status status = co_await agrpc::RPC<&example::v1::Example::Stub::PrepareAsyncUnary>::request(
+        grpc_context, stub, client_context, request, response, agrpc::use_sender);
+    co_return status.ok() ? response.integer() : -1;
+}
+/* [task-request] */
+
+void task(agrpc::GrpcContext& grpc_context, example::v1::Example::Stub& stub)
+{
+    /* [task-spawn] */
+    agrpc::co_spawn(grpc_context, unary_with_task(grpc_context, stub),
+                    [](std::exception_ptr exception, int result)
+                    {
+                        silence_unused(exception, result);
+                    });
+    /* [task-spawn] */
+}
+
+void any_executor(agrpc::GrpcContext& grpc_context, example::v1::Example::Stub& stub)
+{
+    /* [any-executor-awaitable] */
+    static constexpr asio::use_awaitable_t<agrpc::AnyExecutor> USE_AWAITABLE{};
+    asio::co_spawn(
+        grpc_context,
+        [&]() -> asio::awaitable<void, agrpc::AnyExecutor>
+        {
+            grpc::ClientContext client_context;
+            client_context.set_deadline(std::chrono::system_clock::now() + std::chrono::seconds(5));
+            example::v1::Request request;
+            example::v1::Response response;
+            const grpc::Status status = co_await agrpc::RPC<&example::v1::Example::Stub::PrepareAsyncUnary>::request(
+                grpc_context, stub, client_context, request, response, USE_AWAITABLE);
+            silence_unused(status);
+        },
+        asio::detached);
+    /* [any-executor-awaitable] */
+}
+
+asio::awaitable<void> request_all(agrpc::GrpcContext& grpc_context, example::v1::Example::Stub& stub)
+{
+    /* [request-all-client-side] */
+    std::vector<example::v1::Request> requests(50);
+    agrpc::RequestAllOptions options;
+    options.deadline = std::chrono::system_clock::now() + std::chrono::seconds(5);
+    options.cancel_on_error = true;
+    const std::vector<agrpc::UnaryResult<example::v1::Response>> results = co_await agrpc::request_all(
+        grpc_context, &example::v1::Example::Stub::PrepareAsyncUnary, stub, requests, options, asio::use_awaitable);
+    for (const auto& [status, response] : results)
+    {
+        silence_unused(status, response);
+    }
+    /* [request-all-client-side] */
+}
+
+asio::awaitable<void> client_multiplexer(agrpc::GrpcContext& grpc_context, example::v1::Example::Stub& stub)
+{
+    /* [client-multiplexer] */
+    // The correlation id is stored in the upper bits of `integer`.
+    struct CorrelationTraits
+    {
+        static std::uint64_t get_id(const example::v1::Response& response)
+        {
+            return static_cast<std::uint32_t>(response.integer()) >> 16;
+        }
+
+        static void set_id(example::v1::Request& request, std::uint64_t id)
+        {
+            request.set_integer(static_cast<std::int32_t>((id << 16) | (request.integer() & 0xFFFF)));
+        }
+    };
+    agrpc::ClientMultiplexer<&example::v1::Example::Stub::PrepareAsyncBidirectionalStreaming, CorrelationTraits>
+        multiplexer{grpc_context, stub, 4, std::chrono::seconds(5)};
+    example::v1::Request request;
+    request.set_integer(42);
+    example::v1::Response response;
+    const grpc::Status status = co_await multiplexer.request(request, response, asio::use_awaitable);
+    co_await multiplexer.shutdown(asio::use_awaitable);
+    /* [client-multiplexer] */
+    silence_unused(status);
+}
+
 asio::awaitable<void> mock_stub(agrpc::GrpcContext& grpc_context)
 {
     /* [mock-stub] */
@@ -21,17 +21,26 @@
 #include <boost/asio/bind_executor.hpp>
 #include <boost/asio/co_spawn.hpp>
 #include <boost/asio/coroutine.hpp>
+#include <boost/asio/deferred.hpp>
 #include <boost/asio/detached.hpp>
+#include <boost/asio/experimental/awaitable_operators.hpp>
 #include <boost/asio/experimental/promise.hpp>
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/spawn.hpp>
+#include <boost/asio/thread_pool.hpp>
 #include <boost/asio/use_awaitable.hpp>
 #include <grpcpp/server.h>
 #include <grpcpp/server_builder.h>
 
+#include <atomic>
 #include <cassert>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <optional>
+#include <thread>
+#include <vector>
 
 #if (BOOST_VERSION >= 108100)
 #include <boost/asio/experimental/use_promise.hpp>
@@ -242,6 +251,85 @@ asio::awaitable<void> bidirectional_streaming(example::v1::Example::AsyncService
     silence_unused(request_ok, read_ok, write_last_ok, write_and_finish_ok, write_ok, finish_ok);
 }
 
+asio::awaitable<void> deferred_read_process_write(
+    grpc::ServerAsyncReaderWriter<example::v1::Response, example::v1::Request>& reader_writer)
+{
+    /* [deferred-read-process-write-server-side] */
+    example::v1::Request request;
+    example::v1::Response response;
+    auto read_process_write = agrpc::read(reader_writer, request,
+                                          asio::deferred(
+                                              [&](bool)
+                                              {
+                                                  response.set_integer(request.integer() * 2);
+                                                  return agrpc::write(reader_writer, response, asio::deferred);
+                                              }));
+    bool write_ok = co_await std::move(read_process_write)(asio::use_awaitable);
+    /* [deferred-read-process-write-server-side] */
+
+    silence_unused(write_ok);
+}
+
+asio::awaitable<void> channel(agrpc::GrpcContext& grpc_context, asio::thread_pool& thread_pool)
+{
+    /* [channel-server-side] */
+    // At most 16 values are buffered, try_send() fails when the buffer is full.
+    agrpc::Channel<example::v1::Response> channel{grpc_context, 16};
+
+    // Compute responses on the thread_pool and hand them over to the GrpcContext without locking.
+    asio::post(thread_pool,
+               [&]
+               {
+                   example::v1::Response response;
+                   response.set_integer(42);
+                   while (!channel.try_send(std::move(response)))
+                   {
+                       std::this_thread::yield();
+                   }
+               });
+
+    // Receive on the GrpcContext.
+    auto [ok, response] = co_await channel.receive(asio::use_awaitable);
+    /* [channel-server-side] */
+
+    silence_unused(ok, response);
+}
+
+asio::awaitable<void> offload(agrpc::GrpcContext& grpc_context, asio::thread_pool& thread_pool)
+{
+    /* [offload-server-side] */
+    // Run the computation on the thread_pool and resume on the GrpcContext once it is done.
+    example::v1::Response response = co_await agrpc::offload(
+        grpc_context, thread_pool.get_executor(),
+        []
+        {
+            example::v1::Response response;
+            response.set_integer(42);
+            return response;
+        },
+        asio::use_awaitable);
+    /* [offload-server-side] */
+
+    silence_unused(response);
+}
+
+asio::awaitable<void> propagation_context(agrpc::GrpcContext& grpc_context, example::v1::Example::Stub& stub,
+                                          grpc::ServerContext& server_context, const example::v1::Request& request)
+{
+    /* [propagation-context-server-side] */
+    // Leave 100ms for processing the downstream response.
+    agrpc::PropagationContext context{server_context, std::chrono::milliseconds(100)};
+    agrpc::PropagatedClientContext client_context{context};
+    example::v1::Response response;
+    using RPC = agrpc::RPC<&example::v1::Example::Stub::PrepareAsyncUnary>;
+    grpc::Status status = co_await RPC::request(grpc_context, stub, client_context.client_context(), request, response,
+                                                asio::use_awaitable);
+    // Elsewhere, upon completion of agrpc::notify_when_done: if (server_context.IsCancelled()) context.cancel();
+    /* [propagation-context-server-side] */
+
+    silence_unused(status);
+}
+
 asio::awaitable<void> server_generic_request(grpc::AsyncGenericService& service)
 {
     /* [request-generic-server-side] */
@@ -254,6 +342,24 @@ asio::awaitable<void> server_generic_request(grpc::AsyncGenericService& service)
     silence_unused(request_ok);
 }
 
+void generic_router(agrpc::GrpcContext& grpc_context, grpc::AsyncGenericService& service)
+{
+    /* [generic-router-server-side] */
+    using Handler = void (*)(agrpc::GenericRepeatedlyRequestContext<>&&);
+    static const agrpc::GenericRouter<Handler> router{
+        {{agrpc::generic_method_name<agrpc::RPC<&example::v1::Example::Stub::PrepareAsyncUnary>>(),
+          [](agrpc::GenericRepeatedlyRequestContext<>&&)
+          {
+              // Handle "/example.v1.Example/Unary"
+          }}},
+        [](agrpc::GenericRepeatedlyRequestContext<>&&)
+        {
+            // Unknown method, e.g. finish with grpc::StatusCode::UNIMPLEMENTED
+        }};
+    agrpc::repeatedly_request(service, asio::bind_executor(grpc_context, std::cref(router)));
+    /* [generic-router-server-side] */
+}
+
 void io_context(agrpc::GrpcContext& grpc_context, example::v1::Example::AsyncService& service)
 {
     /* [bind-executor-to-use-awaitable] */
@@ -343,6 +449,48 @@ void register_client_streaming_handler(agrpc::GrpcContext& grpc_context, example
 }
 /* [repeatedly-request-awaitable] */
 
+/* [server-middleware] */
+struct Authenticate
+{
+    grpc::Status before(grpc::ServerContext& server_context)
+    {
+        if (server_context.client_metadata().count("authorization") == 0)
+        {
+            return grpc::Status{grpc::StatusCode::UNAUTHENTICATED, "missing authorization"};
+        }
+        return grpc::Status::OK;
+    }
+};
+
+struct MeasureLatency
+{
+    std::chrono::steady_clock::time_point start;
+
+    void before(grpc::ServerContext&) { start = std::chrono::steady_clock::now(); }
+
+    void after(grpc::ServerContext&) noexcept
+    {
+        // Record std::chrono::steady_clock::now() - start
+    }
+};
+
+void register_unary_handler_with_middleware(agrpc::GrpcContext& grpc_context,
+                                            example::v1::Example::AsyncService& service)
+{
+    auto request_handler = asio::bind_executor(
+        grpc_context,
+        [](grpc::ServerContext&, example::v1::Request&,
+            grpc::ServerAsyncResponseWriter<example::v1::Response>& writer) -> asio::awaitable<void>
+        {
+            example::v1::Response response;
+            co_await agrpc::finish(writer, response, grpc::Status::OK, asio::use_awaitable);
+        });
+    // Interceptors run in order of declaration: MeasureLatency also observes RPCs rejected by Authenticate.
+    agrpc::repeatedly_request(&example::v1::Example::AsyncService::RequestUnary, service,
+                              agrpc::ServerMiddleware{request_handler, MeasureLatency{}, Authenticate{}});
+}
+/* [server-middleware] */
+
 void create_server_grpc_context()
 {
     /* [create-grpc_context-server-side] */
@@ -385,6 +533,258 @@ void health_check_service()
     /* [add-health-check-service] */
 }
 
+void server_drainer(example::v1::Example::AsyncService& service)
+{
+    /* [server-drainer] */
+    grpc::ServerBuilder builder;
+    agrpc::GrpcContext grpc_context{builder.AddCompletionQueue()};
+    builder.AddListeningPort("0.0.0.0:50051", grpc::InsecureServerCredentials());
+    builder.RegisterService(&service);
+    std::unique_ptr<grpc::Server> server = builder.BuildAndStart();
+    agrpc::ServerDrainer drainer{*server, grpc_context};
+
+    agrpc::repeatedly_request(
+        &example::v1::Example::AsyncService::RequestUnary, service,
+        asio::bind_executor(
+            grpc_context,
+            [](grpc::ServerContext&, example::v1::Request&,
+                grpc::ServerAsyncResponseWriter<example::v1::Response>& writer) -> asio::awaitable<void>
+            {
+                // The RPC counts as in-flight until the guard is destroyed.
+                const auto guard = drainer.track(grpc_context);
+                co_await agrpc::finish(writer, example::v1::Response{}, grpc::Status::OK, asio::use_awaitable);
+            }));
+
+    // Must not be called from the thread that runs the GrpcContext, e.g. upon receiving SIGTERM.
+    std::thread drain_thread{[&]
+                             {
+                                 drainer.drain(std::chrono::system_clock::now() + std::chrono::seconds(30));
+                             }};
+    grpc_context.run();
+    drain_thread.join();
+    /* [server-drainer] */
+}
+
+void rpc_registry(agrpc::GrpcContext& grpc_context, example::v1::Example::AsyncService& service,
+                  agrpc::RPCRegistry& registry)
+{
+    /* [rpc-registry-server-side] */
+    agrpc::repeatedly_request(
+        &example::v1::Example::AsyncService::RequestUnary, service,
+        asio::bind_executor(
+            grpc_context,
+            [&](grpc::ServerContext& server_context, example::v1::Request&,
+                grpc::ServerAsyncResponseWriter<example::v1::Response>& writer) -> asio::awaitable<void>
+            {
+                // Registration does not allocate, the RPC is unregistered when the coroutine completes.
+                agrpc::RPCRegistration registration{registry, server_context, "/example.v1.Example/Unary"};
+                co_await agrpc::finish(writer, example::v1::Response{}, grpc::Status::OK, asio::use_awaitable);
+            }));
+
+    // Periodically, on the thread that runs the GrpcContext: advance the start time of new registrations and cancel all
+    // RPCs that have been running for more than a minute.
+    registry.tick();
+    const auto one_minute_ago = registry.now() - std::chrono::minutes(1);
+    registry.cancel_if(
+        [&](const agrpc::RPCRegistration& registration)
+        {
+            return registration.start_time() < one_minute_ago;
+        });
+    /* [rpc-registry-server-side] */
+}
+
+asio::awaitable<void> rpc_arena(agrpc::GrpcContext& grpc_context, example::v1::Example::AsyncService& service)
+{
+    /* [rpc-arena-server-side] */
+    // All operations of this RPC allocate from the arena. Its memory is returned to the GrpcContext's pool at once
+    // when it is destroyed.
+    agrpc::RPCArena arena{grpc_context};
+    const auto token = agrpc::bind_allocator(arena.get_allocator(), asio::use_awaitable);
+    grpc::ServerContext server_context;
+    example::v1::Request request;
+    grpc::ServerAsyncResponseWriter<example::v1::Response> writer{&server_context};
+    co_await agrpc::request(&example::v1::Example::AsyncService::RequestUnary, service, server_context, request, writer,
+                            token);
+    example::v1::Response response;
+    response.set_integer(request.integer());
+    co_await agrpc::finish(writer, response, grpc::Status::OK, token);
+    /* [rpc-arena-server-side] */
+}
+
+asio::awaitable<void> message_pool(grpc::ServerAsyncReader<example::v1::Response, example::v1::Request>& reader)
+{
+    /* [message-pool-server-side] */
+    agrpc::MessagePool<example::v1::Request> pool;
+    while (true)
+    {
+        // Deserializes into a previously returned message, reusing the capacity of its fields.
+        auto request = pool.acquire();
+        if (!co_await agrpc::read(reader, *request, asio::use_awaitable))
+        {
+            break;
+        }
+        // Process the request. It is returned to the pool when `request` is destroyed.
+    }
+    /* [message-pool-server-side] */
+}
+
+asio::awaitable<void> parse_pipeline(agrpc::GrpcContext& grpc_context, asio::thread_pool& thread_pool,
+                                     grpc::GenericServerAsyncReaderWriter& reader_writer)
+{
+    /* [parse-pipeline-server-side] */
+    std::atomic_int64_t sum{};
+    auto pipeline = agrpc::make_parse_pipeline<example::v1::Request>(
+        grpc_context, thread_pool.get_executor(), 8,
+        [&](const grpc::Status& status, example::v1::Request& request) noexcept
+        {
+            // Runs on the thread_pool.
+            if (status.ok())
+            {
+                sum += request.integer();
+            }
+        });
+    grpc::ByteBuffer buffer;
+    while (co_await agrpc::read(reader_writer, buffer, asio::use_awaitable))
+    {
+        // Waits only if eight messages are already being parsed or processed.
+        co_await pipeline.submit(buffer, asio::use_awaitable);
+    }
+    co_await pipeline.wait_idle(asio::use_awaitable);
+    /* [parse-pipeline-server-side] */
+}
+
+asio::awaitable<void> ordered_stage(
+    agrpc::GrpcContext& grpc_context, asio::thread_pool& thread_pool,
+    grpc::ServerAsyncReaderWriter<example::v1::Response, example::v1::Request>& reader_writer)
+{
+    /* [ordered-stage-server-side] */
+    // Up to eight requests are processed concurrently on the thread_pool.
+    auto stage = agrpc::make_ordered_stage<example::v1::Response>(grpc_context, thread_pool.get_executor(), 8);
+    auto read = [&]() -> asio::awaitable<void>
+    {
+        example::v1::Request request;
+        while (co_await agrpc::read(reader_writer, request, asio::use_awaitable))
+        {
+            co_await stage.submit(
+                [request]
+                {
+                    example::v1::Response response;
+                    response.set_integer(request.integer() * 2);
+                    return response;
+                },
+                asio::use_awaitable);
+        }
+        stage.close();
+    };
+    auto write = [&]() -> asio::awaitable<void>
+    {
+        bool write_ok{true};
+        while (true)
+        {
+            // Responses are obtained in request order.
+            auto [ok, response] = co_await stage.next(asio::use_awaitable);
+            if (!ok)
+            {
+                break;
+            }
+            if (write_ok)
+            {
+                write_ok = co_await agrpc::write(reader_writer, response, asio::use_awaitable);
+            }
+        }
+    };
+    using namespace asio::experimental::awaitable_operators;
+    co_await (read() && write());
+    /* [ordered-stage-server-side] */
+}
+
+asio::awaitable<void> server_demultiplexer(
+    agrpc::GrpcContext& grpc_context,
+    grpc::ServerAsyncReaderWriter<example::v1::Response, example::v1::Request>& reader_writer)
+{
+    /* [server-demultiplexer] */
+    struct CorrelationTraits
+    {
+        static std::uint64_t get_id(const example::v1::Request& request)
+        {
+            return static_cast<std::uint32_t>(request.integer()) >> 16;
+        }
+
+        static void set_id(example::v1::Response& response, std::uint64_t id)
+        {
+            response.set_integer(static_cast<std::int32_t>((id << 16) | (response.integer() & 0xFFFF)));
+        }
+    };
+    using Demultiplexer = agrpc::ServerDemultiplexer<example::v1::Request, example::v1::Response, CorrelationTraits>;
+    Demultiplexer demultiplexer{grpc_context, reader_writer};
+    co_await demultiplexer.run(
+        [](example::v1::Request&& request, Demultiplexer::Responder&& responder)
+        {
+            example::v1::Response response;
+            response.set_integer(request.integer() & 0xFFFF);
+            responder.send(response);
+        },
+        asio::use_awaitable);
+    co_await agrpc::finish(reader_writer, grpc::Status::OK, asio::use_awaitable);
+    /* [server-demultiplexer] */
+}
+
+asio::awaitable<void> deadline_scheduler(agrpc::GrpcContext& grpc_context, example::v1::Example::AsyncService& service)
+{
+    /* [deadline-scheduler] */
+    // Usually shared by all RPCs of a GrpcContext.
+    agrpc::DeadlineScheduler scheduler{grpc_context};
+    grpc::ServerContext server_context;
+    example::v1::Request request;
+    grpc::ServerAsyncResponseWriter<example::v1::Response> writer{&server_context};
+    co_await agrpc::request(&example::v1::Example::AsyncService::RequestUnary, service, server_context, request,
+                            writer, asio::use_awaitable);
+    // Continue on the scheduler so that, under load, this RPC is served before RPCs with a later deadline.
+    co_await asio::post(scheduler.get_executor(server_context), asio::use_awaitable);
+    example::v1::Response response;
+    response.set_integer(request.integer());
+    co_await agrpc::finish(writer, response, grpc::Status::OK, asio::use_awaitable);
+    /* [deadline-scheduler] */
+}
+
+asio::awaitable<void> fair_scheduler(agrpc::GrpcContext& grpc_context, example::v1::Example::AsyncService& service)
+{
+    /* [fair-scheduler] */
+    // Usually shared by all RPCs of a GrpcContext. One class per tenant.
+    agrpc::FairScheduler scheduler{grpc_context, 2};
+    scheduler.set_weight(1, 4);
+    grpc::ServerContext server_context;
+    example::v1::Request request;
+    grpc::ServerAsyncResponseWriter<example::v1::Response> writer{&server_context};
+    co_await agrpc::request(&example::v1::Example::AsyncService::RequestUnary, service, server_context, request,
+                            writer, asio::use_awaitable);
+    const auto tenant = static_cast<std::size_t>(request.integer() % 2);
+    // Continue on the scheduler so that requests of other tenants are interleaved with this one.
+    co_await asio::post(scheduler.get_executor(tenant), asio::use_awaitable);
+    example::v1::Response response;
+    co_await agrpc::finish(writer, response, grpc::Status::OK, asio::use_awaitable);
+    /* [fair-scheduler] */
+}
+
+asio::awaitable<void> yield_to_completion_queue(agrpc::GrpcContext& grpc_context,
+                                                grpc::ServerAsyncWriter<example::v1::Response>& writer,
+                                                const std::vector<int>& rows)
+{
+    /* [yield-server-side] */
+    example::v1::Response response;
+    for (std::size_t i{}; i < rows.size(); ++i)
+    {
+        response.set_integer(response.integer() + rows[i]);
+        if (i % 1000 == 999)
+        {
+            // Let the GrpcContext handle other RPCs in between
+            co_await agrpc::yield(grpc_context, asio::use_awaitable);
+        }
+    }
+    co_await agrpc::write_and_finish(writer, response, {}, grpc::Status::OK, asio::use_awaitable);
+    /* [yield-server-side] */
+}
+
 void server_main()
 {
     std::unique_ptr<grpc::Server> server;
@@ -110,17 +110,19 @@ void register_server_streaming_handler(agrpc::GrpcContext& grpc_context, example
 // back to the client.
 // ---------------------------------------------------
 // end-snippet
-using Channel = asio::experimental::channel<void(boost::system::error_code, example::v1::Request)>;
+using RequestPool = agrpc::MessagePool<example::v1::Request>;
+using Channel = asio::experimental::channel<void(boost::system::error_code, RequestPool::pointer)>;
 
 // This function will read one requests from the client at a time. Note that gRPC only allows calling agrpc::read after
 // a previous read has completed.
 asio::awaitable<void> reader(grpc::ServerAsyncReaderWriter<example::v1::Response, example::v1::Request>& reader_writer,
-                             Channel& channel)
+                             Channel& channel, RequestPool& request_pool)
 {
     while (true)
     {
-        example::v1::Request request;
-        if (!co_await agrpc::read(reader_writer, request))
+        // Reuse requests that the writer has finished processing to avoid re-allocating their fields.
+        auto request = request_pool.acquire();
+        if (!co_await agrpc::read(reader_writer, *request))
         {
             // Client is done writing.
             break;
@@ -152,11 +154,11 @@ asio::awaitable<bool> writer(grpc::ServerAsyncReaderWriter<example::v1::Response
 
         // Compute the response.
         example::v1::Response response;
-        response.set_integer(request.integer() * 2);
+        response.set_integer(request->integer() * 2);
 
         // reader_writer is thread-safe so we can just interact with it from the thread_pool.
         ok = co_await agrpc::write(reader_writer, response);
-        // Now we are back on the main thread.
+        // Now we are back on the main thread where the request is returned to the pool.
     }
     co_return ok;
 }
@@ -177,10 +179,13 @@ asio::awaitable<void> handle_bidirectional_streaming_request(example::v1::Exampl
     // Maximum number of requests that are buffered by the channel to enable backpressure.
     static constexpr auto MAX_BUFFER_SIZE = 2;
 
+    // Must outlive the channel which might still hold requests.
+    RequestPool request_pool{MAX_BUFFER_SIZE + 2};
     Channel channel{co_await asio::this_coro::executor, MAX_BUFFER_SIZE};
 
     using namespace asio::experimental::awaitable_operators;
-    const auto ok = co_await (reader(reader_writer, channel) && writer(reader_writer, channel, thread_pool));
+    const auto ok =
+        co_await (reader(reader_writer, channel, request_pool) && writer(reader_writer, channel, thread_pool));
 
     if (!ok)
     {
@@ -0,0 +1,456 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_AGRPC_ANY_EXECUTOR_HPP
+#define AGRPC_AGRPC_ANY_EXECUTOR_HPP
+
+#include <agrpc/detail/asio_forward.hpp>
+#include <agrpc/detail/config.hpp>
+
+#if defined(AGRPC_STANDALONE_ASIO) || defined(AGRPC_BOOST_ASIO)
+
+#include <agrpc/detail/allocate_operation.hpp>
+#include <agrpc/detail/asio_association.hpp>
+#include <agrpc/detail/grpc_context_implementation.hpp>
+#include <agrpc/detail/grpc_executor_options.hpp>
+#include <agrpc/detail/utility.hpp>
+#include <agrpc/grpc_context.hpp>
+#include <agrpc/grpc_executor.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+AGRPC_NAMESPACE_BEGIN()
+
+namespace detail
+{
+template <class T>
+inline constexpr bool IS_STD_ALLOCATOR_GRPC_EXECUTOR = false;
+
+template <std::uint32_t Options>
+inline constexpr bool IS_STD_ALLOCATOR_GRPC_EXECUTOR<agrpc::BasicGrpcExecutor<std::allocator<void>, Options>> = true;
+
+template <class Executor>
+constexpr std::uint32_t query_blocking_options(const Executor& executor) noexcept
+{
+    if constexpr (asio::can_query_v<const Executor&, asio::execution::blocking_t>)
+    {
+        return detail::set_blocking_never(
+            {}, asio::query(executor, asio::execution::blocking) == asio::execution::blocking.never);
+    }
+    else
+    {
+        return {};
+    }
+}
+}
+
+/**
+ * @brief (experimental) Type-erased executor with a fast path for the GrpcExecutor
+ *
+ * A drop-in replacement for `asio::any_io_executor` that supports the same set of properties. When constructed from a
+ * `BasicGrpcExecutor` that uses the default allocator, it stores a pointer to the GrpcContext and the executor's
+ * properties directly instead of type-erasing the executor. Calls to `execute` are then forwarded to the GrpcContext
+ * without type-erasing the function object, which avoids an allocation per call and, for executors with the
+ * blocking.possibly property, invokes the function inline when the GrpcContext is running in this thread. All other
+ * executors are stored in an `asio::any_io_executor`.
+ *
+ * Example, using AnyExecutor as the executor of `asio::awaitable`:
+ *
+ * @snippet client.cpp any-executor-awaitable
+ *
+ * @since 2.5.0
+ */
+class AnyExecutor
+{
+  public:
+    /**
+     * @brief Default construct an AnyExecutor
+     *
+     * The constructed object may not be used until it is assigned a valid executor.
+     */
+    AnyExecutor() = default;
+
+    /**
+     * @brief Construct from a GrpcExecutor, using the fast path
+     */
+    template <std::uint32_t Options>
+    AnyExecutor(const agrpc::BasicGrpcExecutor<std::allocator<void>, Options>& executor) noexcept
+        : AnyExecutor(&asio::query(executor, asio::execution::context), Options)
+    {
+    }
+
+    /**
+     * @brief Construct from any other executor, type-erasing it into an `asio::any_io_executor`
+     */
+    template <class Executor, class = std::enable_if_t<!std::is_same_v<detail::RemoveCrefT<Executor>, AnyExecutor> &&
+                                                       !detail::IS_STD_ALLOCATOR_GRPC_EXECUTOR<
+                                                           detail::RemoveCrefT<Executor>>>>
+    AnyExecutor(Executor&& executor)
+        : options_(detail::query_blocking_options(executor)), executor_(static_cast<Executor&&>(executor))
+    {
+    }
+
+    AnyExecutor(const AnyExecutor& other) noexcept
+        : grpc_context_(other.grpc_context_), options_(other.options_), executor_(other.executor_)
+    {
+        start_work();
+    }
+
+    AnyExecutor(AnyExecutor&& other) noexcept
+        : grpc_context_(std::exchange(other.grpc_context_, nullptr)),
+          options_(other.options_),
+          executor_(static_cast<asio::any_io_executor&&>(other.executor_))
+    {
+    }
+
+    ~AnyExecutor() noexcept { finish_work(); }
+
+    AnyExecutor& operator=(const AnyExecutor& other) noexcept
+    {
+        if (this != &other)
+        {
+            *this = AnyExecutor{other};
+        }
+        return *this;
+    }
+
+    AnyExecutor& operator=(AnyExecutor&& other) noexcept
+    {
+        if (this != &other)
+        {
+            finish_work();
+            grpc_context_ = std::exchange(other.grpc_context_, nullptr);
+            options_ = other.options_;
+            executor_ = static_cast<asio::any_io_executor&&>(other.executor_);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Get the GrpcContext of the fast path
+     *
+     * Returns a null pointer if this AnyExecutor was not constructed from a GrpcExecutor.
+     *
+     * Thread-safe
+     */
+    [[nodiscard]] agrpc::GrpcContext* grpc_context() const noexcept { return grpc_context_; }
+
+    /**
+     * @brief Compare two AnyExecutor for equality
+     *
+     * Thread-safe
+     */
+    [[nodiscard]] friend bool operator==(const AnyExecutor& lhs, const AnyExecutor& rhs) noexcept
+    {
+        return lhs.grpc_context_ == rhs.grpc_context_ && lhs.options_ == rhs.options_ &&
+               lhs.executor_ == rhs.executor_;
+    }
+
+    /**
+     * @brief Compare two AnyExecutor for inequality
+     *
+     * Thread-safe
+     */
+    [[nodiscard]] friend bool operator!=(const AnyExecutor& lhs, const AnyExecutor& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+
+    /**
+     * @brief Request the underlying execution context to invoke the given function object
+     *
+     * Do not call this function directly. It is intended to be used by the
+     * [asio::execution::execute](https://www.boost.org/doc/libs/1_79_0/doc/html/boost_asio/reference/execution__execute.html)
+     * customisation point.
+     *
+     * Thread-safe
+     */
+    template <class Function>
+    void execute(Function&& function) const
+    {
+        if (grpc_context_ == nullptr)
+        {
+            detail::do_execute(executor_, static_cast<Function&&>(function));
+        }
+        else if (detail::is_blocking_never(options_))
+        {
+            detail::create_and_submit_no_arg_operation<true>(*grpc_context_, static_cast<Function&&>(function));
+        }
+        else
+        {
+            detail::create_and_submit_no_arg_operation<false>(*grpc_context_, static_cast<Function&&>(function));
+        }
+    }
+
+    /**
+     * @brief Query the current value of the context property
+     *
+     * Do not call this function directly. It is intended to be used by the
+     * [asio::query](https://www.boost.org/doc/libs/1_79_0/doc/html/boost_asio/reference/query.html) customisation
+     * point.
+     *
+     * Thread-safe
+     */
+    [[nodiscard]] asio::execution_context& query(asio::execution::context_t) const noexcept
+    {
+        if (grpc_context_ == nullptr)
+        {
+            return asio::query(executor_, asio::execution::context);
+        }
+        return *grpc_context_;
+    }
+
+    /**
+     * @brief Query the current value of the blocking property
+     *
+     * Type-erased executors are assumed to have the blocking.possibly property unless they were obtained by requiring
+     * blocking.never from this AnyExecutor or were created from an executor whose blocking property can be queried.
+     *
+     * Do not call this function directly. It is intended to be used by the
+     * [asio::query](https://www.boost.org/doc/libs/1_79_0/doc/html/boost_asio/reference/query.html) customisation
+     * point.
+     *
+     * Thread-safe
+     */
+    [[nodiscard]] asio::execution::blocking_t query(asio::execution::blocking_t) const noexcept
+    {
+        if (detail::is_blocking_never(options_))
+        {
+            return asio::execution::blocking.never;
+        }
+        return asio::execution::blocking.possibly;
+    }
+
+    /**
+     * @brief Obtain an executor with the blocking.never property
+     *
+     * Do not call this function directly. It is intended to be used by the
+     * [asio::require](https://www.boost.org/doc/libs/1_79_0/doc/html/boost_asio/reference/require.html) customisation
+     * point.
+     *
+     * Thread-safe
+     */
+    [[nodiscard]] AnyExecutor require(asio::execution::blocking_t::never_t) const
+    {
+        if (grpc_context_ == nullptr)
+        {
+            return AnyExecutor{asio::require(executor_, asio::execution::blocking.never),
+                               detail::set_blocking_never(options_, true)};
+        }
+        return AnyExecutor{grpc_context_, detail::set_blocking_never(options_, true)};
+    }
+
+    /**
+     * @brief Obtain an executor with the blocking.possibly property
+     *
+     * Do not call this function directly. It is intended to be used by the
+     * [asio::prefer](https://www.boost.org/doc/libs/1_79_0/doc/html/boost_asio/reference/prefer.html) customisation
+     * point.
+     *
+     * Thread-safe
+     */
+    [[nodiscard]] AnyExecutor prefer(asio::execution::blocking_t::possibly_t) const
+    {
+        if (grpc_context_ == nullptr)
+        {
+            return AnyExecutor{asio::prefer(executor_, asio::execution::blocking.possibly),
+                               detail::set_blocking_never(options_, false)};
+        }
+        return AnyExecutor{grpc_context_, detail::set_blocking_never(options_, false)};
+    }
+
+    /**
+     * @brief Obtain an executor with the outstanding_work.tracked property
+     *
+     * Do not call this function directly. It is intended to be used by the
+     * [asio::prefer](https://www.boost.org/doc/libs/1_79_0/doc/html/boost_asio/reference/prefer.html) customisation
+     * point.
+     *
+     * Thread-safe
+     */
+    [[nodiscard]] AnyExecutor prefer(asio::execution::outstanding_work_t::tracked_t) const
+    {
+        if (grpc_context_ == nullptr)
+        {
+            return AnyExecutor{asio::prefer(executor_, asio::execution::outstanding_work.tracked), options_};
+        }
+        return AnyExecutor{grpc_context_, detail::set_outstanding_work_tracked(options_, true)};
+    }
+
+    /**
+     * @brief Obtain an executor with the outstanding_work.untracked property
+     *
+     * Do not call this function directly. It is intended to be used by the
+     * [asio::prefer](https://www.boost.org/doc/libs/1_79_0/doc/html/boost_asio/reference/prefer.html) customisation
+     * point.
+     *
+     * Thread-safe
+     */
+    [[nodiscard]] AnyExecutor prefer(asio::execution::outstanding_work_t::untracked_t) const
+    {
+        if (grpc_context_ == nullptr)
+        {
+            return AnyExecutor{asio::prefer(executor_, asio::execution::outstanding_work.untracked), options_};
+        }
+        return AnyExecutor{grpc_context_, detail::set_outstanding_work_tracked(options_, false)};
+    }
+
+    /**
+     * @brief Obtain an executor with the relationship.fork property
+     *
+     * Do not call this function directly. It is intended to be used by the
+     * [asio::prefer](https://www.boost.org/doc/libs/1_79_0/doc/html/boost_asio/reference/prefer.html) customisation
+     * point.
+     *
+     * Thread-safe
+     */
+    [[nodiscard]] AnyExecutor prefer(asio::execution::relationship_t::fork_t) const
+    {
+        if (grpc_context_ == nullptr)
+        {
+            return AnyExecutor{asio::prefer(executor_, asio::execution::relationship.fork), options_};
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Obtain an executor with the relationship.continuation property
+     *
+     * The fast path does not support continuation.
+     *
+     * Do not call this function directly. It is intended to be used by the
+     * [asio::prefer](https://www.boost.org/doc/libs/1_79_0/doc/html/boost_asio/reference/prefer.html) customisation
+     * point.
+     *
+     * Thread-safe
+     */
+    [[nodiscard]] AnyExecutor prefer(asio::execution::relationship_t::continuation_t) const
+    {
+        if (grpc_context_ == nullptr)
+        {
+            return AnyExecutor{asio::prefer(executor_, asio::execution::relationship.continuation), options_};
+        }
+        return *this;
+    }
+
+  private:
+    AnyExecutor(asio::any_io_executor&& executor, std::uint32_t options) noexcept
+        : options_(options), executor_(static_cast<asio::any_io_executor&&>(executor))
+    {
+    }
+
+    AnyExecutor(agrpc::GrpcContext* grpc_context, std::uint32_t options) noexcept
+        : grpc_context_(grpc_context), options_(options)
+    {
+        start_work();
+    }
+
+    void start_work() const noexcept
+    {
+        if (grpc_context_ != nullptr && detail::is_outstanding_work_tracked(options_))
+        {
+            grpc_context_->work_started();
+        }
+    }
+
+    void finish_work() const noexcept
+    {
+        if (grpc_context_ != nullptr && detail::is_outstanding_work_tracked(options_))
+        {
+            grpc_context_->work_finished();
+        }
+    }
+
+    agrpc::GrpcContext* grpc_context_{};
+    std::uint32_t options_{};
+    asio::any_io_executor executor_;
+};
+
+AGRPC_NAMESPACE_END
+
+#if !defined(BOOST_ASIO_HAS_DEDUCED_EQUALITY_COMPARABLE_TRAIT) && \
+    !defined(ASIO_HAS_DEDUCED_EQUALITY_COMPARABLE_TRAIT)
+template <>
+struct agrpc::asio::traits::equality_comparable<agrpc::AnyExecutor>
+{
+    static constexpr bool is_valid = true;
+    static constexpr bool is_noexcept = true;
+};
+#endif
+
+#if !defined(BOOST_ASIO_HAS_DEDUCED_EXECUTE_MEMBER_TRAIT) && !defined(ASIO_HAS_DEDUCED_EXECUTE_MEMBER_TRAIT)
+template <class F>
+struct agrpc::asio::traits::execute_member<agrpc::AnyExecutor, F>
+{
+    static constexpr bool is_valid = true;
+    static constexpr bool is_noexcept = false;
+
+    using result_type = void;
+};
+#endif
+
+#if !defined(BOOST_ASIO_HAS_DEDUCED_QUERY_MEMBER_TRAIT) && !defined(ASIO_HAS_DEDUCED_QUERY_MEMBER_TRAIT)
+template <>
+struct agrpc::asio::traits::query_member<agrpc::AnyExecutor, agrpc::asio::execution::context_t>
+{
+    static constexpr bool is_valid = true;
+    static constexpr bool is_noexcept = true;
+
+    using result_type = agrpc::asio::execution_context&;
+};
+
+template <>
+struct agrpc::asio::traits::query_member<agrpc::AnyExecutor, agrpc::asio::execution::blocking_t>
+{
+    static constexpr bool is_valid = true;
+    static constexpr bool is_noexcept = true;
+
+    using result_type = agrpc::asio::execution::blocking_t;
+};
+#endif
+
+#if !defined(BOOST_ASIO_HAS_DEDUCED_REQUIRE_MEMBER_TRAIT) && !defined(ASIO_HAS_DEDUCED_REQUIRE_MEMBER_TRAIT)
+template <>
+struct agrpc::asio::traits::require_member<agrpc::AnyExecutor, agrpc::asio::execution::blocking_t::never_t>
+{
+    static constexpr bool is_valid = true;
+    static constexpr bool is_noexcept = false;
+
+    using result_type = agrpc::AnyExecutor;
+};
+#endif
+
+#if !defined(BOOST_ASIO_HAS_DEDUCED_PREFER_MEMBER_TRAIT) && !defined(ASIO_HAS_DEDUCED_PREFER_MEMBER_TRAIT)
+template <class Property>
+struct agrpc::asio::traits::prefer_member<
+    agrpc::AnyExecutor, Property,
+    std::enable_if_t<std::is_same_v<Property, agrpc::asio::execution::blocking_t::possibly_t> ||
+                     std::is_same_v<Property, agrpc::asio::execution::outstanding_work_t::tracked_t> ||
+                     std::is_same_v<Property, agrpc::asio::execution::outstanding_work_t::untracked_t> ||
+                     std::is_same_v<Property, agrpc::asio::execution::relationship_t::fork_t> ||
+                     std::is_same_v<Property, agrpc::asio::execution::relationship_t::continuation_t>>>
+{
+    static constexpr bool is_valid = true;
+    static constexpr bool is_noexcept = false;
+
+    using result_type = agrpc::AnyExecutor;
+};
+#endif
+
+#endif
+
+#endif  // AGRPC_AGRPC_ANY_EXECUTOR_HPP
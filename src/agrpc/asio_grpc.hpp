@@ -31,25 +31,46 @@
 #define AGRPC_AGRPC_ASIO_GRPC_HPP
 
 #include <agrpc/alarm.hpp>
+#include <agrpc/any_executor.hpp>
 #include <agrpc/bind_allocator.hpp>
 #include <agrpc/cancel_safe.hpp>
+#include <agrpc/channel.hpp>
+#include <agrpc/client_middleware.hpp>
+#include <agrpc/deadline_scheduler.hpp>
 #include <agrpc/default_completion_token.hpp>
+#include <agrpc/fair_scheduler.hpp>
+#include <agrpc/generic_router.hpp>
 #include <agrpc/get_completion_queue.hpp>
 #include <agrpc/grpc_context.hpp>
 #include <agrpc/grpc_executor.hpp>
 #include <agrpc/grpc_initiate.hpp>
 #include <agrpc/grpc_stream.hpp>
 #include <agrpc/high_level_client.hpp>
+#include <agrpc/message_pool.hpp>
+#include <agrpc/multiplexer.hpp>
 #include <agrpc/notify_on_state_change.hpp>
 #include <agrpc/notify_when_done.hpp>
+#include <agrpc/offload.hpp>
+#include <agrpc/ordered_stage.hpp>
+#include <agrpc/parse_pipeline.hpp>
+#include <agrpc/propagation_context.hpp>
 #include <agrpc/repeatedly_request.hpp>
 #include <agrpc/repeatedly_request_context.hpp>
+#include <agrpc/request_all.hpp>
 #include <agrpc/rpc.hpp>
+#include <agrpc/rpc_arena.hpp>
+#include <agrpc/rpc_registry.hpp>
 #include <agrpc/rpc_type.hpp>
 #include <agrpc/run.hpp>
+#include <agrpc/selector.hpp>
+#include <agrpc/server_drainer.hpp>
+#include <agrpc/server_middleware.hpp>
+#include <agrpc/task.hpp>
 #include <agrpc/test.hpp>
 #include <agrpc/use_awaitable.hpp>
 #include <agrpc/use_sender.hpp>
 #include <agrpc/wait.hpp>
+#include <agrpc/yield.hpp>
+#include <agrpc/with_timeout.hpp>
 
 #endif  // AGRPC_AGRPC_ASIO_GRPC_HPP
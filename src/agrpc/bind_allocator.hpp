@@ -24,6 +24,27 @@
 
 AGRPC_NAMESPACE_BEGIN()
 
+#ifdef AGRPC_STDEXEC
+namespace detail
+{
+template <class Target, class Allocator>
+struct AllocatorBinderEnv
+{
+    [[nodiscard]] Allocator query(::stdexec::get_allocator_t) const noexcept { return allocator_; }
+
+    template <class Tag>
+    [[nodiscard]] auto query(Tag tag) const noexcept(noexcept(tag(::stdexec::get_env(std::declval<const Target&>()))))
+        -> decltype(tag(::stdexec::get_env(std::declval<const Target&>())))
+    {
+        return tag(::stdexec::get_env(target_));
+    }
+
+    const Target& target_;
+    Allocator allocator_;
+};
+}
+#endif
+
 /**
  * @brief Helper class that associates an allocator to an object
  *
@@ -169,6 +190,18 @@ class AllocatorBinder
     }
 #endif
 
+#ifdef AGRPC_STDEXEC
+    /**
+     * @brief Get the target's environment extended by the bound allocator
+     *
+     * @since 2.5.0
+     */
+    [[nodiscard]] detail::AllocatorBinderEnv<Target, Allocator> get_env() const noexcept
+    {
+        return {get(), get_allocator()};
+    }
+#endif
+
     /**
      * @brief Invoke target with arguments (rvalue overload)
      */
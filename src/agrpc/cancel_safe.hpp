@@ -22,17 +22,19 @@
 
 #include <agrpc/default_completion_token.hpp>
 #include <agrpc/detail/cancel_safe.hpp>
+#include <agrpc/detail/ring_buffer.hpp>
 #include <agrpc/detail/tuple.hpp>
 #include <agrpc/detail/type_erased_completion_handler.hpp>
 #include <agrpc/detail/utility.hpp>
 #include <agrpc/detail/work_tracking_completion_handler.hpp>
 
 #include <cassert>
-#include <optional>
+#include <cstddef>
 
 AGRPC_NAMESPACE_BEGIN()
 
-template <class CompletionSignature>
+template <class CompletionSignature, std::size_t Capacity = 1,
+          std::size_t HandlerBufferSize = detail::CANCEL_SAFE_DEFAULT_HANDLER_BUFFER_SIZE>
 class CancelSafe;
 
 /**
@@ -46,13 +48,23 @@ class CancelSafe;
  *
  * @snippet client.cpp cancel-safe-server-streaming
  *
+ * Up to `Capacity` asynchronous operations may be initiated with the completion token at the same time. Results of
+ * operations that complete while no wait is pending are stored in a fixed-size ring buffer inside this object, without
+ * allocating memory, and are handed out by subsequent waits in the order in which the operations completed.
+ *
+ * The completion handler of a wait is stored in a buffer of `HandlerBufferSize` bytes inside this object if it fits
+ * and is nothrow move constructible. Otherwise it is allocated using its associated allocator. The default size fits
+ * the completion handler of `asio::use_awaitable`, so that waiting for a result does not allocate memory.
+ *
  * @tparam CompletionArgs The arguments of the completion signature. E.g. for `asio::steady_timer::async_wait` the
  * completion arguments would be `boost::system::error_code`.
+ * @tparam Capacity The maximum number of completed but not yet awaited results (since 2.5.0).
+ * @tparam HandlerBufferSize The size of the inline storage for the completion handler of a wait (since 2.5.0).
  *
  * @since 1.6.0 (and Boost.Asio 1.77.0)
  */
-template <class... CompletionArgs>
-class CancelSafe<void(CompletionArgs...)>
+template <class... CompletionArgs, std::size_t Capacity, std::size_t HandlerBufferSize>
+class CancelSafe<void(CompletionArgs...), Capacity, HandlerBufferSize>
 {
   private:
     using CompletionSignature = detail::PrependErrorCodeToSignatureT<void(CompletionArgs...)>;
@@ -75,12 +87,13 @@ class CancelSafe<void(CompletionArgs...)>
             }
             else
             {
-                self_.result_.emplace(Result{static_cast<CompletionArgs&&>(completion_args)...});
+                assert(!self_.results_.full() && "More than `Capacity` operations have completed without being waited");
+                self_.results_.emplace_back(static_cast<CompletionArgs&&>(completion_args)...);
             }
         }
 
       private:
-        friend agrpc::CancelSafe<void(CompletionArgs...)>;
+        friend agrpc::CancelSafe<void(CompletionArgs...), Capacity, HandlerBufferSize>;
 
         explicit CompletionToken(CancelSafe& self) noexcept : self_(self) {}
 
@@ -110,11 +123,28 @@ class CancelSafe<void(CompletionArgs...)>
      */
     [[nodiscard]] bool is_wait_pending() const noexcept { return bool{completion_handler_}; }
 
+    /**
+     * @brief Number of completed results that have not been waited for yet
+     *
+     * Thread-unsafe with regards to successful completion of the asynchronous operation.
+     *
+     * @since 2.5.0
+     */
+    [[nodiscard]] std::size_t completed_count() const noexcept { return results_.size(); }
+
+    /**
+     * @brief The maximum number of completed results that can be stored
+     *
+     * @since 2.5.0
+     */
+    [[nodiscard]] static constexpr std::size_t capacity() noexcept { return Capacity; }
+
     /**
      * @brief Wait for the asynchronous operation to complete
      *
-     * Only one call to `wait()` may be outstanding at a time. Waiting for an already completed operation will
-     * immediately invoke the completion handler in a manner equivalent to using `asio::post`.
+     * Only one call to `wait()` may be outstanding at a time. If one or more operations have already completed then
+     * the completion handler is immediately invoked with the oldest result in a manner equivalent to using
+     * `asio::post`.
      *
      * Thread-unsafe with regards to successful completion of the asynchronous operation.
      *
@@ -138,12 +168,11 @@ class CancelSafe<void(CompletionArgs...)>
         template <class CompletionHandler>
         void operator()(CompletionHandler&& ch)
         {
-            if (self_.result_)
+            if (!self_.results_.empty())
             {
                 auto executor = asio::get_associated_executor(ch);
                 const auto allocator = asio::get_associated_allocator(ch);
-                auto local_result{static_cast<Result&&>(*self_.result_)};
-                self_.result_.reset();
+                auto local_result{self_.results_.pop_front()};
                 detail::post_with_allocator(
                     std::move(executor),
                     [ch = static_cast<CompletionHandler&&>(ch),
@@ -183,7 +212,7 @@ class CancelSafe<void(CompletionArgs...)>
     {
         completion_handler_
             .template emplace<detail::WorkTrackingCompletionHandler<detail::RemoveCrefT<CompletionHandler>>>(
-                static_cast<CompletionHandler&&>(ch));
+                static_cast<CompletionHandler&&>(ch), handler_buffer_);
     }
 
     template <class CancellationSlot>
@@ -196,7 +225,8 @@ class CancelSafe<void(CompletionArgs...)>
     }
 
     detail::AtomicTypeErasedCompletionHandler<CompletionSignature> completion_handler_{};
-    std::optional<Result> result_;
+    detail::RingBuffer<Result, Capacity> results_;
+    detail::CompletionHandlerBuffer<HandlerBufferSize> handler_buffer_;
 };
 
 /**
@@ -0,0 +1,182 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_AGRPC_CHANNEL_HPP
+#define AGRPC_AGRPC_CHANNEL_HPP
+
+#include <agrpc/default_completion_token.hpp>
+#include <agrpc/detail/asio_forward.hpp>
+#include <agrpc/detail/channel.hpp>
+#include <agrpc/detail/config.hpp>
+#include <agrpc/detail/initiate_sender_implementation.hpp>
+#include <agrpc/detail/query_grpc_context.hpp>
+#include <agrpc/grpc_executor.hpp>
+
+#include <cstddef>
+#include <type_traits>
+
+AGRPC_NAMESPACE_BEGIN()
+
+/**
+ * @brief (experimental) Message channel for a GrpcContext
+ *
+ * Bounded channel whose receiving side runs on a `agrpc::GrpcContext`. Values are stored in a lock-free ring buffer
+ * of `max_buffer_size` elements that is allocated once upon construction. `try_send()` may be called concurrently
+ * from any thread, e.g. from an `asio::thread_pool`, and wakes up a waiting receiver through the GrpcContext's remote
+ * work queue. `send()` additionally waits for space to become available, providing backpressure.
+ *
+ * In contrast to `asio::experimental::channel` this class does not use a mutex. At most one `receive()` may be
+ * outstanding at a time.
+ *
+ * Example:
+ *
+ * @snippet server.cpp channel-server-side
+ *
+ * @tparam T The value type, must be default constructible and move constructible.
+ * @tparam Executor The executor type, must be capable of referring to a `agrpc::GrpcContext`.
+ *
+ * **Per-Operation Cancellation**
+ *
+ * None.
+ *
+ * @since 2.5.0
+ */
+template <class T, class Executor>
+class BasicChannel
+{
+  public:
+    /**
+     * @brief The value type
+     */
+    using value_type = T;
+
+    /**
+     * @brief The executor type
+     */
+    using executor_type = Executor;
+
+    /**
+     * @brief Construct a BasicChannel from an executor
+     */
+    BasicChannel(const Executor& executor, std::size_t max_buffer_size)
+        : executor_(executor), state_(detail::query_grpc_context(executor_), max_buffer_size)
+    {
+    }
+
+    /**
+     * @brief Construct a BasicChannel from a GrpcContext
+     */
+    BasicChannel(agrpc::GrpcContext& grpc_context, std::size_t max_buffer_size)
+        : executor_(grpc_context.get_executor()), state_(grpc_context, max_buffer_size)
+    {
+    }
+
+    /**
+     * @brief Try to send a value without waiting
+     *
+     * Thread-safe and lock-free
+     *
+     * @return False if the buffer is full or the channel has been closed, in which case `value` has not been moved
+     * from.
+     */
+    template <class U>
+    [[nodiscard]] bool try_send(U&& value)
+    {
+        return state_.try_send(static_cast<U&&>(value));
+    }
+
+    /**
+     * @brief Send a value, waiting for buffer space if necessary
+     *
+     * Completes on the GrpcContext once the value has been placed into the buffer. Waiting senders are served in the
+     * order in which they started waiting.
+     *
+     * @param token A completion token like `asio::yield_context` or the one created by `agrpc::use_sender`. The
+     * completion signature is `void(bool)`. `true` if the value has been sent, `false` if the channel was closed.
+     */
+    template <class U, class CompletionToken = detail::DefaultCompletionTokenT<Executor>>
+    auto send(U&& value, CompletionToken token = detail::DefaultCompletionTokenT<Executor>{})
+    {
+        return detail::async_initiate_sender_implementation<detail::ChannelSendSenderImplementation<T>>(
+            grpc_context(), {}, {state_, static_cast<U&&>(value)}, token);
+    }
+
+    /**
+     * @brief Receive a value
+     *
+     * Only one receive may be outstanding at a time. Values that have been sent before the channel was closed are
+     * still received.
+     *
+     * @param token A completion token like `asio::yield_context` or the one created by `agrpc::use_sender`. The
+     * completion signature is `void(bool, T)`. `true` if a value has been received, `false` if the channel has been
+     * closed and no more values are buffered, in which case the value is default constructed.
+     */
+    template <class CompletionToken = detail::DefaultCompletionTokenT<Executor>>
+    auto receive(CompletionToken token = detail::DefaultCompletionTokenT<Executor>{})
+    {
+        return detail::async_initiate_sender_implementation<detail::ChannelReceiveSenderImplementation<T>>(
+            grpc_context(), {}, detail::ChannelReceiveSenderImplementation<T>{state_}, token);
+    }
+
+    /**
+     * @brief Close the channel
+     *
+     * Waiting senders complete with `false` and a waiting receiver completes with `false` once all buffered values
+     * have been received. Must be called from the thread that runs the GrpcContext. All operations must have completed
+     * before the channel is destroyed.
+     */
+    void close() noexcept { state_.close(); }
+
+    /**
+     * @brief Has the channel been closed?
+     *
+     * Thread-safe
+     */
+    [[nodiscard]] bool is_closed() const noexcept { return state_.is_closed(); }
+
+    /**
+     * @brief The maximum number of buffered values
+     *
+     * Thread-safe
+     */
+    [[nodiscard]] std::size_t max_buffer_size() const noexcept { return state_.max_buffer_size(); }
+
+    /**
+     * @brief Get the executor
+     *
+     * Thread-safe
+     */
+    [[nodiscard]] const executor_type& get_executor() const noexcept { return executor_; }
+
+  private:
+    static_assert(std::is_default_constructible_v<T> && std::is_move_constructible_v<T>,
+                  "The value type of a channel must be default constructible and move constructible");
+
+    agrpc::GrpcContext& grpc_context() noexcept { return state_.grpc_context(); }
+
+    Executor executor_;
+    detail::ChannelState<T> state_;
+};
+
+/**
+ * @brief (experimental) A BasicChannel that uses `agrpc::GrpcExecutor`
+ *
+ * @since 2.5.0
+ */
+template <class T>
+using Channel = agrpc::BasicChannel<T, agrpc::GrpcExecutor>;
+
+AGRPC_NAMESPACE_END
+
+#endif  // AGRPC_AGRPC_CHANNEL_HPP
@@ -0,0 +1,141 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_AGRPC_CLIENT_MIDDLEWARE_HPP
+#define AGRPC_AGRPC_CLIENT_MIDDLEWARE_HPP
+
+#include <agrpc/default_completion_token.hpp>
+#include <agrpc/detail/client_middleware.hpp>
+#include <agrpc/detail/config.hpp>
+#include <agrpc/detail/initiate_sender_implementation.hpp>
+#include <agrpc/detail/query_grpc_context.hpp>
+#include <agrpc/detail/rpc_type.hpp>
+#include <agrpc/grpc_executor.hpp>
+#include <agrpc/high_level_client.hpp>
+
+#include <type_traits>
+
+AGRPC_NAMESPACE_BEGIN()
+
+/**
+ * @brief (experimental) Typed stub with a statically composed chain of client interceptors
+ *
+ * Performs unary requests like `agrpc::RPC::request` while invoking the interceptors' hooks from within the same
+ * operation. Interceptors are stored by value and their hooks are resolved at compile time. Unlike
+ * `grpc::experimental::ClientInterceptorFactoryInterface`, this involves neither virtual function calls nor additional
+ * memory allocations, so that metadata injection, metrics and tracing only cost their own logic.
+ *
+ * An interceptor may provide any of the following member functions:
+ *
+ * - `void before(grpc::ClientContext&)`: Invoked in order before the call is created. This is the last opportunity to
+ * add metadata or to set the deadline.
+ * - `void after(grpc::ClientContext&, const grpc::Status&) noexcept`: Invoked in reverse order once the RPC has
+ * finished, before the completion handler. Also invoked, with `grpc::StatusCode::CANCELLED`, when the operation is
+ * destroyed without the RPC having finished, e.g. because the GrpcContext shuts down or a sender is destroyed without
+ * being started.
+ *
+ * The interceptors are copied for each request. They can therefore keep per-request state, like the start time,
+ * between `before` and `after`.
+ *
+ * Example:
+ *
+ * @snippet client.cpp client-middleware-interceptors
+ * @snippet client.cpp client-middleware
+ *
+ * @tparam Stub The stub type, e.g. `example::v1::Example::Stub`.
+ * @tparam Interceptors Copy constructible interceptor types.
+ *
+ * @since 2.5.0
+ */
+template <class Stub, class... Interceptors>
+class ClientMiddleware
+{
+  public:
+    /**
+     * @brief The stub type
+     */
+    using stub_type = Stub;
+
+    /**
+     * @brief Construct from a stub and default constructed interceptors
+     *
+     * @param stub Must remain alive for the lifetime of this object.
+     */
+    explicit ClientMiddleware(Stub& stub) : stub_(&stub) {}
+
+    /**
+     * @brief Construct from a stub and interceptors
+     *
+     * @param stub Must remain alive for the lifetime of this object.
+     */
+    template <class... Args, class = std::enable_if_t<(sizeof...(Args) > 0)>>
+    ClientMiddleware(Stub& stub, Args&&... interceptors)
+        : stub_(&stub), chain_(static_cast<Args&&>(interceptors)...)
+    {
+    }
+
+    /**
+     * @brief Start a unary request through the interceptors
+     *
+     * Equivalent to `agrpc::RPC<PrepareAsync>::request(grpc_context, stub(), context, request, response, token)` with
+     * the interceptors' hooks invoked around it.
+     *
+     * @tparam PrepareAsync A pointer to the async version of a unary RPC method of the stub, e.g.
+     * `&example::v1::Example::Stub::PrepareAsyncUnary`.
+     *
+     * @param token A completion token like `asio::yield_context` or `agrpc::use_sender`. The completion signature is
+     * `void(grpc::Status)`.
+     */
+    template <auto PrepareAsync, class CompletionToken = agrpc::DefaultCompletionToken>
+    auto request(agrpc::GrpcContext& grpc_context, grpc::ClientContext& context,
+                 const typename agrpc::RPC<PrepareAsync>::Request& request,
+                 typename agrpc::RPC<PrepareAsync>::Response& response, CompletionToken token = {}) const
+    {
+        static_assert(detail::RPC_TYPE<PrepareAsync> == agrpc::RPCType::CLIENT_UNARY,
+                      "ClientMiddleware only supports unary RPCs");
+        static_assert(std::is_same_v<Stub, typename agrpc::RPC<PrepareAsync>::Stub>,
+                      "PrepareAsync must be a member function of the stub");
+        return detail::async_initiate_sender_implementation<
+            detail::ClientMiddlewareUnaryRequestSenderImplementation<PrepareAsync, Interceptors...>>(
+            grpc_context, {context, response}, {chain_, grpc_context, *stub_, context, request}, token);
+    }
+
+    /**
+     * @brief Start a unary request through the interceptors (executor overload)
+     */
+    template <auto PrepareAsync, class CompletionToken = agrpc::DefaultCompletionToken>
+    auto request(const agrpc::GrpcExecutor& executor, grpc::ClientContext& context,
+                 const typename agrpc::RPC<PrepareAsync>::Request& request,
+                 typename agrpc::RPC<PrepareAsync>::Response& response, CompletionToken&& token = {}) const
+    {
+        return this->template request<PrepareAsync>(detail::query_grpc_context(executor), context, request, response,
+                                                    static_cast<CompletionToken&&>(token));
+    }
+
+    /**
+     * @brief Get the stub
+     */
+    [[nodiscard]] Stub& stub() const noexcept { return *stub_; }
+
+  private:
+    Stub* stub_;
+    detail::ClientInterceptorChain<Interceptors...> chain_;
+};
+
+template <class Stub, class... Interceptors>
+ClientMiddleware(Stub&, Interceptors...) -> ClientMiddleware<Stub, Interceptors...>;
+
+AGRPC_NAMESPACE_END
+
+#endif  // AGRPC_AGRPC_CLIENT_MIDDLEWARE_HPP
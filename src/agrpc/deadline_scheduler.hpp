@@ -0,0 +1,195 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_AGRPC_DEADLINE_SCHEDULER_HPP
+#define AGRPC_AGRPC_DEADLINE_SCHEDULER_HPP
+
+#include <agrpc/detail/asio_forward.hpp>
+#include <agrpc/detail/config.hpp>
+
+#if defined(AGRPC_STANDALONE_ASIO) || defined(AGRPC_BOOST_ASIO)
+
+#include <agrpc/detail/operation_base.hpp>
+#include <agrpc/detail/scheduler.hpp>
+#include <agrpc/detail/utility.hpp>
+#include <agrpc/grpc_context.hpp>
+#include <grpcpp/server_context.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+AGRPC_NAMESPACE_BEGIN()
+
+/**
+ * @brief (experimental) Earliest-deadline-first scheduling of completion handlers
+ *
+ * A GrpcContext runs ready completion handlers in the order in which they became ready. When it is overloaded, work
+ * that belongs to an RPC whose deadline is about to expire therefore waits behind work for RPCs that still have
+ * seconds left. Completion handlers that are associated with an executor of this scheduler are instead ordered by the
+ * deadline that has been passed to `get_executor()`, earliest first. Handlers with equal deadlines run in submission
+ * order. Work that is not submitted through this scheduler is unaffected.
+ *
+ * Optionally, handlers whose deadline has already passed when they are about to run are skipped: they are destroyed
+ * without being invoked, just like the handlers that are pending when the GrpcContext is destroyed. Only enable this
+ * if all affected handlers tolerate it.
+ *
+ * The scheduler must outlive all work that has been submitted through its executors, e.g. by destroying it after the
+ * GrpcContext has run out of work.
+ *
+ * Example:
+ *
+ * @snippet server.cpp deadline-scheduler
+ *
+ * @since 2.5.0
+ */
+class DeadlineScheduler : private detail::SchedulerBase<std::chrono::system_clock::time_point>
+{
+  private:
+    using Base = detail::SchedulerBase<std::chrono::system_clock::time_point>;
+
+  public:
+    /**
+     * @brief The type of the deadline
+     */
+    using Key = std::chrono::system_clock::time_point;
+
+    /**
+     * @brief The executor type
+     *
+     * Refers to the GrpcContext, never blocks and supports the outstanding_work property.
+     */
+    using executor_type = detail::BasicSchedulerExecutor<DeadlineScheduler>;
+
+    /**
+     * @brief Construct from a GrpcContext
+     *
+     * @param skip_expired Destroy handlers whose deadline has passed instead of invoking them.
+     */
+    explicit DeadlineScheduler(agrpc::GrpcContext& grpc_context, bool skip_expired = false)
+        : Base(grpc_context, &do_push, &do_drain), skip_expired_(skip_expired)
+    {
+    }
+
+    /**
+     * @brief Get an executor whose handlers are ordered by the given deadline
+     *
+     * Thread-safe
+     */
+    [[nodiscard]] executor_type get_executor(Key deadline) noexcept { return executor_type{*this, deadline}; }
+
+    /**
+     * @brief Get an executor whose handlers are ordered by the deadline of an RPC
+     *
+     * Thread-safe
+     */
+    [[nodiscard]] executor_type get_executor(const grpc::ServerContext& server_context) noexcept
+    {
+        return executor_type{*this, server_context.deadline()};
+    }
+
+    /**
+     * @brief Get the GrpcContext
+     *
+     * Thread-safe
+     */
+    using Base::grpc_context;
+
+    /**
+     * @brief Number of handlers that are ready to run
+     *
+     * Must be called from the thread that runs the GrpcContext.
+     */
+    [[nodiscard]] std::size_t size() const noexcept { return heap_.size(); }
+
+    /**
+     * @brief Number of handlers that have been skipped because their deadline had passed
+     *
+     * Must be called from the thread that runs the GrpcContext.
+     */
+    [[nodiscard]] std::size_t skipped_count() const noexcept { return skipped_count_; }
+
+  private:
+    friend executor_type;
+
+    // Min-heap on (deadline, sequence)
+    struct Later
+    {
+        bool operator()(const Operation* lhs, const Operation* rhs) const noexcept
+        {
+            return lhs->key_ != rhs->key_ ? rhs->key_ < lhs->key_ : rhs->sequence_ < lhs->sequence_;
+        }
+    };
+
+    Operation* pop() noexcept
+    {
+        std::pop_heap(heap_.begin(), heap_.end(), Later{});
+        auto* const operation = heap_.back();
+        heap_.pop_back();
+        return operation;
+    }
+
+    static void do_push(Base* base, Operation* operation)
+    {
+        auto& self = static_cast<DeadlineScheduler&>(*base);
+        self.heap_.push_back(operation);
+        std::push_heap(self.heap_.begin(), self.heap_.end(), Later{});
+    }
+
+    static void do_drain(Base* base, detail::OperationResult result)
+    {
+        auto& self = static_cast<DeadlineScheduler&>(*base);
+        auto& grpc_context = self.grpc_context();
+        detail::ScopeGuard guard{[&]
+                                 {
+                                     self.on_drained(!self.heap_.empty());
+                                 }};
+        if AGRPC_UNLIKELY (detail::is_shutdown(result))
+        {
+            while (!self.heap_.empty())
+            {
+                self.pop()->complete(detail::OperationResult::SHUTDOWN_NOT_OK, grpc_context);
+            }
+            return;
+        }
+        // Run at most as many handlers as were queued when this round began so that completion queue events are not
+        // starved. Work queued during the round competes by deadline: if it is more urgent it runs in this round and
+        // displaces a handler that was already queued into the next one.
+        const auto now = self.skip_expired_ ? std::chrono::system_clock::now() : Key{};
+        for (auto count = self.heap_.size(); count > 0 && !self.heap_.empty(); --count)
+        {
+            auto* const operation = self.pop();
+            if (self.skip_expired_ && operation->key_ < now)
+            {
+                ++self.skipped_count_;
+                operation->complete(detail::OperationResult::SHUTDOWN_NOT_OK, grpc_context);
+            }
+            else
+            {
+                operation->complete(detail::OperationResult::OK, grpc_context);
+            }
+        }
+    }
+
+    std::vector<Operation*> heap_;
+    std::size_t skipped_count_{};
+    bool skip_expired_;
+};
+
+AGRPC_NAMESPACE_END
+
+#endif
+
+#endif  // AGRPC_AGRPC_DEADLINE_SCHEDULER_HPP
@@ -0,0 +1,84 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_DETAIL_ALARM_POOL_HPP
+#define AGRPC_DETAIL_ALARM_POOL_HPP
+
+#include <agrpc/detail/config.hpp>
+#include <agrpc/detail/intrusive_slist.hpp>
+#include <grpcpp/alarm.h>
+
+#include <cstddef>
+
+AGRPC_NAMESPACE_BEGIN()
+
+namespace detail
+{
+struct PooledAlarm
+{
+    grpc::Alarm alarm_;
+    PooledAlarm* next_;
+};
+
+// Constructing a grpc::Alarm allocates its implementation. The pool keeps alarms that are no longer in use so that
+// later operations can set them again. Not thread-safe, it is owned by the GrpcContext and may only be used from the
+// thread that runs it.
+class AlarmPool
+{
+  public:
+    AlarmPool() = default;
+
+    AlarmPool(const AlarmPool&) = delete;
+    AlarmPool(AlarmPool&&) = delete;
+    AlarmPool& operator=(const AlarmPool&) = delete;
+    AlarmPool& operator=(AlarmPool&&) = delete;
+
+    ~AlarmPool() noexcept
+    {
+        while (!free_list_.empty())
+        {
+            delete free_list_.pop_front();
+        }
+    }
+
+    [[nodiscard]] static PooledAlarm* create() { return new PooledAlarm{}; }
+
+    [[nodiscard]] PooledAlarm* acquire()
+    {
+        if (free_list_.empty())
+        {
+            return create();
+        }
+        --size_;
+        return free_list_.pop_front();
+    }
+
+    // The alarm must have been delivered by the completion queue
+    void release(PooledAlarm* alarm) noexcept
+    {
+        ++size_;
+        free_list_.push_front(alarm);
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+
+  private:
+    detail::IntrusiveSlist<PooledAlarm> free_list_;
+    std::size_t size_{};
+};
+}
+
+AGRPC_NAMESPACE_END
+
+#endif  // AGRPC_DETAIL_ALARM_POOL_HPP
@@ -18,6 +18,8 @@
 #include <agrpc/detail/config.hpp>
 #include <agrpc/detail/execution.hpp>
 
+#include <memory>
+
 AGRPC_NAMESPACE_BEGIN()
 
 namespace detail
@@ -75,6 +77,15 @@ void post_with_allocator(Executor&& executor, Function&& function, const Allocat
                      asio::execution::relationship_t::fork, asio::execution::allocator(allocator)),
         static_cast<Function&&>(function));
 }
+
+// Posts a function that runs outside of the GrpcContext, e.g. on a thread pool. The GrpcContext's allocator is not used
+// because it may only be accessed from the GrpcContext's thread.
+template <class Executor, class Function>
+void post_to_foreign_executor(Executor&& executor, Function&& function)
+{
+    detail::post_with_allocator(static_cast<Executor&&>(executor), static_cast<Function&&>(function),
+                                std::allocator<void>{});
+}
 #endif
 
 template <class T>
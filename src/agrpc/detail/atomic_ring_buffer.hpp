@@ -0,0 +1,128 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_DETAIL_ATOMIC_RING_BUFFER_HPP
+#define AGRPC_DETAIL_ATOMIC_RING_BUFFER_HPP
+
+#include <agrpc/detail/config.hpp>
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
+
+AGRPC_NAMESPACE_BEGIN()
+
+namespace detail
+{
+// Bounded multi-producer single-consumer queue. Each slot carries a turn counter that is even while the slot is
+// writable and odd while it holds a value, which also works for a capacity of one.
+// Adapted from https://github.com/rigtorp/MPMCQueue
+template <class T>
+class AtomicRingBuffer
+{
+  public:
+    explicit AtomicRingBuffer(std::size_t capacity) : capacity_(capacity), slots_(new Slot[capacity])
+    {
+        assert(capacity > 0 && "AtomicRingBuffer must have a capacity of at least one");
+    }
+
+    AtomicRingBuffer(const AtomicRingBuffer&) = delete;
+    AtomicRingBuffer(AtomicRingBuffer&&) = delete;
+    AtomicRingBuffer& operator=(const AtomicRingBuffer&) = delete;
+    AtomicRingBuffer& operator=(AtomicRingBuffer&&) = delete;
+
+    ~AtomicRingBuffer() noexcept
+    {
+        while (try_pop())
+        {
+        }
+    }
+
+    [[nodiscard]] std::size_t capacity() const noexcept { return capacity_; }
+
+    // Thread-safe. The value is only moved from if the push succeeded.
+    template <class U>
+    [[nodiscard]] bool try_push(U&& value)
+    {
+        auto position = enqueue_position_.load(std::memory_order_relaxed);
+        while (true)
+        {
+            auto& slot = slots_[position % capacity_];
+            const auto writable_turn = 2 * (position / capacity_);
+            const auto turn = slot.turn_.load(std::memory_order_acquire);
+            if (turn == writable_turn)
+            {
+                if (enqueue_position_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    ::new (static_cast<void*>(slot.data_)) T(static_cast<U&&>(value));
+                    slot.turn_.store(writable_turn + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (turn < writable_turn)
+            {
+                // The slot still holds the value of the previous lap
+                return false;
+            }
+            else
+            {
+                position = enqueue_position_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Single consumer only
+    [[nodiscard]] std::optional<T> try_pop()
+    {
+        auto& slot = slots_[dequeue_position_ % capacity_];
+        const auto readable_turn = 2 * (dequeue_position_ / capacity_) + 1;
+        if (slot.turn_.load(std::memory_order_acquire) != readable_turn)
+        {
+            return std::nullopt;
+        }
+        auto* const value = std::launder(reinterpret_cast<T*>(slot.data_));
+        std::optional<T> result{static_cast<T&&>(*value)};
+        std::destroy_at(value);
+        slot.turn_.store(readable_turn + 1, std::memory_order_release);
+        ++dequeue_position_;
+        return result;
+    }
+
+    // Single consumer only
+    [[nodiscard]] bool empty() const noexcept
+    {
+        const auto& slot = slots_[dequeue_position_ % capacity_];
+        return slot.turn_.load(std::memory_order_acquire) != 2 * (dequeue_position_ / capacity_) + 1;
+    }
+
+  private:
+    struct Slot
+    {
+        std::atomic_size_t turn_{};
+        alignas(T) std::byte data_[sizeof(T)];
+    };
+
+    std::size_t capacity_;
+    std::unique_ptr<Slot[]> slots_;
+    std::atomic_size_t enqueue_position_{};
+    std::size_t dequeue_position_{};
+};
+}
+
+AGRPC_NAMESPACE_END
+
+#endif  // AGRPC_DETAIL_ATOMIC_RING_BUFFER_HPP
@@ -98,6 +98,19 @@ void submit_basic_sender_running_operation(agrpc::GrpcContext& grpc_context, Rec
 template <class Implementation, class Receiver>
 class BasicSenderOperationState;
 
+#ifdef AGRPC_STDEXEC
+struct BasicSenderEnv
+{
+    template <class GrpcContext = agrpc::GrpcContext>
+    [[nodiscard]] auto query(::stdexec::get_completion_scheduler_t<::stdexec::set_value_t>) const noexcept
+    {
+        return static_cast<GrpcContext&>(grpc_context_).get_scheduler();
+    }
+
+    agrpc::GrpcContext& grpc_context_;
+};
+#endif
+
 template <class Implementation>
 class BasicSender : public detail::SenderOf<typename Implementation::Signature>
 {
@@ -138,6 +151,10 @@ class BasicSender : public detail::SenderOf<typename Implementation::Signature>
                                                       implementation_);
     }
 
+#ifdef AGRPC_STDEXEC
+    [[nodiscard]] detail::BasicSenderEnv get_env() const noexcept { return {grpc_context_}; }
+#endif
+
   private:
     friend detail::BasicSenderAccess;
 
@@ -38,25 +38,25 @@ class BufferAllocator
     {
     }
 
-    [[nodiscard]] T* allocate(std::size_t n) noexcept
+    [[nodiscard]] T* allocate(std::size_t n)
     {
         static_assert(alignof(std::max_align_t) >= alignof(T), "Overaligned types are not supported");
         static_assert(Buffer::max_size() >= sizeof(T), "Insufficient buffer size");
         return static_cast<T*>(buffer_->allocate(n * sizeof(T)));
     }
 
-    static void deallocate(T*, std::size_t) noexcept {}
+    void deallocate(T* p, std::size_t n) noexcept { buffer_->deallocate(p, n * sizeof(T)); }
 
     template <class U>
     friend bool operator==(const BufferAllocator& lhs, const detail::BufferAllocator<U, Buffer>& rhs) noexcept
     {
-        return lhs.buffer_ == rhs.buffer;
+        return lhs.buffer_ == rhs.buffer_;
     }
 
     template <class U>
     friend bool operator!=(const BufferAllocator& lhs, const detail::BufferAllocator<U, Buffer>& rhs) noexcept
     {
-        return lhs.buffer_ != rhs.buffer;
+        return lhs.buffer_ != rhs.buffer_;
     }
 
   private:
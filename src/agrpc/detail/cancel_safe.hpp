@@ -22,10 +22,16 @@
 #include <agrpc/detail/utility.hpp>
 #include <agrpc/detail/work_tracking_completion_handler.hpp>
 
+#include <cstddef>
+
 AGRPC_NAMESPACE_BEGIN()
 
 namespace detail
 {
+// Large enough for an `asio::use_awaitable` completion handler with an `asio::any_io_executor` after it has been
+// wrapped into a WorkTrackingCompletionHandler.
+inline constexpr std::size_t CANCEL_SAFE_DEFAULT_HANDLER_BUFFER_SIZE = 16 * sizeof(void*);
+
 template <class Signature>
 struct PrependErrorCodeToSignature;
 
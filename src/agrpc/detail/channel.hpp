@@ -0,0 +1,260 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_DETAIL_CHANNEL_HPP
+#define AGRPC_DETAIL_CHANNEL_HPP
+
+#include <agrpc/detail/atomic_ring_buffer.hpp>
+#include <agrpc/detail/config.hpp>
+#include <agrpc/detail/grpc_context_implementation.hpp>
+#include <agrpc/detail/intrusive_list.hpp>
+#include <agrpc/detail/intrusive_list_hook.hpp>
+#include <agrpc/detail/operation_base.hpp>
+#include <agrpc/detail/parked_operations.hpp>
+#include <agrpc/detail/parking_slot.hpp>
+#include <agrpc/detail/sender_implementation.hpp>
+#include <agrpc/detail/utility.hpp>
+#include <agrpc/grpc_context.hpp>
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <optional>
+#include <utility>
+
+AGRPC_NAMESPACE_BEGIN()
+
+namespace detail
+{
+template <class T>
+class ChannelSendSenderImplementation;
+
+// Waiting senders are only accessed from the GrpcContext's thread. While there are any, this object is added to the
+// GrpcContext so that they are destroyed when it shuts down.
+template <class T>
+class ChannelState : public detail::ParkedOperations
+{
+  public:
+    ChannelState(agrpc::GrpcContext& grpc_context, std::size_t max_buffer_size)
+        : detail::ParkedOperations(&ChannelState::do_shutdown), grpc_context_(grpc_context), buffer_(max_buffer_size)
+    {
+    }
+
+    ~ChannelState() noexcept
+    {
+        assert(waiting_senders_.empty() &&
+               "All operations must have completed before the channel is destroyed, see close()");
+    }
+
+    [[nodiscard]] agrpc::GrpcContext& grpc_context() const noexcept { return grpc_context_; }
+
+    [[nodiscard]] std::size_t max_buffer_size() const noexcept { return buffer_.capacity(); }
+
+    [[nodiscard]] bool is_closed() const noexcept { return closed_.load(std::memory_order_relaxed); }
+
+    template <class U>
+    [[nodiscard]] bool try_send(U&& value)
+    {
+        return receiver_slot_.notify(grpc_context_,
+                                     [&]
+                                     {
+                                         return !is_closed() && buffer_.try_push(static_cast<U&&>(value));
+                                     });
+    }
+
+    [[nodiscard]] std::optional<T> try_receive()
+    {
+        auto value = buffer_.try_pop();
+        if (value && !waiting_senders_.empty())
+        {
+            // Space has been made, move the value of the oldest waiting sender into the buffer.
+            auto& sender = *waiting_senders_.begin();
+            if (buffer_.try_push(static_cast<T&&>(sender.value_)))
+            {
+                static_cast<void>(waiting_senders_.pop_front());
+                if (waiting_senders_.empty())
+                {
+                    detail::GrpcContextImplementation::remove_parked_operations(grpc_context_, this);
+                }
+                sender.sent_ = true;
+                detail::GrpcContextImplementation::add_local_operation(grpc_context_, sender.operation_);
+            }
+        }
+        return value;
+    }
+
+    // Returns false if a value became available or the channel was closed while parking, in which case the operation
+    // has not been parked.
+    [[nodiscard]] bool try_park_receiver(detail::QueueableOperationBase* operation) noexcept
+    {
+        return receiver_slot_.try_park(grpc_context_, operation,
+                                       [&]
+                                       {
+                                           return !buffer_.empty() || is_closed();
+                                       });
+    }
+
+    void unpark_receiver(detail::QueueableOperationBase* operation) noexcept { receiver_slot_.unpark(operation); }
+
+    void park_sender(detail::ChannelSendSenderImplementation<T>& sender) noexcept
+    {
+        grpc_context_.work_started();
+        if (waiting_senders_.empty())
+        {
+            detail::GrpcContextImplementation::add_parked_operations(grpc_context_, this);
+        }
+        waiting_senders_.push_back(&sender);
+    }
+
+    void close() noexcept
+    {
+        receiver_slot_.notify(grpc_context_,
+                              [&]
+                              {
+                                  closed_.store(true, std::memory_order_relaxed);
+                                  return true;
+                              });
+        if (waiting_senders_.empty())
+        {
+            return;
+        }
+        detail::GrpcContextImplementation::remove_parked_operations(grpc_context_, this);
+        while (!waiting_senders_.empty())
+        {
+            auto* const sender = waiting_senders_.pop_front();
+            detail::GrpcContextImplementation::add_local_operation(grpc_context_, sender->operation_);
+        }
+    }
+
+  private:
+    static void do_shutdown(detail::ParkedOperations* parked_operations, agrpc::GrpcContext& grpc_context)
+    {
+        auto waiting_senders{std::move(static_cast<ChannelState*>(parked_operations)->waiting_senders_)};
+        while (!waiting_senders.empty())
+        {
+            auto* const sender = waiting_senders.pop_front();
+            sender->operation_->complete(detail::OperationResult::SHUTDOWN_NOT_OK, grpc_context);
+        }
+    }
+
+    agrpc::GrpcContext& grpc_context_;
+    detail::AtomicRingBuffer<T> buffer_;
+    detail::IntrusiveList<detail::ChannelSendSenderImplementation<T>> waiting_senders_;
+    std::atomic_bool closed_{};
+    detail::ParkingSlot receiver_slot_;
+};
+
+template <class T>
+class ChannelSendSenderImplementation : public detail::IntrusiveListHook<ChannelSendSenderImplementation<T>>
+{
+  public:
+    static constexpr auto TYPE = detail::SenderImplementationType::NO_ARG;
+
+    using Signature = void(bool);
+    using StopFunction = detail::Empty;
+    using Initiation = detail::Empty;
+
+    template <class U>
+    ChannelSendSenderImplementation(detail::ChannelState<T>& state, U&& value)
+        : state_(state), value_(static_cast<U&&>(value))
+    {
+    }
+
+    template <class Init>
+    void initiate(Init init, const Initiation&)
+    {
+        operation_ = init.self();
+        // Complete on the GrpcContext so that waiting senders are only ever accessed from its thread.
+        detail::GrpcContextImplementation::add_operation(init.grpc_context(), operation_);
+    }
+
+    template <class OnDone>
+    void done(OnDone on_done)
+    {
+        if (sent_)
+        {
+            on_done(true);
+            return;
+        }
+        if (state_.is_closed())
+        {
+            on_done(false);
+            return;
+        }
+        if (state_.try_send(static_cast<T&&>(value_)))
+        {
+            on_done(true);
+            return;
+        }
+        state_.park_sender(*this);
+    }
+
+  private:
+    friend detail::ChannelState<T>;
+
+    detail::ChannelState<T>& state_;
+    T value_;
+    detail::QueueableOperationBase* operation_;
+    bool sent_{};
+};
+
+template <class T>
+class ChannelReceiveSenderImplementation
+{
+  public:
+    static constexpr auto TYPE = detail::SenderImplementationType::NO_ARG;
+
+    using Signature = void(bool, T);
+    using StopFunction = detail::Empty;
+    using Initiation = detail::Empty;
+
+    explicit ChannelReceiveSenderImplementation(detail::ChannelState<T>& state) noexcept : state_(state) {}
+
+    template <class Init>
+    void initiate(Init init, const Initiation&)
+    {
+        detail::GrpcContextImplementation::add_operation(init.grpc_context(), init.self());
+    }
+
+    template <class OnDone>
+    void done(OnDone on_done)
+    {
+        state_.unpark_receiver(on_done.self());
+        while (true)
+        {
+            if (auto value = state_.try_receive())
+            {
+                on_done(true, static_cast<T&&>(*value));
+                return;
+            }
+            if (state_.is_closed())
+            {
+                on_done(false, T{});
+                return;
+            }
+            if (state_.try_park_receiver(on_done.self()))
+            {
+                return;
+            }
+        }
+    }
+
+  private:
+    detail::ChannelState<T>& state_;
+};
+}
+
+AGRPC_NAMESPACE_END
+
+#endif  // AGRPC_DETAIL_CHANNEL_HPP
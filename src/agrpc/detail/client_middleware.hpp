@@ -0,0 +1,177 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_DETAIL_CLIENT_MIDDLEWARE_HPP
+#define AGRPC_DETAIL_CLIENT_MIDDLEWARE_HPP
+
+#include <agrpc/detail/config.hpp>
+#include <agrpc/detail/high_level_client_sender.hpp>
+#include <agrpc/detail/rpc_type.hpp>
+#include <agrpc/grpc_context.hpp>
+#include <grpcpp/client_context.h>
+#include <grpcpp/support/status.h>
+
+#include <cstddef>
+#include <tuple>
+#include <utility>
+
+AGRPC_NAMESPACE_BEGIN()
+
+namespace detail
+{
+template <class Interceptor, class = void>
+inline constexpr bool CLIENT_INTERCEPTOR_HAS_BEFORE = false;
+
+template <class Interceptor>
+inline constexpr bool CLIENT_INTERCEPTOR_HAS_BEFORE<
+    Interceptor, decltype((void)std::declval<Interceptor&>().before(std::declval<grpc::ClientContext&>()))> = true;
+
+template <class Interceptor, class = void>
+inline constexpr bool CLIENT_INTERCEPTOR_HAS_AFTER = false;
+
+template <class Interceptor>
+inline constexpr bool
+    CLIENT_INTERCEPTOR_HAS_AFTER<Interceptor, decltype((void)std::declval<Interceptor&>().after(
+                                                  std::declval<grpc::ClientContext&>(),
+                                                  std::declval<const grpc::Status&>()))> = true;
+
+// Runs `before` hooks in order and `after` hooks in reverse order.
+template <class... Interceptors>
+class ClientInterceptorChain
+{
+  public:
+    template <class... Args>
+    explicit ClientInterceptorChain(Args&&... args) : interceptors_(static_cast<Args&&>(args)...)
+    {
+    }
+
+    void before(grpc::ClientContext& client_context)
+    {
+        before_impl(client_context, std::index_sequence_for<Interceptors...>{});
+    }
+
+    void after(grpc::ClientContext& client_context, const grpc::Status& status) noexcept
+    {
+        after_impl(client_context, status, std::index_sequence_for<Interceptors...>{});
+    }
+
+  private:
+    template <std::size_t... I>
+    void before_impl(grpc::ClientContext& client_context, std::index_sequence<I...>)
+    {
+        (before_one(std::get<I>(interceptors_), client_context), ...);
+    }
+
+    template <class Interceptor>
+    static void before_one(Interceptor& interceptor, grpc::ClientContext& client_context)
+    {
+        if constexpr (detail::CLIENT_INTERCEPTOR_HAS_BEFORE<Interceptor>)
+        {
+            interceptor.before(client_context);
+        }
+    }
+
+    template <std::size_t... I>
+    void after_impl(grpc::ClientContext& client_context, const grpc::Status& status,
+                    std::index_sequence<I...>) noexcept
+    {
+        static constexpr auto SIZE = sizeof...(Interceptors);
+        (after_one(std::get<SIZE - 1 - I>(interceptors_), client_context, status), ...);
+    }
+
+    template <class Interceptor>
+    static void after_one(Interceptor& interceptor, grpc::ClientContext& client_context,
+                          const grpc::Status& status) noexcept
+    {
+        if constexpr (detail::CLIENT_INTERCEPTOR_HAS_AFTER<Interceptor>)
+        {
+            interceptor.after(client_context, status);
+        }
+    }
+
+    std::tuple<Interceptors...> interceptors_;
+};
+
+// Base class so that the `before` hooks run prior to the creation of the call, which is when gRPC reads the deadline
+// and other properties of the grpc::ClientContext. If the RPC does not finish, because the operation is destroyed when
+// the GrpcContext shuts down or before it has been started, then the `after` hooks run upon destruction.
+template <class... Interceptors>
+struct ClientInterceptorChainHolder
+{
+    ClientInterceptorChainHolder(const detail::ClientInterceptorChain<Interceptors...>& chain,
+                                 grpc::ClientContext& client_context)
+        : chain_(chain), client_context_(&client_context)
+    {
+        chain_.before(client_context);
+    }
+
+    ClientInterceptorChainHolder(ClientInterceptorChainHolder&& other)
+        : chain_(static_cast<detail::ClientInterceptorChain<Interceptors...>&&>(other.chain_)),
+          client_context_(std::exchange(other.client_context_, nullptr))
+    {
+    }
+
+    ClientInterceptorChainHolder(const ClientInterceptorChainHolder&) = delete;
+    ClientInterceptorChainHolder& operator=(const ClientInterceptorChainHolder&) = delete;
+    ClientInterceptorChainHolder& operator=(ClientInterceptorChainHolder&&) = delete;
+
+    ~ClientInterceptorChainHolder() noexcept
+    {
+        after(grpc::Status{grpc::StatusCode::CANCELLED, "RPC did not finish"});
+    }
+
+    void after(const grpc::Status& status) noexcept
+    {
+        if (auto* const client_context = std::exchange(client_context_, nullptr))
+        {
+            chain_.after(*client_context, status);
+        }
+    }
+
+    detail::ClientInterceptorChain<Interceptors...> chain_;
+    grpc::ClientContext* client_context_;
+};
+
+template <auto PrepareAsync, class... Interceptors>
+struct ClientMiddlewareUnaryRequestSenderImplementation;
+
+template <class Stub, class Request, class Response, template <class> class Responder,
+          detail::ClientUnaryRequest<Stub, Request, Responder<Response>> PrepareAsync, class... Interceptors>
+struct ClientMiddlewareUnaryRequestSenderImplementation<PrepareAsync, Interceptors...>
+    : detail::ClientInterceptorChainHolder<Interceptors...>,
+      detail::ClientUnaryRequestSenderImplementationBase<Responder<Response>>
+{
+    using Holder = detail::ClientInterceptorChainHolder<Interceptors...>;
+    using Base = detail::ClientUnaryRequestSenderImplementationBase<Responder<Response>>;
+
+    ClientMiddlewareUnaryRequestSenderImplementation(const detail::ClientInterceptorChain<Interceptors...>& chain,
+                                                     agrpc::GrpcContext& grpc_context, Stub& stub,
+                                                     grpc::ClientContext& client_context, const Request& req)
+        : Holder(chain, client_context),
+          Base{(stub.*PrepareAsync)(&client_context, req, grpc_context.get_completion_queue())}
+    {
+    }
+
+    template <class OnDone>
+    void done(OnDone on_done, bool ok)
+    {
+        Holder::after(this->status_);
+        Base::done(static_cast<OnDone&&>(on_done), ok);
+    }
+};
+}
+
+AGRPC_NAMESPACE_END
+
+#endif  // AGRPC_DETAIL_CLIENT_MIDDLEWARE_HPP
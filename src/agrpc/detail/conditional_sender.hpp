@@ -54,6 +54,14 @@ class ConditionalSender
 
     static constexpr bool sends_done = Sender::sends_done;
 
+#ifdef AGRPC_STDEXEC
+    using sender_concept = ::stdexec::sender_t;
+
+    using completion_signatures = typename Sender::completion_signatures;
+
+    [[nodiscard]] decltype(auto) get_env() const noexcept { return ::stdexec::get_env(sender_); }
+#endif
+
     template <class Receiver>
     detail::ConditionalSenderOperationState<Sender, detail::RemoveCrefT<Receiver>, CompletionArgs...> connect(
         Receiver&& receiver) && noexcept((detail::IS_NOTRHOW_DECAY_CONSTRUCTIBLE_V<Receiver> &&
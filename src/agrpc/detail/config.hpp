@@ -57,11 +57,18 @@
 #define AGRPC_HAS_CONCEPTS
 #endif
 
+#if __cpp_impl_coroutine >= 201902L && __cpp_lib_coroutine >= 201902L
+#define AGRPC_HAS_STD_COROUTINE
+#endif
+
 #if __cpp_exceptions >= 199711L
 #define AGRPC_TRY try
 #define AGRPC_CATCH(...) catch (__VA_ARGS__)
 #define AGRPC_RETHROW() throw
+#define AGRPC_THROW(...) throw __VA_ARGS__
 #else
+#include <cstdlib>
+
 #define AGRPC_TRY
 #define AGRPC_CATCH(...) \
     if constexpr (true)  \
@@ -69,6 +76,7 @@
     }                    \
     else
 #define AGRPC_RETHROW() ((void)0)
+#define AGRPC_THROW(...) std::abort()
 #endif
 
 #ifdef AGRPC_GENERATING_DOCUMENTATION
@@ -93,10 +101,17 @@
     {                           \
     inline namespace u          \
     {
+#elif defined(AGRPC_STDEXEC)
+#define AGRPC_NAMESPACE_BEGIN() \
+    namespace agrpc             \
+    {                           \
+    inline namespace e          \
+    {
 #else
 static_assert(false,
               "asio-grpc backend macro is not defined. Did you forget to link with `asio-grpc::asio-grpc`, "
-              "`asio-grpc::asio-grpc-standalone-asio` or `asio-grpc::asio-grpc-unifex` in your CMake file?");
+              "`asio-grpc::asio-grpc-standalone-asio`, `asio-grpc::asio-grpc-unifex` or "
+              "`asio-grpc::asio-grpc-stdexec` in your CMake file?");
 #endif
 
 #ifdef AGRPC_GENERTING_DOCUMENTATION
@@ -0,0 +1,79 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_DETAIL_EXECUTION_STDEXEC_HPP
+#define AGRPC_DETAIL_EXECUTION_STDEXEC_HPP
+
+#include <agrpc/detail/config.hpp>
+#include <stdexec/execution.hpp>
+
+#include <memory>
+#include <type_traits>
+
+AGRPC_NAMESPACE_BEGIN()
+
+namespace detail::exec
+{
+template <class Object>
+auto get_allocator(const Object& object) noexcept
+{
+    using Env = ::stdexec::env_of_t<const Object&>;
+    if constexpr (std::is_invocable_v<::stdexec::get_allocator_t, const Env&>)
+    {
+        return ::stdexec::get_allocator(::stdexec::get_env(object));
+    }
+    else
+    {
+        return std::allocator<void>{};
+    }
+}
+
+template <class Object>
+auto get_scheduler(const Object& object) noexcept
+{
+    return ::stdexec::get_scheduler(::stdexec::get_env(object));
+}
+
+template <class Object>
+auto get_executor(const Object& object) noexcept
+{
+    return exec::get_scheduler(object);
+}
+
+template <class T>
+inline constexpr bool is_sender_v = ::stdexec::sender<T>;
+
+using ::stdexec::connect;
+using ::stdexec::connect_result_t;
+using ::stdexec::set_error;
+using ::stdexec::set_value;
+using ::stdexec::start;
+
+inline constexpr const auto& set_done = ::stdexec::set_stopped;
+
+template <class Receiver>
+auto get_stop_token(const Receiver& receiver) noexcept
+{
+    return ::stdexec::get_stop_token(::stdexec::get_env(receiver));
+}
+
+template <class Receiver>
+using stop_token_type_t = ::stdexec::stop_token_of_t<::stdexec::env_of_t<Receiver>>;
+
+using unstoppable_token = ::stdexec::never_stop_token;
+}  // namespace detail::exec
+
+AGRPC_NAMESPACE_END
+
+#endif  // AGRPC_DETAIL_EXECUTION_STDEXEC_HPP
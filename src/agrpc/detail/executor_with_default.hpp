@@ -18,6 +18,8 @@
 #include <agrpc/detail/asio_forward.hpp>
 #include <agrpc/detail/config.hpp>
 
+#include <type_traits>
+
 AGRPC_NAMESPACE_BEGIN()
 
 namespace detail
@@ -37,7 +39,7 @@ struct ExecutorWithDefault : Executor
 
 AGRPC_NAMESPACE_END
 
-#if !defined(AGRPC_UNIFEX) && !defined(BOOST_ASIO_HAS_DEDUCED_EQUALITY_COMPARABLE_TRAIT) && \
+#if !defined(AGRPC_UNIFEX) && !defined(AGRPC_STDEXEC) && !defined(BOOST_ASIO_HAS_DEDUCED_EQUALITY_COMPARABLE_TRAIT) && \
     !defined(ASIO_HAS_DEDUCED_EQUALITY_COMPARABLE_TRAIT)
 template <class Default, class Executor>
 struct agrpc::asio::traits::equality_comparable<agrpc::detail::ExecutorWithDefault<Default, Executor>>
@@ -46,7 +48,7 @@ struct agrpc::asio::traits::equality_comparable<agrpc::detail::ExecutorWithDefau
 };
 #endif
 
-#if !defined(AGRPC_UNIFEX) && !defined(BOOST_ASIO_HAS_DEDUCED_EXECUTE_MEMBER_TRAIT) && \
+#if !defined(AGRPC_UNIFEX) && !defined(AGRPC_STDEXEC) && !defined(BOOST_ASIO_HAS_DEDUCED_EXECUTE_MEMBER_TRAIT) && \
     !defined(ASIO_HAS_DEDUCED_EXECUTE_MEMBER_TRAIT)
 template <class Default, class Executor, class F>
 struct agrpc::asio::traits::execute_member<agrpc::detail::ExecutorWithDefault<Default, Executor>, F>
@@ -55,7 +57,7 @@ struct agrpc::asio::traits::execute_member<agrpc::detail::ExecutorWithDefault<De
 };
 #endif
 
-#if !defined(AGRPC_UNIFEX) && !defined(BOOST_ASIO_HAS_DEDUCED_REQUIRE_MEMBER_TRAIT) && \
+#if !defined(AGRPC_UNIFEX) && !defined(AGRPC_STDEXEC) && !defined(BOOST_ASIO_HAS_DEDUCED_REQUIRE_MEMBER_TRAIT) && \
     !defined(ASIO_HAS_DEDUCED_REQUIRE_MEMBER_TRAIT)
 template <class Default, class Executor>
 struct agrpc::asio::traits::require_member<agrpc::detail::ExecutorWithDefault<Default, Executor>,
@@ -120,7 +122,7 @@ struct agrpc::asio::traits::require_member<agrpc::detail::ExecutorWithDefault<De
 };
 #endif
 
-#if !defined(AGRPC_UNIFEX) && !defined(BOOST_ASIO_HAS_DEDUCED_PREFER_MEMBER_TRAIT) && \
+#if !defined(AGRPC_UNIFEX) && !defined(AGRPC_STDEXEC) && !defined(BOOST_ASIO_HAS_DEDUCED_PREFER_MEMBER_TRAIT) && \
     !defined(ASIO_HAS_DEDUCED_PREFER_MEMBER_TRAIT)
 template <class Default, class Executor>
 struct agrpc::asio::traits::prefer_member<agrpc::detail::ExecutorWithDefault<Default, Executor>,
@@ -144,7 +146,8 @@ struct agrpc::asio::traits::prefer_member<agrpc::detail::ExecutorWithDefault<Def
 };
 #endif
 
-#if !defined(AGRPC_UNIFEX) && !defined(BOOST_ASIO_HAS_DEDUCED_QUERY_STATIC_CONSTEXPR_MEMBER_TRAIT) && \
+#if !defined(AGRPC_UNIFEX) && !defined(AGRPC_STDEXEC) && \
+    !defined(BOOST_ASIO_HAS_DEDUCED_QUERY_STATIC_CONSTEXPR_MEMBER_TRAIT) && \
     !defined(ASIO_HAS_DEDUCED_QUERY_STATIC_CONSTEXPR_MEMBER_TRAIT)
 template <class Default, class Executor, class Property>
 struct agrpc::asio::traits::query_static_constexpr_member<
@@ -205,7 +208,7 @@ struct agrpc::asio::traits::query_static_constexpr_member<
 };
 #endif
 
-#if !defined(AGRPC_UNIFEX) && !defined(BOOST_ASIO_HAS_DEDUCED_QUERY_MEMBER_TRAIT) && \
+#if !defined(AGRPC_UNIFEX) && !defined(AGRPC_STDEXEC) && !defined(BOOST_ASIO_HAS_DEDUCED_QUERY_MEMBER_TRAIT) && \
     !defined(ASIO_HAS_DEDUCED_QUERY_MEMBER_TRAIT)
 template <class Default, class Executor>
 struct agrpc::asio::traits::query_member<agrpc::detail::ExecutorWithDefault<Default, Executor>,
@@ -19,6 +19,7 @@
 #include <agrpc/detail/grpc_executor_options.hpp>
 #include <agrpc/detail/namespace_cpp20.hpp>
 
+#include <cstddef>
 #include <memory>
 
 AGRPC_NAMESPACE_BEGIN()
@@ -30,7 +31,7 @@ class GrpcContext;
 
 class HealthCheckService;
 
-template <class Executor>
+template <class Executor, std::size_t Capacity = 1>
 class BasicGrpcStream;
 
 template <class Executor>
@@ -38,6 +39,9 @@ class BasicAlarm;
 
 struct UseSender;
 
+template <class T = void>
+class Task;
+
 namespace detail
 {
 template <class Item>
@@ -57,6 +61,10 @@ class GenericRPCContext;
 
 class NotfiyWhenDoneSenderImplementation;
 
+class ParkedOperations;
+
+class AlarmPool;
+
 struct HealthCheckServiceData;
 
 class HealthCheckWatcher;
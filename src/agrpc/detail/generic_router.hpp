@@ -0,0 +1,202 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_DETAIL_GENERIC_ROUTER_HPP
+#define AGRPC_DETAIL_GENERIC_ROUTER_HPP
+
+#include <agrpc/detail/config.hpp>
+#include <agrpc/detail/math.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+AGRPC_NAMESPACE_BEGIN()
+
+namespace detail
+{
+inline constexpr std::uint64_t perfect_hash_mix(std::uint64_t h) noexcept
+{
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+inline constexpr std::uint64_t perfect_hash(std::string_view key, std::uint64_t seed) noexcept
+{
+    std::uint64_t h = 0xcbf29ce484222325ULL ^ (seed * 0x9e3779b97f4a7c15ULL);
+    for (const auto c : key)
+    {
+        h ^= static_cast<unsigned char>(c);
+        h *= 0x100000001b3ULL;
+    }
+    return detail::perfect_hash_mix(h);
+}
+
+// Hash-and-displace perfect hash over a fixed set of keys. The key's hash selects a bucket whose displacement, found
+// at construction, maps it to a slot that no other key occupies. A lookup therefore costs one pass over the key to
+// hash it, one mix and a single comparison against the only candidate. Keys that equal an earlier key are not
+// indexed but remembered as duplicates.
+class PerfectHashIndex
+{
+  private:
+    static constexpr std::uint32_t EMPTY = std::numeric_limits<std::uint32_t>::max();
+    static constexpr std::uint32_t MAX_DISPLACEMENT = 1u << 16;
+
+  public:
+    static constexpr std::size_t NPOS = std::numeric_limits<std::size_t>::max();
+
+    explicit PerfectHashIndex(std::vector<std::string> keys) : keys_(std::move(keys))
+    {
+        assert(keys_.size() < EMPTY && "Too many keys");
+        const auto key_count = keys_.size();
+        const auto slot_count = std::size_t{1} << detail::ceil_log2(detail::maximum<std::size_t>(1, key_count * 5 / 4));
+        const auto bucket_count =
+            std::size_t{1} << detail::ceil_log2(detail::maximum<std::size_t>(1, (key_count + 3) / 4));
+        slot_mask_ = slot_count - 1;
+        bucket_mask_ = bucket_count - 1;
+        // Identical hashes of distinct keys are astronomically unlikely but would prevent finding displacements, retry
+        // with a different seed in that case.
+        while (!try_build(slot_count, bucket_count))
+        {
+            ++seed_;
+        }
+    }
+
+    [[nodiscard]] std::size_t find(std::string_view key) const noexcept
+    {
+        const auto hash = detail::perfect_hash(key, seed_);
+        const auto index = slots_[slot_of(hash, displacements_[bucket_of(hash)])];
+        if (index == EMPTY || keys_[index] != key)
+        {
+            return NPOS;
+        }
+        return index;
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return keys_.size() - duplicates_.size(); }
+
+    [[nodiscard]] const std::string& key(std::size_t index) const noexcept { return keys_[index]; }
+
+    [[nodiscard]] const std::vector<std::uint32_t>& duplicates() const noexcept { return duplicates_; }
+
+  private:
+    [[nodiscard]] std::size_t bucket_of(std::uint64_t hash) const noexcept { return (hash >> 32) & bucket_mask_; }
+
+    [[nodiscard]] std::size_t slot_of(std::uint64_t hash, std::uint32_t displacement) const noexcept
+    {
+        return detail::perfect_hash_mix(hash ^ displacement) & slot_mask_;
+    }
+
+    bool try_build(std::size_t slot_count, std::size_t bucket_count)
+    {
+        std::vector<std::uint64_t> hashes(keys_.size());
+        std::vector<std::vector<std::uint32_t>> buckets(bucket_count);
+        duplicates_.clear();
+        for (std::uint32_t i{}; i < keys_.size(); ++i)
+        {
+            hashes[i] = detail::perfect_hash(keys_[i], seed_);
+            auto& bucket = buckets[bucket_of(hashes[i])];
+            const auto duplicate = std::find_if(bucket.begin(), bucket.end(),
+                                                [&](std::uint32_t other)
+                                                {
+                                                    return keys_[other] == keys_[i];
+                                                });
+            if (duplicate == bucket.end())
+            {
+                bucket.push_back(i);
+            }
+            else
+            {
+                duplicates_.push_back(i);
+            }
+        }
+        std::vector<std::uint32_t> order(bucket_count);
+        for (std::uint32_t i{}; i < bucket_count; ++i)
+        {
+            order[i] = i;
+        }
+        // Placing large buckets first while most slots are still free makes finding displacements cheap.
+        std::stable_sort(order.begin(), order.end(),
+                         [&](std::uint32_t lhs, std::uint32_t rhs)
+                         {
+                             return buckets[lhs].size() > buckets[rhs].size();
+                         });
+        slots_.assign(slot_count, EMPTY);
+        displacements_.assign(bucket_count, 0);
+        std::vector<std::size_t> candidate;
+        for (const auto bucket_index : order)
+        {
+            const auto& bucket = buckets[bucket_index];
+            if (bucket.empty())
+            {
+                break;
+            }
+            std::uint32_t displacement{};
+            for (; displacement < MAX_DISPLACEMENT; ++displacement)
+            {
+                candidate.clear();
+                const auto fits = std::all_of(bucket.begin(), bucket.end(),
+                                              [&](std::uint32_t key_index)
+                                              {
+                                                  const auto slot = slot_of(hashes[key_index], displacement);
+                                                  if (slots_[slot] != EMPTY ||
+                                                      std::find(candidate.begin(), candidate.end(), slot) !=
+                                                          candidate.end())
+                                                  {
+                                                      return false;
+                                                  }
+                                                  candidate.push_back(slot);
+                                                  return true;
+                                              });
+                if (fits)
+                {
+                    break;
+                }
+            }
+            if (displacement == MAX_DISPLACEMENT)
+            {
+                return false;
+            }
+            displacements_[bucket_index] = displacement;
+            for (std::size_t i{}; i < bucket.size(); ++i)
+            {
+                slots_[candidate[i]] = bucket[i];
+            }
+        }
+        return true;
+    }
+
+    std::vector<std::string> keys_;
+    std::vector<std::uint32_t> slots_;
+    std::vector<std::uint32_t> displacements_;
+    std::vector<std::uint32_t> duplicates_;
+    std::size_t slot_mask_{};
+    std::size_t bucket_mask_{};
+    std::uint64_t seed_{};
+};
+}
+
+AGRPC_NAMESPACE_END
+
+#endif  // AGRPC_DETAIL_GENERIC_ROUTER_HPP
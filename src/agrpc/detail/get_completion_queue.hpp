@@ -28,8 +28,8 @@ grpc::CompletionQueue* get_completion_queue(const agrpc::BasicGrpcExecutor<Alloc
 
 grpc::CompletionQueue* get_completion_queue(agrpc::GrpcContext&) noexcept;
 
-template <class Executor>
-grpc::CompletionQueue* get_completion_queue(const agrpc::BasicGrpcStream<Executor>&) noexcept;
+template <class Executor, std::size_t Capacity>
+grpc::CompletionQueue* get_completion_queue(const agrpc::BasicGrpcStream<Executor, Capacity>&) noexcept;
 }
 
 AGRPC_NAMESPACE_END
@@ -29,6 +29,7 @@
 #include <grpcpp/completion_queue.h>
 
 #include <atomic>
+#include <cstddef>
 #include <utility>
 
 AGRPC_NAMESPACE_BEGIN()
@@ -71,6 +72,9 @@ inline GrpcContext::~GrpcContext()
     stop();
     shutdown_.store(true, std::memory_order_relaxed);
     completion_queue_->Shutdown();
+    // Parked operations go first: an owner that has been notified but not yet resumed still holds a stale reference to
+    // its operation which sits in one of the queues drained below.
+    detail::GrpcContextImplementation::shutdown_parked_operations(*this);
     detail::drain_completion_queue(*this);
 #if defined(AGRPC_STANDALONE_ASIO) || defined(AGRPC_BOOST_ASIO)
     asio::execution_context::shutdown();
@@ -184,6 +188,10 @@ inline grpc::ServerCompletionQueue* GrpcContext::get_server_completion_queue() n
     return static_cast<grpc::ServerCompletionQueue*>(completion_queue_.get());
 }
 
+inline void GrpcContext::set_local_work_budget(std::size_t budget) noexcept { local_work_budget_ = budget; }
+
+inline std::size_t GrpcContext::local_work_budget() const noexcept { return local_work_budget_; }
+
 AGRPC_NAMESPACE_END
 
 #include <agrpc/detail/grpc_context_implementation.ipp>
@@ -23,6 +23,7 @@
 #include <agrpc/detail/utility.hpp>
 #include <grpcpp/completion_queue.h>
 
+#include <cstddef>
 #include <cstdint>
 #include <limits>
 
@@ -92,6 +93,18 @@ struct IsGrpcContextStoppedPredicate
     [[nodiscard]] bool operator()(const agrpc::GrpcContext& grpc_context) const noexcept;
 };
 
+// Embedded into the GrpcContext. Passes through the completion queue once and then moves yielded work into the local
+// queue, thereby placing it behind the completion queue events that were pending at the time.
+class YieldOperation : public detail::OperationBase
+{
+  public:
+    YieldOperation() noexcept;
+
+  private:
+    static void do_complete(detail::OperationBase* op, detail::OperationResult result,
+                            agrpc::GrpcContext& grpc_context) noexcept;
+};
+
 struct GrpcContextImplementation
 {
     static constexpr void* HAS_REMOTE_WORK_TAG = nullptr;
@@ -104,12 +117,18 @@ struct GrpcContextImplementation
 
     static void work_started(agrpc::GrpcContext& grpc_context) noexcept;
 
+    static void work_started(agrpc::GrpcContext& grpc_context, std::size_t count) noexcept;
+
     static void add_remote_operation(agrpc::GrpcContext& grpc_context, detail::QueueableOperationBase* op) noexcept;
 
     static void add_local_operation(agrpc::GrpcContext& grpc_context, detail::QueueableOperationBase* op) noexcept;
 
     static void add_operation(agrpc::GrpcContext& grpc_context, detail::QueueableOperationBase* op) noexcept;
 
+    static void add_yielded_operation(agrpc::GrpcContext& grpc_context, detail::QueueableOperationBase* op) noexcept;
+
+    static void move_yielded_work_to_local_queue(agrpc::GrpcContext& grpc_context) noexcept;
+
     static void add_notify_when_done_operation(agrpc::GrpcContext& grpc_context,
                                                detail::NotfiyWhenDoneSenderImplementation* implementation) noexcept;
 
@@ -118,6 +137,16 @@ struct GrpcContextImplementation
 
     static void deallocate_notify_when_done_list(agrpc::GrpcContext& grpc_context);
 
+    static void add_parked_operations(agrpc::GrpcContext& grpc_context,
+                                      detail::ParkedOperations* parked_operations) noexcept;
+
+    static void remove_parked_operations(agrpc::GrpcContext& grpc_context,
+                                         detail::ParkedOperations* parked_operations) noexcept;
+
+    static void shutdown_parked_operations(agrpc::GrpcContext& grpc_context);
+
+    [[nodiscard]] static detail::AlarmPool& alarm_pool(agrpc::GrpcContext& grpc_context) noexcept;
+
     static bool handle_next_completion_queue_event(agrpc::GrpcContext& grpc_context, ::gpr_timespec deadline,
                                                    detail::InvokeHandler invoke);
 
@@ -125,6 +154,8 @@ struct GrpcContextImplementation
 
     static const agrpc::GrpcContext* set_thread_local_grpc_context(const agrpc::GrpcContext* grpc_context) noexcept;
 
+    [[nodiscard]] static agrpc::GrpcContext* running_grpc_context() noexcept;
+
     static bool move_remote_work_to_local_queue(agrpc::GrpcContext& grpc_context) noexcept;
 
     static bool process_local_queue(agrpc::GrpcContext& grpc_context, detail::InvokeHandler invoke);
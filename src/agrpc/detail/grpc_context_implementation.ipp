@@ -21,10 +21,14 @@
 #include <agrpc/detail/grpc_context_implementation.hpp>
 #include <agrpc/detail/notify_when_done.hpp>
 #include <agrpc/detail/operation_base.hpp>
+#include <agrpc/detail/parked_operations.hpp>
 #include <agrpc/grpc_context.hpp>
 #include <grpc/support/time.h>
 #include <grpcpp/completion_queue.h>
 
+#include <cstddef>
+#include <limits>
+
 AGRPC_NAMESPACE_BEGIN()
 
 namespace detail
@@ -49,6 +53,14 @@ inline StartWorkAndGuard::StartWorkAndGuard(agrpc::GrpcContext& grpc_context) no
     grpc_context.work_started();
 }
 
+inline YieldOperation::YieldOperation() noexcept : detail::OperationBase(&YieldOperation::do_complete) {}
+
+inline void YieldOperation::do_complete(detail::OperationBase*, detail::OperationResult,
+                                        agrpc::GrpcContext& grpc_context) noexcept
+{
+    GrpcContextImplementation::move_yielded_work_to_local_queue(grpc_context);
+}
+
 inline bool IsGrpcContextStoppedPredicate::operator()(const agrpc::GrpcContext& grpc_context) const noexcept
 {
     return grpc_context.is_stopped();
@@ -70,6 +82,11 @@ inline void GrpcContextImplementation::work_started(agrpc::GrpcContext& grpc_con
     grpc_context.work_started();
 }
 
+inline void GrpcContextImplementation::work_started(agrpc::GrpcContext& grpc_context, std::size_t count) noexcept
+{
+    grpc_context.outstanding_work_.fetch_add(static_cast<long>(count), std::memory_order_relaxed);
+}
+
 inline void GrpcContextImplementation::add_remote_operation(agrpc::GrpcContext& grpc_context,
                                                             detail::QueueableOperationBase* op) noexcept
 {
@@ -98,6 +115,29 @@ inline void GrpcContextImplementation::add_operation(agrpc::GrpcContext& grpc_co
     }
 }
 
+inline void GrpcContextImplementation::add_yielded_operation(agrpc::GrpcContext& grpc_context,
+                                                             detail::QueueableOperationBase* op) noexcept
+{
+    if (!GrpcContextImplementation::running_in_this_thread(grpc_context))
+    {
+        // The remote queue is already signalled through the completion queue
+        GrpcContextImplementation::add_remote_operation(grpc_context, op);
+        return;
+    }
+    if (grpc_context.yielded_work_queue_.empty())
+    {
+        grpc_context.work_started();
+        grpc_context.yield_alarm_.Set(grpc_context.completion_queue_.get(), GrpcContextImplementation::TIME_ZERO,
+                                      &grpc_context.yield_operation_);
+    }
+    grpc_context.yielded_work_queue_.push_back(op);
+}
+
+inline void GrpcContextImplementation::move_yielded_work_to_local_queue(agrpc::GrpcContext& grpc_context) noexcept
+{
+    grpc_context.local_work_queue_.append(std::move(grpc_context.yielded_work_queue_));
+}
+
 inline void GrpcContextImplementation::add_notify_when_done_operation(
     agrpc::GrpcContext& grpc_context, detail::NotfiyWhenDoneSenderImplementation* implementation) noexcept
 {
@@ -120,6 +160,33 @@ inline void GrpcContextImplementation::deallocate_notify_when_done_list(agrpc::G
     }
 }
 
+inline void GrpcContextImplementation::add_parked_operations(agrpc::GrpcContext& grpc_context,
+                                                             detail::ParkedOperations* parked_operations) noexcept
+{
+    grpc_context.parked_operations_list_.push_back(parked_operations);
+}
+
+inline void GrpcContextImplementation::remove_parked_operations(agrpc::GrpcContext& grpc_context,
+                                                                detail::ParkedOperations* parked_operations) noexcept
+{
+    grpc_context.parked_operations_list_.remove(parked_operations);
+}
+
+inline void GrpcContextImplementation::shutdown_parked_operations(agrpc::GrpcContext& grpc_context)
+{
+    auto& list = grpc_context.parked_operations_list_;
+    while (!list.empty())
+    {
+        auto* parked_operations = list.pop_front();
+        parked_operations->shutdown(grpc_context);
+    }
+}
+
+inline detail::AlarmPool& GrpcContextImplementation::alarm_pool(agrpc::GrpcContext& grpc_context) noexcept
+{
+    return grpc_context.alarm_pool_;
+}
+
 inline bool GrpcContextImplementation::running_in_this_thread(const agrpc::GrpcContext& grpc_context) noexcept
 {
     return &grpc_context == detail::thread_local_grpc_context;
@@ -131,6 +198,11 @@ inline const agrpc::GrpcContext* GrpcContextImplementation::set_thread_local_grp
     return std::exchange(detail::thread_local_grpc_context, grpc_context);
 }
 
+inline agrpc::GrpcContext* GrpcContextImplementation::running_grpc_context() noexcept
+{
+    return const_cast<agrpc::GrpcContext*>(detail::thread_local_grpc_context);
+}
+
 inline bool GrpcContextImplementation::move_remote_work_to_local_queue(agrpc::GrpcContext& grpc_context) noexcept
 {
     auto remote_work_queue = grpc_context.remote_work_queue_.try_mark_inactive_or_dequeue_all();
@@ -148,9 +220,22 @@ inline bool GrpcContextImplementation::process_local_queue(agrpc::GrpcContext& g
     bool processed{};
     const auto result =
         detail::InvokeHandler::NO == invoke ? detail::OperationResult::SHUTDOWN_NOT_OK : detail::OperationResult::OK;
+    auto remaining = std::numeric_limits<std::size_t>::max();
+    if (detail::InvokeHandler::YES == invoke && grpc_context.local_work_budget_ != 0)
+    {
+        remaining = grpc_context.local_work_budget_;
+    }
     auto queue{std::move(grpc_context.local_work_queue_)};
     while (!queue.empty())
     {
+        if AGRPC_UNLIKELY (remaining == 0)
+        {
+            // Leave the rest for after the next poll of the completion queue, in front of newly added work
+            queue.append(std::move(grpc_context.local_work_queue_));
+            grpc_context.local_work_queue_ = std::move(queue);
+            break;
+        }
+        --remaining;
         processed = true;
         detail::WorkFinishedOnExit on_exit{grpc_context};
         auto* operation = queue.pop_front();
@@ -30,6 +30,10 @@ AGRPC_NAMESPACE_BEGIN()
 
 namespace detail
 {
+struct UseInitiatingFunction
+{
+};
+
 template <class StopFunction>
 using GrpcInitiateTemplateArgs = void (*)(StopFunction);
 
@@ -50,6 +54,12 @@ auto grpc_initiate_impl(InitiatingFunction&& initiating_function, detail::UseSen
         token.grpc_context_, {static_cast<InitiatingFunction&&>(initiating_function)}, {});
 }
 
+template <class StopFunction, class InitiatingFunction>
+auto grpc_initiate_impl(InitiatingFunction&& initiating_function, detail::UseInitiatingFunction) noexcept
+{
+    return detail::RemoveCrefT<InitiatingFunction>{static_cast<InitiatingFunction&&>(initiating_function)};
+}
+
 template <class InitiatingFunction, class CompletionToken>
 auto grpc_initiate(InitiatingFunction&& initiating_function, CompletionToken&& token)
 {
@@ -70,7 +80,8 @@ auto grpc_initiate_with_payload(InitiatingFunction&& initiating_function, Comple
 
 template <class CompletionToken>
 inline constexpr bool IS_NOTRHOW_GRPC_INITIATE_COMPLETION_TOKEN =
-    std::is_same_v<detail::UseSender, detail::RemoveCrefT<CompletionToken>>;
+    std::is_same_v<detail::UseSender, detail::RemoveCrefT<CompletionToken>> ||
+    std::is_same_v<detail::UseInitiatingFunction, detail::RemoveCrefT<CompletionToken>>;
 }
 
 AGRPC_NAMESPACE_END
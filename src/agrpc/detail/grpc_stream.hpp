@@ -0,0 +1,200 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_DETAIL_GRPC_STREAM_HPP
+#define AGRPC_DETAIL_GRPC_STREAM_HPP
+
+#include <agrpc/detail/asio_forward.hpp>
+#include <agrpc/detail/config.hpp>
+
+#ifdef AGRPC_ASIO_HAS_CANCELLATION_SLOT
+
+#include <agrpc/bind_allocator.hpp>
+#include <agrpc/cancel_safe.hpp>
+#include <agrpc/detail/associated_completion_handler.hpp>
+#include <agrpc/detail/async_initiate.hpp>
+#include <agrpc/detail/tuple.hpp>
+#include <agrpc/detail/utility.hpp>
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+AGRPC_NAMESPACE_BEGIN()
+
+namespace detail
+{
+template <class Stream, class CompletionHandler>
+class GrpcStreamCleanupHandler;
+
+// Shared implementation of BasicGrpcStream and BasicSelector. `Id` is passed to `initiate()` and handed back by
+// `next()` to tell operations apart, it is empty for BasicGrpcStream.
+template <class Executor, std::size_t Capacity, class... Id>
+class GrpcStreamBase
+{
+  private:
+    class CompletionHandler;
+    struct CleanupInitiation;
+
+  protected:
+    using CompletionSignature = void(detail::ErrorCode, Id..., bool);
+
+    template <class Exec>
+    explicit GrpcStreamBase(Exec&& executor) noexcept : executor_(static_cast<Exec&&>(executor))
+    {
+    }
+
+    [[nodiscard]] const Executor& executor() const noexcept { return executor_; }
+
+    [[nodiscard]] std::size_t running_count() const noexcept { return running_.load(std::memory_order_relaxed); }
+
+    // Running operations and results that have not been obtained through `next()` share the `Capacity` slots.
+    [[nodiscard]] bool has_capacity() const noexcept { return running_count() + safe_.completed_count() < Capacity; }
+
+    template <class Allocator, class Function, class... Args>
+    void initiate(std::allocator_arg_t, Allocator allocator, detail::Tuple<Id...> id, Function&& function,
+                  Args&&... args)
+    {
+        add_running();
+        std::invoke(static_cast<Function&&>(function), static_cast<Args&&>(args)...,
+                    agrpc::bind_allocator(allocator, CompletionHandler{*this, id}));
+    }
+
+    template <class Function, class... Args>
+    void initiate(detail::Tuple<Id...> id, Function&& function, Args&&... args)
+    {
+        add_running();
+        std::invoke(static_cast<Function&&>(function), static_cast<Args&&>(args)..., CompletionHandler{*this, id});
+    }
+
+    template <class CompletionToken>
+    auto next(CompletionToken&& token)
+    {
+        return safe_.wait(static_cast<CompletionToken&&>(token));
+    }
+
+    template <class CompletionToken>
+    auto cleanup(CompletionToken&& token)
+    {
+        return asio::async_initiate<CompletionToken, CompletionSignature>(CleanupInitiation{*this}, token);
+    }
+
+  private:
+    template <class, class>
+    friend class detail::GrpcStreamCleanupHandler;
+
+    class CompletionHandler
+    {
+      public:
+        using executor_type = Executor;
+
+        CompletionHandler(GrpcStreamBase& self, detail::Tuple<Id...> id) : self_(self), id_(id) {}
+
+        void operator()(bool ok)
+        {
+            self_.running_.fetch_sub(1, std::memory_order_relaxed);
+            detail::apply(
+                [&](Id... id)
+                {
+                    self_.safe_.token()(id..., ok);
+                },
+                id_);
+        }
+
+        [[nodiscard]] const executor_type& get_executor() const noexcept { return self_.executor_; }
+
+      private:
+        GrpcStreamBase& self_;
+        detail::Tuple<Id...> id_;
+    };
+
+    struct CleanupInitiation
+    {
+        template <class Ch>
+        void operator()(Ch&& ch) const
+        {
+            if (self_.is_pending())
+            {
+                self_.safe_.wait(detail::GrpcStreamCleanupHandler<GrpcStreamBase, detail::RemoveCrefT<Ch>>{
+                    self_, static_cast<Ch&&>(ch)});
+                return;
+            }
+            detail::InitiateImmediateCompletion<CompletionSignature>{}(static_cast<Ch&&>(ch));
+        }
+
+        GrpcStreamBase& self_;
+    };
+
+    [[nodiscard]] bool is_pending() const noexcept { return running_count() != 0 || safe_.completed_count() != 0; }
+
+    void add_running() noexcept
+    {
+        assert(has_capacity() && "More than `Capacity` operations are running or awaiting next()");
+        running_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    Executor executor_;
+    agrpc::CancelSafe<void(Id..., bool), Capacity> safe_;
+    std::atomic_size_t running_{};
+};
+
+// Waits until no operation is running and all results have been obtained, completes with the last one.
+template <class Stream, class CompletionHandler>
+class GrpcStreamCleanupHandler : public detail::AssociatedCompletionHandler<CompletionHandler>
+{
+  private:
+    using Base = detail::AssociatedCompletionHandler<CompletionHandler>;
+
+  public:
+    template <class Ch>
+    GrpcStreamCleanupHandler(Stream& stream, Ch&& ch) : Base(static_cast<Ch&&>(ch)), stream_(stream)
+    {
+    }
+
+    template <class... Args>
+    void operator()(detail::ErrorCode ec, Args... args) &&
+    {
+        if (!ec && stream_.is_pending())
+        {
+            stream_.safe_.wait(static_cast<GrpcStreamCleanupHandler&&>(*this));
+            return;
+        }
+        static_cast<Base&&>(*this)(ec, args...);
+    }
+
+  private:
+    Stream& stream_;
+};
+}
+
+AGRPC_NAMESPACE_END
+
+template <template <class, class> class Associator, class Stream, class CompletionHandler, class DefaultCandidate>
+struct agrpc::asio::associator<Associator, agrpc::detail::GrpcStreamCleanupHandler<Stream, CompletionHandler>,
+                               DefaultCandidate>
+{
+    using type = typename Associator<CompletionHandler, DefaultCandidate>::type;
+
+    static decltype(auto) get(const agrpc::detail::GrpcStreamCleanupHandler<Stream, CompletionHandler>& b,
+                              const DefaultCandidate& c = DefaultCandidate()) noexcept
+    {
+        return Associator<CompletionHandler, DefaultCandidate>::get(b.completion_handler(), c);
+    }
+};
+
+#endif
+
+#endif  // AGRPC_DETAIL_GRPC_STREAM_HPP
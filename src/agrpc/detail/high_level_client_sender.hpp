@@ -58,7 +58,7 @@ struct RPCAccess
 
 struct ClientContextCancellationFunction
 {
-#if !defined(AGRPC_UNIFEX)
+#if !defined(AGRPC_UNIFEX) && !defined(AGRPC_STDEXEC)
     explicit
 #endif
         ClientContextCancellationFunction(grpc::ClientContext& client_context) noexcept
@@ -83,7 +83,7 @@ struct ClientContextCancellationFunction
 
 struct RPCCancellationFunction
 {
-#if !defined(AGRPC_UNIFEX)
+#if !defined(AGRPC_UNIFEX) && !defined(AGRPC_STDEXEC)
     explicit
 #endif
         RPCCancellationFunction(detail::RPCClientContextBase& rpc) noexcept
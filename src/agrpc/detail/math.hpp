@@ -34,6 +34,12 @@ constexpr auto maximum(T a, T b) noexcept
     return (a < b) ? b : a;
 }
 
+template <class T>
+constexpr auto minimum(T a, T b) noexcept
+{
+    return (b < a) ? b : a;
+}
+
 #if __cpp_lib_bitops >= 201907L
 constexpr std::size_t floor_log2(std::size_t x) noexcept
 {
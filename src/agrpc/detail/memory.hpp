@@ -110,6 +110,8 @@ class StackBuffer
 
     [[nodiscard]] void* allocate(std::size_t) noexcept { return buffer_; }
 
+    static void deallocate(void*, std::size_t) noexcept {}
+
   private:
     alignas(std::max_align_t) std::byte buffer_[Size];
 };
@@ -135,9 +137,49 @@ class DelayedBuffer
         }
     }
 
+    static void deallocate(void*, std::size_t) noexcept {}
+
   private:
     std::unique_ptr<MaxAlignedData[]> buffer_;
 };
+
+// Serves one allocation at a time from inline storage. Allocations that are larger or made while the storage is in use
+// are served by the heap.
+template <std::size_t Size>
+class OneShotBuffer
+{
+  public:
+    [[nodiscard]] static constexpr std::size_t max_size() noexcept
+    {
+        return std::numeric_limits<std::size_t>::max() - (MAX_ALIGN - 1);
+    }
+
+    [[nodiscard]] void* allocate(std::size_t size)
+    {
+        if AGRPC_LIKELY (!in_use_ && size <= Size)
+        {
+            in_use_ = true;
+            return buffer_;
+        }
+        return detail::MaxAlignAllocator::allocate(size);
+    }
+
+    void deallocate(void* p, std::size_t size) noexcept
+    {
+        if AGRPC_LIKELY (p == buffer_)
+        {
+            in_use_ = false;
+        }
+        else
+        {
+            detail::MaxAlignAllocator::deallocate(p, size);
+        }
+    }
+
+  private:
+    alignas(std::max_align_t) std::byte buffer_[Size];
+    bool in_use_{};
+};
 }
 
 AGRPC_NAMESPACE_END
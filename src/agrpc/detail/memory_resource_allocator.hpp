@@ -49,6 +49,8 @@ class MemoryResourceAllocator
 
     void deallocate(T* p, std::size_t n) noexcept { resource_->deallocate(p, n * sizeof(T), alignof(T)); }
 
+    [[nodiscard]] Resource* resource() const noexcept { return resource_; }
+
     template <class U>
     friend bool operator==(const MemoryResourceAllocator& lhs,
                            const detail::MemoryResourceAllocator<U, Resource>& rhs) noexcept
@@ -0,0 +1,163 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_DETAIL_MULTIPLEXER_HPP
+#define AGRPC_DETAIL_MULTIPLEXER_HPP
+
+#include <agrpc/detail/asio_forward.hpp>
+#include <agrpc/detail/config.hpp>
+
+#if defined(AGRPC_STANDALONE_ASIO) || defined(AGRPC_BOOST_ASIO)
+
+#include <agrpc/detail/allocate.hpp>
+#include <agrpc/detail/intrusive_list.hpp>
+#include <agrpc/detail/intrusive_list_hook.hpp>
+#include <agrpc/detail/work_tracking_completion_handler.hpp>
+#include <grpcpp/support/status.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+AGRPC_NAMESPACE_BEGIN()
+
+namespace detail
+{
+enum class ClientMultiplexerStreamState
+{
+    IDLE,
+    STARTING,
+    RUNNING,
+    FINISHING
+};
+
+template <class Response>
+class ClientMultiplexerRequestBase : public detail::IntrusiveListHook<ClientMultiplexerRequestBase<Response>>
+{
+  protected:
+    using Complete = void (*)(ClientMultiplexerRequestBase*, grpc::Status&&);
+
+    ClientMultiplexerRequestBase(Complete complete, Response& response, std::uint64_t id,
+                                 std::chrono::system_clock::time_point deadline, std::size_t stream) noexcept
+        : response_(response), id_(id), deadline_(deadline), stream_(stream), complete_(complete)
+    {
+    }
+
+  public:
+    void complete(grpc::Status&& status) { complete_(this, static_cast<grpc::Status&&>(status)); }
+
+    Response& response_;
+    std::uint64_t id_;
+    std::chrono::system_clock::time_point deadline_;
+    std::size_t stream_;
+
+  private:
+    Complete complete_;
+};
+
+template <class Response, class CompletionHandler>
+class ClientMultiplexerRequest : public detail::ClientMultiplexerRequestBase<Response>
+{
+  private:
+    using Base = detail::ClientMultiplexerRequestBase<Response>;
+    using WorkTrackingCompletionHandler = detail::WorkTrackingCompletionHandler<CompletionHandler>;
+
+  public:
+    template <class Ch>
+    ClientMultiplexerRequest(Ch&& ch, Response& response, std::uint64_t id,
+                             std::chrono::system_clock::time_point deadline, std::size_t stream)
+        : Base(&do_complete, response, id, deadline, stream), completion_handler_(static_cast<Ch&&>(ch))
+    {
+    }
+
+  private:
+    static void do_complete(Base* base, grpc::Status&& status)
+    {
+        auto* const self = static_cast<ClientMultiplexerRequest*>(base);
+        WorkTrackingCompletionHandler local_completion_handler{
+            static_cast<WorkTrackingCompletionHandler&&>(self->completion_handler_)};
+        detail::destroy_deallocate(self, local_completion_handler.get_allocator());
+        static_cast<WorkTrackingCompletionHandler&&>(local_completion_handler)(static_cast<grpc::Status&&>(status));
+    }
+
+    WorkTrackingCompletionHandler completion_handler_;
+};
+
+template <class Request, class Responder>
+class ServerDemultiplexerRunBase
+{
+  protected:
+    using OnRequest = void (*)(ServerDemultiplexerRunBase*, Request&&, Responder&&);
+    using Complete = void (*)(ServerDemultiplexerRunBase*, bool);
+
+    ServerDemultiplexerRunBase(OnRequest on_request, Complete complete) noexcept
+        : on_request_(on_request), complete_(complete)
+    {
+    }
+
+  public:
+    void on_request(Request&& request, Responder&& responder)
+    {
+        on_request_(this, static_cast<Request&&>(request), static_cast<Responder&&>(responder));
+    }
+
+    void complete(bool ok) { complete_(this, ok); }
+
+  private:
+    OnRequest on_request_;
+    Complete complete_;
+};
+
+template <class Request, class Responder, class RequestHandler, class CompletionHandler>
+class ServerDemultiplexerRun : public detail::ServerDemultiplexerRunBase<Request, Responder>
+{
+  private:
+    using Base = detail::ServerDemultiplexerRunBase<Request, Responder>;
+    using WorkTrackingCompletionHandler = detail::WorkTrackingCompletionHandler<CompletionHandler>;
+
+  public:
+    template <class Rh, class Ch>
+    ServerDemultiplexerRun(Rh&& request_handler, Ch&& ch)
+        : Base(&do_on_request, &do_complete),
+          request_handler_(static_cast<Rh&&>(request_handler)),
+          completion_handler_(static_cast<Ch&&>(ch))
+    {
+    }
+
+  private:
+    static void do_on_request(Base* base, Request&& request, Responder&& responder)
+    {
+        static_cast<ServerDemultiplexerRun*>(base)->request_handler_(static_cast<Request&&>(request),
+                                                                     static_cast<Responder&&>(responder));
+    }
+
+    static void do_complete(Base* base, bool ok)
+    {
+        auto* const self = static_cast<ServerDemultiplexerRun*>(base);
+        WorkTrackingCompletionHandler local_completion_handler{
+            static_cast<WorkTrackingCompletionHandler&&>(self->completion_handler_)};
+        detail::destroy_deallocate(self, local_completion_handler.get_allocator());
+        static_cast<WorkTrackingCompletionHandler&&>(local_completion_handler)(ok);
+    }
+
+    RequestHandler request_handler_;
+    WorkTrackingCompletionHandler completion_handler_;
+};
+}
+
+AGRPC_NAMESPACE_END
+
+#endif
+
+#endif  // AGRPC_DETAIL_MULTIPLEXER_HPP
@@ -0,0 +1,202 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef AGRPC_DETAIL_OFFLOAD_HPP
+#define AGRPC_DETAIL_OFFLOAD_HPP
+
+#include <agrpc/detail/asio_association.hpp>
+#include <agrpc/detail/asio_forward.hpp>
+#include <agrpc/detail/buffer_allocator.hpp>
+#include <agrpc/detail/config.hpp>
+#include <agrpc/detail/grpc_context_implementation.hpp>
+#include <agrpc/detail/memory.hpp>
+#include <agrpc/detail/operation_base.hpp>
+#include <agrpc/detail/sender_implementation.hpp>
+#include <agrpc/detail/utility.hpp>
+#include <agrpc/grpc_context.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <optional>
+#include <type_traits>
+
+#if defined(AGRPC_STANDALONE_ASIO) || defined(AGRPC_BOOST_ASIO)
+
+#ifdef AGRPC_STANDALONE_ASIO
+#include <asio/error.hpp>
+
+#include <system_error>
+#else
+#include <boost/asio/error.hpp>
+#include <boost/system/system_error.hpp>
+#endif
+
+AGRPC_NAMESPACE_BEGIN()
+
+namespace detail
+{
+#ifdef AGRPC_STANDALONE_ASIO
+using OffloadSystemError = std::system_error;
+#else
+using OffloadSystemError = boost::system::system_error;
+#endif
+
+template <class Function>
+using OffloadResultT = detail::RemoveCrefT<std::invoke_result_t<Function&>>;
+
+template <class Result>
+struct OffloadSignature
+{
+    using Type = void(std::exception_ptr, Result);
+};
+
+template <>
+struct OffloadSignature<void>
+{
+    using Type = void(std::exception_ptr);
+};
+
+// The executor's own operation that wraps the submitted function object, e.g. that of an `asio::thread_pool`, fits into
+// this many bytes. It is stored within the offload operation so that only one allocation is made.
+inline constexpr std::size_t OFFLOAD_EXECUTOR_BUFFER_SIZE = 8 * sizeof(void*);
+
+struct OffloadCancellationFunction
+{
+    std::atomic_bool& cancelled_;
+
+#if !defined(AGRPC_UNIFEX) && !defined(AGRPC_STDEXEC)
+    explicit
+#endif
+        OffloadCancellationFunction(std::atomic_bool& cancelled) noexcept
+        : cancelled_(cancelled)
+    {
+    }
+
+    void operator()() const noexcept { cancelled_.store(true, std::memory_order_relaxed); }
+
+#ifdef AGRPC_ASIO_HAS_CANCELLATION_SLOT
+    void operator()(asio::cancellation_type type) const noexcept
+    {
+        if (static_cast<bool>(type & asio::cancellation_type::all))
+        {
+            operator()();
+        }
+    }
+#endif
+};
+
+template <class Executor, class Function>
+class OffloadSenderImplementation
+{
+  private:
+    using Result = detail::OffloadResultT<Function>;
+    using Buffer = detail::OneShotBuffer<detail::OFFLOAD_EXECUTOR_BUFFER_SIZE>;
+
+    static_assert(std::is_void_v<Result> || std::is_default_constructible_v<Result>,
+                  "The result type of an offloaded function must be default constructible");
+
+    struct RunOnExecutor
+    {
+        void operator()() const noexcept { self_.run(); }
+
+        OffloadSenderImplementation& self_;
+    };
+
+  public:
+    static constexpr auto TYPE = detail::SenderImplementationType::NO_ARG;
+
+    using Signature = typename detail::OffloadSignature<Result>::Type;
+    using StopFunction = detail::OffloadCancellationFunction;
+    using Initiation = Executor;
+
+    template <class F>
+    explicit OffloadSenderImplementation(F&& function) : function_(static_cast<F&&>(function))
+    {
+    }
+
+    OffloadSenderImplementation(OffloadSenderImplementation&& other) : function_(static_cast<Function&&>(other.function_))
+    {
+    }
+
+    std::atomic_bool& stop_function_arg(const Executor&) noexcept { return cancelled_; }
+
+    template <class Init>
+    void initiate(Init init, const Executor& executor)
+    {
+        grpc_context_ = &init.grpc_context();
+        operation_ = init.self();
+        detail::post_with_allocator(executor, RunOnExecutor{*this}, detail::BufferAllocator<std::byte, Buffer>{buffer_});
+    }
+
+    template <class OnDone>
+    void done(OnDone on_done)
+    {
+        if constexpr (std::is_void_v<Result>)
+        {
+            on_done(static_cast<std::exception_ptr&&>(exception_));
+        }
+        else if (result_)
+        {
+            on_done(std::exception_ptr{}, static_cast<Result&&>(*result_));
+        }
+        else
+        {
+            on_done(static_cast<std::exception_ptr&&>(exception_), Result{});
+        }
+    }
+
+  private:
+    void run() noexcept
+    {
+        // Cancellation can only prevent the function from starting, once it runs it runs to completion.
+        if (cancelled_.load(std::memory_order_relaxed))
+        {
+            exception_ = std::make_exception_ptr(detail::OffloadSystemError{asio::error::operation_aborted});
+        }
+        else
+        {
+            AGRPC_TRY
+            {
+                if constexpr (std::is_void_v<Result>)
+                {
+                    std::invoke(function_);
+                }
+                else
+                {
+                    result_.emplace(std::invoke(function_));
+                }
+            }
+            AGRPC_CATCH(...) { exception_ = std::current_exception(); }
+        }
+        detail::GrpcContextImplementation::add_operation(*grpc_context_, operation_);
+    }
+
+    Function function_;
+    agrpc::GrpcContext* grpc_context_;
+    detail::QueueableOperationBase* operation_;
+    std::optional<detail::ConditionalT<std::is_void_v<Result>, detail::Empty, Result>> result_;
+    std::exception_ptr exception_;
+    std::atomic_bool cancelled_{};
+    Buffer buffer_;
+};
+}
+
+AGRPC_NAMESPACE_END
+
+#endif
+
+#endif  // AGRPC_DETAIL_OFFLOAD_HPP
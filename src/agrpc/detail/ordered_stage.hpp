@@ -0,0 +1,283 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_DETAIL_ORDERED_STAGE_HPP
+#define AGRPC_DETAIL_ORDERED_STAGE_HPP
+
+#include <agrpc/detail/config.hpp>
+#include <agrpc/detail/grpc_context_implementation.hpp>
+#include <agrpc/detail/operation_base.hpp>
+#include <agrpc/detail/parked_operations.hpp>
+#include <agrpc/detail/parking_slot.hpp>
+#include <agrpc/detail/sender_implementation.hpp>
+#include <agrpc/detail/utility.hpp>
+#include <agrpc/grpc_context.hpp>
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <utility>
+
+AGRPC_NAMESPACE_BEGIN()
+
+namespace detail
+{
+template <class Result>
+struct OrderedStageSlot
+{
+    std::optional<Result> result_;
+    std::exception_ptr exception_;
+    std::atomic_bool ready_{};
+};
+
+// Reorder buffer of `max_in_flight` slots. Sequence numbers and everything but the slots' results and ready flags are
+// only accessed from the GrpcContext's thread. A worker exclusively owns the slot of its job until it sets the ready
+// flag. While a submit is waiting, this object is added to the GrpcContext so that it is destroyed when it shuts down.
+template <class Result>
+class OrderedStageState : public detail::ParkedOperations
+{
+  public:
+    OrderedStageState(agrpc::GrpcContext& grpc_context, std::size_t max_in_flight)
+        : detail::ParkedOperations(&OrderedStageState::do_shutdown),
+          grpc_context_(grpc_context),
+          slots_(std::make_unique<detail::OrderedStageSlot<Result>[]>(max_in_flight)),
+          max_in_flight_(max_in_flight)
+    {
+        assert(max_in_flight > 0 && "At least one request must be allowed in flight");
+    }
+
+    OrderedStageState(const OrderedStageState&) = delete;
+    OrderedStageState(OrderedStageState&&) = delete;
+    OrderedStageState& operator=(const OrderedStageState&) = delete;
+    OrderedStageState& operator=(OrderedStageState&&) = delete;
+
+    ~OrderedStageState() noexcept
+    {
+        assert(waiting_submit_ == nullptr &&
+               "All operations must have completed before the stage is destroyed, see close()");
+    }
+
+    [[nodiscard]] agrpc::GrpcContext& grpc_context() const noexcept { return grpc_context_; }
+
+    [[nodiscard]] std::size_t max_in_flight() const noexcept { return max_in_flight_; }
+
+    [[nodiscard]] std::size_t size() const noexcept { return tail_ - head_; }
+
+    [[nodiscard]] bool is_closed() const noexcept { return closed_; }
+
+    [[nodiscard]] bool has_capacity() const noexcept { return size() < max_in_flight_; }
+
+    [[nodiscard]] detail::OrderedStageSlot<Result>& acquire_slot() noexcept
+    {
+        assert(has_capacity() && !closed_);
+        auto& slot = slots_[tail_ % max_in_flight_];
+        ++tail_;
+        return slot;
+    }
+
+    [[nodiscard]] bool is_head_ready() const noexcept
+    {
+        return size() != 0 && slots_[head_ % max_in_flight_].ready_.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] bool is_done() const noexcept { return closed_ && size() == 0; }
+
+    // The result is default constructed if the function has exited with an exception.
+    [[nodiscard]] Result pop_head(std::exception_ptr& exception)
+    {
+        auto& slot = slots_[head_ % max_in_flight_];
+        exception = std::exchange(slot.exception_, nullptr);
+        Result result{slot.result_ ? static_cast<Result&&>(*slot.result_) : Result{}};
+        slot.result_.reset();
+        slot.ready_.store(false, std::memory_order_relaxed);
+        ++head_;
+        notify_submit();
+        return result;
+    }
+
+    void park_submit(detail::QueueableOperationBase* operation) noexcept
+    {
+        assert(waiting_submit_ == nullptr && "Only one submit may be outstanding at a time");
+        grpc_context_.work_started();
+        waiting_submit_ = operation;
+        detail::GrpcContextImplementation::add_parked_operations(grpc_context_, this);
+    }
+
+    // Returns false if the head became ready while parking, in which case the operation has not been parked.
+    [[nodiscard]] bool try_park_next(detail::QueueableOperationBase* operation) noexcept
+    {
+        return waiting_next_.try_park(grpc_context_, operation,
+                                      [&]
+                                      {
+                                          return is_head_ready();
+                                      });
+    }
+
+    void unpark_next(detail::QueueableOperationBase* operation) noexcept { waiting_next_.unpark(operation); }
+
+    // Called by workers
+    void complete(detail::OrderedStageSlot<Result>& slot) noexcept
+    {
+        waiting_next_.notify(grpc_context_,
+                             [&]
+                             {
+                                 slot.ready_.store(true, std::memory_order_release);
+                                 return true;
+                             });
+    }
+
+    void close() noexcept
+    {
+        waiting_next_.notify(grpc_context_,
+                             [&]
+                             {
+                                 closed_ = true;
+                                 return true;
+                             });
+        notify_submit();
+    }
+
+  private:
+    void notify_submit() noexcept
+    {
+        if (auto* const operation = std::exchange(waiting_submit_, nullptr))
+        {
+            detail::GrpcContextImplementation::remove_parked_operations(grpc_context_, this);
+            detail::GrpcContextImplementation::add_local_operation(grpc_context_, operation);
+        }
+    }
+
+    static void do_shutdown(detail::ParkedOperations* parked_operations, agrpc::GrpcContext& grpc_context)
+    {
+        auto& self = *static_cast<OrderedStageState*>(parked_operations);
+        if (auto* const operation = std::exchange(self.waiting_submit_, nullptr))
+        {
+            operation->complete(detail::OperationResult::SHUTDOWN_NOT_OK, grpc_context);
+        }
+    }
+
+    agrpc::GrpcContext& grpc_context_;
+    std::unique_ptr<detail::OrderedStageSlot<Result>[]> slots_;
+    std::size_t max_in_flight_;
+    std::size_t head_{};
+    std::size_t tail_{};
+    detail::QueueableOperationBase* waiting_submit_{};
+    bool closed_{};
+    detail::ParkingSlot waiting_next_;
+};
+
+template <class Stage, class Function>
+class OrderedStageSubmitSenderImplementation
+{
+  public:
+    static constexpr auto TYPE = detail::SenderImplementationType::NO_ARG;
+
+    using Signature = void(bool);
+    using StopFunction = detail::Empty;
+    using Initiation = detail::Empty;
+
+    template <class F>
+    OrderedStageSubmitSenderImplementation(Stage& stage, F&& function)
+        : stage_(stage), function_(static_cast<F&&>(function))
+    {
+    }
+
+    template <class Init>
+    void initiate(Init init, const Initiation&)
+    {
+        // Complete on the GrpcContext so that the sequence numbers are only ever accessed from its thread.
+        detail::GrpcContextImplementation::add_operation(init.grpc_context(), init.self());
+    }
+
+    template <class OnDone>
+    void done(OnDone on_done)
+    {
+        auto& state = stage_.state_;
+        if (state.is_closed())
+        {
+            on_done(false);
+            return;
+        }
+        if (state.has_capacity())
+        {
+            stage_.start(state.acquire_slot(), static_cast<Function&&>(function_));
+            on_done(true);
+            return;
+        }
+        // Capacity is only ever made by next() and close() which run on the GrpcContext's thread as well.
+        state.park_submit(on_done.self());
+    }
+
+  private:
+    Stage& stage_;
+    Function function_;
+};
+
+template <class Result>
+class OrderedStageNextSenderImplementation
+{
+  public:
+    static constexpr auto TYPE = detail::SenderImplementationType::NO_ARG;
+
+    using Signature = void(std::exception_ptr, bool, Result);
+    using StopFunction = detail::Empty;
+    using Initiation = detail::Empty;
+
+    explicit OrderedStageNextSenderImplementation(detail::OrderedStageState<Result>& state) noexcept : state_(state)
+    {
+    }
+
+    template <class Init>
+    void initiate(Init init, const Initiation&)
+    {
+        detail::GrpcContextImplementation::add_operation(init.grpc_context(), init.self());
+    }
+
+    template <class OnDone>
+    void done(OnDone on_done)
+    {
+        state_.unpark_next(on_done.self());
+        while (true)
+        {
+            if (state_.is_head_ready())
+            {
+                std::exception_ptr exception;
+                auto result = state_.pop_head(exception);
+                on_done(static_cast<std::exception_ptr&&>(exception), true, static_cast<Result&&>(result));
+                return;
+            }
+            if (state_.is_done())
+            {
+                on_done(std::exception_ptr{}, false, Result{});
+                return;
+            }
+            // Woken up by every completing job, re-parks until the oldest one has completed.
+            if (state_.try_park_next(on_done.self()))
+            {
+                return;
+            }
+        }
+    }
+
+  private:
+    detail::OrderedStageState<Result>& state_;
+};
+}
+
+AGRPC_NAMESPACE_END
+
+#endif  // AGRPC_DETAIL_ORDERED_STAGE_HPP
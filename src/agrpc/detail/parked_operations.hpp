@@ -0,0 +1,50 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_DETAIL_PARKED_OPERATIONS_HPP
+#define AGRPC_DETAIL_PARKED_OPERATIONS_HPP
+
+#include <agrpc/detail/config.hpp>
+#include <agrpc/detail/forward.hpp>
+#include <agrpc/detail/intrusive_list_hook.hpp>
+
+AGRPC_NAMESPACE_BEGIN()
+
+namespace detail
+{
+class ParkedOperations;
+
+using ParkedOperationsOnShutdown = void (*)(detail::ParkedOperations*, agrpc::GrpcContext&);
+
+// Owner of operations that wait for another operation instead of the completion queue, e.g. a receive on a channel.
+// It is added to the GrpcContext while it holds any such operation, so that they are destroyed when the GrpcContext
+// shuts down. Only accessed from the GrpcContext's thread.
+class ParkedOperations : public detail::IntrusiveListHook<ParkedOperations>
+{
+  public:
+    // Must destroy all parked operations without invoking their completion handlers. The GrpcContext has already
+    // removed this object from its list.
+    void shutdown(agrpc::GrpcContext& grpc_context) { on_shutdown_(this, grpc_context); }
+
+  protected:
+    explicit ParkedOperations(ParkedOperationsOnShutdown on_shutdown) noexcept : on_shutdown_(on_shutdown) {}
+
+  private:
+    ParkedOperationsOnShutdown on_shutdown_;
+};
+}
+
+AGRPC_NAMESPACE_END
+
+#endif  // AGRPC_DETAIL_PARKED_OPERATIONS_HPP
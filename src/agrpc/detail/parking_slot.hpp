@@ -0,0 +1,171 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_DETAIL_PARKING_SLOT_HPP
+#define AGRPC_DETAIL_PARKING_SLOT_HPP
+
+#include <agrpc/detail/config.hpp>
+#include <agrpc/detail/grpc_context_implementation.hpp>
+#include <agrpc/detail/operation_base.hpp>
+#include <agrpc/detail/parked_operations.hpp>
+#include <agrpc/detail/utility.hpp>
+#include <agrpc/grpc_context.hpp>
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+
+AGRPC_NAMESPACE_BEGIN()
+
+namespace detail
+{
+// Lets one operation wait on the GrpcContext's thread for a condition that is made true by other threads, without
+// using a mutex.
+//
+// The waiting side stores its operation, issues a fence and then re-checks the condition. The notifying side publishes
+// its change, issues a fence and then takes the operation, if any. Either the waiting side observes the change or the
+// notifying side observes the operation. Whoever takes the operation out of the slot submits it or, in case of the
+// waiting side, does not park after all.
+//
+// The waiting side may observe the change before the notifying side has finished looking at the slot. It may then
+// complete and destroy the slot's owner. The atomics therefore live in a separately allocated block that is shared
+// with the notifiers, whoever leaves last deallocates it.
+//
+// A parked operation is destroyed when the GrpcContext shuts down. When it is resumed it must call `unpark()` before
+// completing or parking again. An operation that has been taken by a notifier but is destroyed by the shutdown of the
+// GrpcContext is never resumed, the slot is then unlinked by `do_shutdown` or, if its owner is destroyed first, by the
+// destructor.
+class ParkingSlot : public detail::ParkedOperations
+{
+  private:
+    struct Shared
+    {
+        std::atomic<detail::QueueableOperationBase*> waiter_{};
+        std::atomic_size_t references_{1};
+    };
+
+  public:
+    ParkingSlot() : detail::ParkedOperations(&ParkingSlot::do_shutdown), shared_(new Shared) {}
+
+    ParkingSlot(const ParkingSlot&) = delete;
+    ParkingSlot(ParkingSlot&&) = delete;
+    ParkingSlot& operator=(const ParkingSlot&) = delete;
+    ParkingSlot& operator=(ParkingSlot&&) = delete;
+
+    ~ParkingSlot() noexcept
+    {
+        assert(shared_->waiter_.load(std::memory_order_relaxed) == nullptr &&
+               "All operations must have completed before the owner of a ParkingSlot is destroyed");
+        if (parked_ != nullptr)
+        {
+            // The operation has been taken by a notifier and was destroyed during shutdown without being resumed.
+            detail::GrpcContextImplementation::remove_parked_operations(*grpc_context_, this);
+        }
+        ParkingSlot::release(shared_);
+    }
+
+    // Must be called from the GrpcContext's thread. Returns false if `is_ready` became true while parking, in which
+    // case the operation has not been parked.
+    template <class IsReady>
+    [[nodiscard]] bool try_park(agrpc::GrpcContext& grpc_context, detail::QueueableOperationBase* operation,
+                                IsReady is_ready) noexcept
+    {
+        auto& waiter = shared_->waiter_;
+        assert(waiter.load(std::memory_order_relaxed) == nullptr && "Only one operation may be parked at a time");
+        grpc_context.work_started();
+        waiter.store(operation, std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (is_ready() && waiter.exchange(nullptr, std::memory_order_acq_rel) == operation)
+        {
+            grpc_context.work_finished();
+            return false;
+        }
+        // Either parked or a notifier has already taken the operation and will submit it to the GrpcContext.
+        if (parked_ == nullptr)
+        {
+            grpc_context_ = &grpc_context;
+            detail::GrpcContextImplementation::add_parked_operations(grpc_context, this);
+        }
+        parked_ = operation;
+        return true;
+    }
+
+    // Must be called from the GrpcContext's thread by every operation that uses this slot when it is resumed.
+    void unpark(detail::QueueableOperationBase* operation) noexcept
+    {
+        if (parked_ == operation)
+        {
+            parked_ = nullptr;
+            detail::GrpcContextImplementation::remove_parked_operations(*grpc_context_, this);
+        }
+    }
+
+    // May be called from any thread. `publish` must make its change visible with at least release semantics and
+    // returns whether a change has been made. The owner of this slot is not accessed after `publish` has returned.
+    template <class Publish>
+    bool notify(agrpc::GrpcContext& grpc_context, Publish publish)
+    {
+        auto* const shared = shared_;
+        shared->references_.fetch_add(1, std::memory_order_relaxed);
+        detail::ScopeGuard guard{[&]
+                                 {
+                                     ParkingSlot::release(shared);
+                                 }};
+        if (!publish())
+        {
+            return false;
+        }
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto& waiter = shared->waiter_;
+        if (waiter.load(std::memory_order_relaxed) == nullptr)
+        {
+            return true;
+        }
+        if (auto* const operation = waiter.exchange(nullptr, std::memory_order_acq_rel))
+        {
+            detail::GrpcContextImplementation::add_operation(grpc_context, operation);
+        }
+        return true;
+    }
+
+  private:
+    static void do_shutdown(detail::ParkedOperations* parked_operations, agrpc::GrpcContext& grpc_context)
+    {
+        auto& self = *static_cast<ParkingSlot*>(parked_operations);
+        self.parked_ = nullptr;
+        if (auto* const operation = self.shared_->waiter_.exchange(nullptr, std::memory_order_acquire))
+        {
+            operation->complete(detail::OperationResult::SHUTDOWN_NOT_OK, grpc_context);
+        }
+    }
+
+    static void release(Shared* shared) noexcept
+    {
+        if (shared->references_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            delete shared;
+        }
+    }
+
+    Shared* shared_;
+
+    // Only accessed from the GrpcContext's thread
+    agrpc::GrpcContext* grpc_context_{};
+    detail::QueueableOperationBase* parked_{};
+};
+}
+
+AGRPC_NAMESPACE_END
+
+#endif  // AGRPC_DETAIL_PARKING_SLOT_HPP
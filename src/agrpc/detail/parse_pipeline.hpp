@@ -0,0 +1,209 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_DETAIL_PARSE_PIPELINE_HPP
+#define AGRPC_DETAIL_PARSE_PIPELINE_HPP
+
+#include <agrpc/detail/config.hpp>
+#include <agrpc/detail/grpc_context_implementation.hpp>
+#include <agrpc/detail/operation_base.hpp>
+#include <agrpc/detail/parking_slot.hpp>
+#include <agrpc/detail/sender_implementation.hpp>
+#include <agrpc/detail/utility.hpp>
+#include <agrpc/grpc_context.hpp>
+#include <grpcpp/support/byte_buffer.h>
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+
+AGRPC_NAMESPACE_BEGIN()
+
+namespace detail
+{
+class ParsePipelineState
+{
+  public:
+    ParsePipelineState(agrpc::GrpcContext& grpc_context, std::size_t max_depth) noexcept
+        : grpc_context_(grpc_context), max_depth_(max_depth)
+    {
+        assert(max_depth > 0 && "The depth of the pipeline must be at least one");
+    }
+
+    ParsePipelineState(const ParsePipelineState&) = delete;
+    ParsePipelineState(ParsePipelineState&&) = delete;
+    ParsePipelineState& operator=(const ParsePipelineState&) = delete;
+    ParsePipelineState& operator=(ParsePipelineState&&) = delete;
+
+    ~ParsePipelineState() noexcept
+    {
+        assert(in_flight_.load(std::memory_order_relaxed) == 0 &&
+               "All messages must have been processed before the pipeline is destroyed, see wait_idle()");
+    }
+
+    [[nodiscard]] agrpc::GrpcContext& grpc_context() const noexcept { return grpc_context_; }
+
+    [[nodiscard]] std::size_t max_depth() const noexcept { return max_depth_; }
+
+    [[nodiscard]] std::size_t in_flight() const noexcept { return in_flight_.load(std::memory_order_acquire); }
+
+    [[nodiscard]] bool has_capacity() const noexcept { return in_flight() < max_depth_; }
+
+    [[nodiscard]] bool is_idle() const noexcept { return in_flight() == 0; }
+
+    [[nodiscard]] bool try_acquire() noexcept
+    {
+        auto in_flight = in_flight_.load(std::memory_order_relaxed);
+        while (in_flight < max_depth_)
+        {
+            if (in_flight_.compare_exchange_weak(in_flight, in_flight + 1, std::memory_order_relaxed))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void release() noexcept
+    {
+        waiter_.notify(grpc_context_,
+                       [&]
+                       {
+                           // Makes the worker's side effects visible to whoever observes the decremented count.
+                           in_flight_.fetch_sub(1, std::memory_order_acq_rel);
+                           return true;
+                       });
+    }
+
+    // Returns false if `is_ready` became true while parking, in which case the operation has not been parked.
+    template <class IsReady>
+    [[nodiscard]] bool try_park(detail::QueueableOperationBase* operation, IsReady is_ready) noexcept
+    {
+        return waiter_.try_park(grpc_context_, operation, is_ready);
+    }
+
+    void unpark(detail::QueueableOperationBase* operation) noexcept { waiter_.unpark(operation); }
+
+  private:
+    agrpc::GrpcContext& grpc_context_;
+    std::size_t max_depth_;
+    std::atomic_size_t in_flight_{};
+    detail::ParkingSlot waiter_;
+};
+
+template <class Pipeline>
+class ParsePipelineSubmitSenderImplementation
+{
+  public:
+    static constexpr auto TYPE = detail::SenderImplementationType::NO_ARG;
+
+    using Signature = void();
+    using StopFunction = detail::Empty;
+    using Initiation = detail::Empty;
+
+    ParsePipelineSubmitSenderImplementation(Pipeline& pipeline, grpc::ByteBuffer& buffer) noexcept
+        : pipeline_(pipeline)
+    {
+        buffer_.Swap(&buffer);
+    }
+
+    ParsePipelineSubmitSenderImplementation(ParsePipelineSubmitSenderImplementation&& other) noexcept
+        : pipeline_(other.pipeline_)
+    {
+        buffer_.Swap(&other.buffer_);
+    }
+
+    template <class Init>
+    void initiate(Init init, const Initiation&)
+    {
+        detail::GrpcContextImplementation::add_operation(init.grpc_context(), init.self());
+    }
+
+    template <class OnDone>
+    void done(OnDone on_done)
+    {
+        auto& state = pipeline_.state_;
+        state.unpark(on_done.self());
+        while (true)
+        {
+            if (state.try_acquire())
+            {
+                pipeline_.start(buffer_);
+                on_done();
+                return;
+            }
+            if (state.try_park(on_done.self(),
+                               [&]
+                               {
+                                   return state.has_capacity();
+                               }))
+            {
+                return;
+            }
+        }
+    }
+
+  private:
+    Pipeline& pipeline_;
+    grpc::ByteBuffer buffer_;
+};
+
+class ParsePipelineWaitIdleSenderImplementation
+{
+  public:
+    static constexpr auto TYPE = detail::SenderImplementationType::NO_ARG;
+
+    using Signature = void();
+    using StopFunction = detail::Empty;
+    using Initiation = detail::Empty;
+
+    explicit ParsePipelineWaitIdleSenderImplementation(detail::ParsePipelineState& state) noexcept : state_(state) {}
+
+    template <class Init>
+    void initiate(Init init, const Initiation&)
+    {
+        detail::GrpcContextImplementation::add_operation(init.grpc_context(), init.self());
+    }
+
+    template <class OnDone>
+    void done(OnDone on_done)
+    {
+        state_.unpark(on_done.self());
+        while (true)
+        {
+            if (state_.is_idle())
+            {
+                on_done();
+                return;
+            }
+            // Woken up by every completing message, re-parks until the last one has been processed.
+            if (state_.try_park(on_done.self(),
+                                [&]
+                                {
+                                    return state_.is_idle();
+                                }))
+            {
+                return;
+            }
+        }
+    }
+
+  private:
+    detail::ParsePipelineState& state_;
+};
+}
+
+AGRPC_NAMESPACE_END
+
+#endif  // AGRPC_DETAIL_PARSE_PIPELINE_HPP
@@ -218,6 +218,7 @@ class PoolResource
     {
         if (bytes > LARGEST_POOL_BLOCK_SIZE)
         {
+            ++upstream_allocations_;
             return oversized_list_.allocate(bytes);
         }
         const auto pool_idx = detail::get_pool_index(bytes);
@@ -225,6 +226,7 @@ class PoolResource
         void* p = pool.allocate_block();
         if (p == nullptr)
         {
+            ++upstream_allocations_;
             pool.replenish(detail::get_block_size_of_pool_at(pool_idx));
             p = pool.allocate_block();
         }
@@ -250,11 +252,24 @@ class PoolResource
         }
     }
 
+    // Largest allocation that is served by a pool, larger ones always go to the upstream allocator
+    [[nodiscard]] static constexpr std::size_t max_pooled_size() noexcept { return LARGEST_POOL_BLOCK_SIZE; }
+
+    // Number of bytes that are reserved for an allocation of the specified size, it may use all of them
+    [[nodiscard]] static constexpr std::size_t reserved_size(std::size_t bytes) noexcept
+    {
+        return bytes > LARGEST_POOL_BLOCK_SIZE ? bytes : detail::get_block_size_of_pool_at(detail::get_pool_index(bytes));
+    }
+
+    // Number of allocations that could not be served from a pool's free list and went to the upstream allocator
+    [[nodiscard]] std::size_t upstream_allocations() const noexcept { return upstream_allocations_; }
+
   private:
     static constexpr std::size_t POOL_COUNT = detail::get_pool_index(LARGEST_POOL_BLOCK_SIZE) + 1u;
 
     MemoryBlockList oversized_list_;
     Pool pools_[POOL_COUNT];
+    std::size_t upstream_allocations_{};
 };
 }
 
@@ -27,6 +27,7 @@
 #include <agrpc/detail/query_grpc_context.hpp>
 #include <agrpc/detail/repeatedly_request_base.hpp>
 #include <agrpc/detail/rpc_context.hpp>
+#include <agrpc/detail/server_middleware.hpp>
 #include <agrpc/detail/utility.hpp>
 #include <agrpc/repeatedly_request_context.hpp>
 #include <agrpc/rpc.hpp>
@@ -109,6 +110,30 @@ auto initiate_request_from_rpc_context(detail::GenericRPCMarker, grpc::AsyncGene
                           static_cast<CompletionToken&&>(token));
 }
 
+template <class Responder>
+using ResponderFinishWithErrorT =
+    decltype(std::declval<Responder&>().FinishWithError(std::declval<const grpc::Status&>(), nullptr));
+
+template <class Responder, class = void>
+inline constexpr bool RESPONDER_HAS_FINISH_WITH_ERROR = false;
+
+template <class Responder>
+inline constexpr bool
+    RESPONDER_HAS_FINISH_WITH_ERROR<Responder, std::void_t<detail::ResponderFinishWithErrorT<Responder>>> = true;
+
+template <class Responder, class CompletionToken>
+auto finish_rejected_rpc(Responder& responder, const grpc::Status& status, CompletionToken&& token)
+{
+    if constexpr (detail::RESPONDER_HAS_FINISH_WITH_ERROR<Responder>)
+    {
+        return agrpc::finish_with_error(responder, status, static_cast<CompletionToken&&>(token));
+    }
+    else
+    {
+        return agrpc::finish(responder, status, static_cast<CompletionToken&&>(token));
+    }
+}
+
 template <class RequestHandler, class RPC, class CompletionHandler>
 class RepeatedlyRequestCoroutineOperation
     : public detail::QueueableOperationBase,
@@ -120,7 +145,8 @@ class RepeatedlyRequestCoroutineOperation
     using Service = detail::GetServiceT<RPC>;
     using RPCContext = detail::RPCContextForRPCT<RPC>;
     using Coroutine =
-        detail::RebindCoroutineT<detail::InvokeResultFromSignatureT<RequestHandler&, typename RPCContext::Signature>,
+        detail::RebindCoroutineT<detail::InvokeResultFromSignatureT<detail::UnwrapServerMiddlewareT<RequestHandler>&,
+                                                                    typename RPCContext::Signature>,
                                  void>;
     using UseCoroutine = detail::CoroutineCompletionTokenT<Coroutine>;
     using CoroutineCompletionHandler = detail::CompletionHandlerTypeT<UseCoroutine, void(bool)>;
@@ -182,7 +208,33 @@ class RepeatedlyRequestCoroutineOperation
             {
                 detail::GrpcContextImplementation::add_local_operation(this->grpc_context(), this);
             }
-            co_await detail::invoke_from_rpc_context(static_cast<RequestHandler&&>(local_request_handler), rpc_context);
+            if constexpr (detail::IS_SERVER_MIDDLEWARE<RequestHandler>)
+            {
+                // Interceptors run within this coroutine, a rejected RPC is finished without invoking the request
+                // handler.
+                auto& chain = detail::ServerMiddlewareAccess::chain(local_request_handler);
+                detail::ScopeGuard after_guard{[&]
+                                               {
+                                                   chain.after(rpc_context.server_context());
+                                               }};
+                const auto status = chain.before(rpc_context.server_context());
+                if AGRPC_LIKELY (status.ok())
+                {
+                    auto& request_handler = detail::ServerMiddlewareAccess::request_handler(local_request_handler);
+                    co_await detail::invoke_from_rpc_context(
+                        static_cast<std::remove_reference_t<decltype(request_handler)>&&>(request_handler),
+                        rpc_context);
+                }
+                else
+                {
+                    co_await detail::finish_rejected_rpc(rpc_context.responder(), status, UseCoroutine{});
+                }
+            }
+            else
+            {
+                co_await detail::invoke_from_rpc_context(static_cast<RequestHandler&&>(local_request_handler),
+                                                         rpc_context);
+            }
         }
         else
         {
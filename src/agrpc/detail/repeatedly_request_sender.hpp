@@ -119,6 +119,12 @@ class RepeatedlyRequestSender : public detail::SenderOf<void()>
                 }
 
                 void set_error(const std::exception_ptr&) noexcept { deallocate(); }
+
+#ifdef AGRPC_STDEXEC
+                using receiver_concept = ::stdexec::receiver_t;
+
+                void set_stopped() noexcept { deallocate(); }
+#endif
             };
 
             agrpc::GrpcContext& grpc_context_;
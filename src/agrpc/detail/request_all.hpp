@@ -0,0 +1,326 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_DETAIL_REQUEST_ALL_HPP
+#define AGRPC_DETAIL_REQUEST_ALL_HPP
+
+#include <agrpc/detail/asio_forward.hpp>
+#include <agrpc/detail/config.hpp>
+
+#if defined(AGRPC_STANDALONE_ASIO) || defined(AGRPC_BOOST_ASIO)
+
+#include <agrpc/detail/allocate.hpp>
+#include <agrpc/detail/async_initiate.hpp>
+#include <agrpc/detail/grpc_context_implementation.hpp>
+#include <agrpc/detail/operation_base.hpp>
+#include <agrpc/detail/utility.hpp>
+#include <agrpc/detail/work_tracking_completion_handler.hpp>
+#include <agrpc/grpc_context.hpp>
+#include <grpcpp/client_context.h>
+#include <grpcpp/support/status.h>
+
+#include <chrono>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+AGRPC_NAMESPACE_BEGIN()
+
+template <class Response>
+struct UnaryResult;
+
+namespace detail
+{
+struct alignas(std::max_align_t) RequestAllStorage
+{
+    std::byte data_[alignof(std::max_align_t)];
+};
+
+// Selects the completion of agrpc::request_all: all results are collected into a vector.
+struct RequestAllCollect
+{
+};
+
+// The operation and all of its slots live in a single allocation: [RequestAllOperation][Slot 0]...[Slot n-1]
+template <class Responder, class Response, class OnResult, class CompletionHandler>
+class RequestAllOperation
+{
+  private:
+    using WorkTrackingCompletionHandler = detail::WorkTrackingCompletionHandler<CompletionHandler>;
+    using Allocator =
+        detail::RebindAllocator<detail::RequestAllStorage, asio::associated_allocator_t<CompletionHandler>>;
+    using Traits = std::allocator_traits<Allocator>;
+
+    static constexpr bool IS_COLLECT = std::is_same_v<detail::RequestAllCollect, OnResult>;
+
+  public:
+    struct Slot : detail::OperationBase
+    {
+        explicit Slot(RequestAllOperation& self) noexcept : detail::OperationBase(&do_complete), self_(self) {}
+
+        grpc::ClientContext client_context_;
+        std::unique_ptr<Responder> responder_;
+        grpc::Status status_;
+        Response response_;
+        RequestAllOperation& self_;
+        bool is_done_{};
+    };
+
+  private:
+    static constexpr std::size_t units(std::size_t bytes) noexcept
+    {
+        return (bytes + sizeof(detail::RequestAllStorage) - 1) / sizeof(detail::RequestAllStorage);
+    }
+
+    static constexpr std::size_t HEADER_UNITS = units(sizeof(RequestAllOperation));
+
+    static_assert(alignof(Slot) <= alignof(detail::RequestAllStorage));
+
+    static constexpr std::size_t storage_count(std::size_t size) noexcept
+    {
+        return HEADER_UNITS + units(size * sizeof(Slot));
+    }
+
+  public:
+    template <class Ch, class Rh>
+    static RequestAllOperation* create(Ch&& ch, Rh&& on_result, std::size_t size, bool cancel_on_error)
+    {
+        Allocator allocator{asio::get_associated_allocator(ch)};
+        const auto count = storage_count(size);
+        auto* const storage = Traits::allocate(allocator, count);
+        detail::ScopeGuard guard{[&]
+                                 {
+                                     Traits::deallocate(allocator, storage, count);
+                                 }};
+        auto* const self = ::new (static_cast<void*>(storage))
+            RequestAllOperation(static_cast<Ch&&>(ch), static_cast<Rh&&>(on_result), size, cancel_on_error);
+        guard.release();
+        return self;
+    }
+
+    // Only valid as long as no call has been started.
+    void destroy() noexcept { destroy_deallocate(this, completion_handler_.get_allocator()); }
+
+    [[nodiscard]] Slot* slots() noexcept
+    {
+        return std::launder(reinterpret_cast<Slot*>(reinterpret_cast<detail::RequestAllStorage*>(this) + HEADER_UNITS));
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+
+  private:
+    template <class Ch, class Rh>
+    RequestAllOperation(Ch&& ch, Rh&& on_result, std::size_t size, bool cancel_on_error)
+        : completion_handler_(static_cast<Ch&&>(ch)),
+          on_result_(static_cast<Rh&&>(on_result)),
+          size_(size),
+          remaining_(size),
+          cancel_on_error_(cancel_on_error)
+    {
+        auto* const slots = this->slots();
+        std::size_t constructed{};
+        detail::ScopeGuard guard{[&]
+                                 {
+                                     std::destroy_n(slots, constructed);
+                                 }};
+        for (; constructed < size; ++constructed)
+        {
+            ::new (static_cast<void*>(slots + constructed)) Slot(*this);
+        }
+        guard.release();
+    }
+
+    static void destroy_deallocate(RequestAllOperation* self, Allocator allocator) noexcept
+    {
+        const auto count = storage_count(self->size_);
+        std::destroy_n(self->slots(), self->size_);
+        self->~RequestAllOperation();
+        Traits::deallocate(allocator, reinterpret_cast<detail::RequestAllStorage*>(self), count);
+    }
+
+    static void do_complete(detail::OperationBase* op, detail::OperationResult result, agrpc::GrpcContext&)
+    {
+        auto& slot = *static_cast<Slot*>(op);
+        auto& self = slot.self_;
+        slot.is_done_ = true;
+        const bool is_last = --self.remaining_ == 0;
+        if AGRPC_UNLIKELY (detail::is_shutdown(result))
+        {
+            self.is_shutdown_ = true;
+        }
+        else if (is_last)
+        {
+            // An exception thrown by on_result must not prevent the operation from completing
+            AGRPC_TRY { self.on_slot_complete(slot); }
+            AGRPC_CATCH(...)
+            {
+                self.complete();
+                AGRPC_RETHROW();
+            }
+        }
+        else
+        {
+            self.on_slot_complete(slot);
+        }
+        if (is_last)
+        {
+            self.complete();
+        }
+    }
+
+    void on_slot_complete(Slot& slot)
+    {
+        if (!slot.status_.ok() && first_error_.ok())
+        {
+            first_error_ = slot.status_;
+            if (cancel_on_error_)
+            {
+                cancel_remaining();
+            }
+        }
+        if constexpr (!IS_COLLECT)
+        {
+            if (!is_shutdown_)
+            {
+                on_result_(static_cast<std::size_t>(&slot - slots()), static_cast<grpc::Status&&>(slot.status_),
+                           static_cast<Response&&>(slot.response_));
+            }
+        }
+    }
+
+    void cancel_remaining() noexcept
+    {
+        auto* const slots = this->slots();
+        for (std::size_t i{}; i < size_; ++i)
+        {
+            if (!slots[i].is_done_)
+            {
+                slots[i].client_context_.TryCancel();
+            }
+        }
+    }
+
+    void complete()
+    {
+        if AGRPC_UNLIKELY (is_shutdown_)
+        {
+            destroy();
+            return;
+        }
+        if constexpr (IS_COLLECT)
+        {
+            std::vector<agrpc::UnaryResult<Response>> results;
+            results.reserve(size_);
+            auto* const slots = this->slots();
+            for (std::size_t i{}; i < size_; ++i)
+            {
+                results.push_back({static_cast<grpc::Status&&>(slots[i].status_),
+                                   static_cast<Response&&>(slots[i].response_)});
+            }
+            WorkTrackingCompletionHandler local_completion_handler{
+                static_cast<WorkTrackingCompletionHandler&&>(completion_handler_)};
+            destroy_deallocate(this, local_completion_handler.get_allocator());
+            static_cast<WorkTrackingCompletionHandler&&>(local_completion_handler)(
+                static_cast<std::vector<agrpc::UnaryResult<Response>>&&>(results));
+        }
+        else
+        {
+            grpc::Status status{static_cast<grpc::Status&&>(first_error_)};
+            WorkTrackingCompletionHandler local_completion_handler{
+                static_cast<WorkTrackingCompletionHandler&&>(completion_handler_)};
+            destroy_deallocate(this, local_completion_handler.get_allocator());
+            static_cast<WorkTrackingCompletionHandler&&>(local_completion_handler)(static_cast<grpc::Status&&>(status));
+        }
+    }
+
+    WorkTrackingCompletionHandler completion_handler_;
+    OnResult on_result_;
+    grpc::Status first_error_;
+    std::size_t size_;
+    std::size_t remaining_;
+    bool cancel_on_error_;
+    bool is_shutdown_{};
+};
+
+template <class Responder, class Response, class RPC, class Stub, class Requests>
+struct RequestAllInitiation
+{
+    template <class CompletionHandler, class OnResult>
+    void operator()(CompletionHandler&& ch, OnResult&& on_result) const
+    {
+        using Operation = detail::RequestAllOperation<Responder, Response, detail::RemoveCrefT<OnResult>,
+                                                      detail::RemoveCrefT<CompletionHandler>>;
+        const auto size = static_cast<std::size_t>(std::distance(std::begin(requests_), std::end(requests_)));
+        if (size == 0)
+        {
+            if constexpr (std::is_same_v<detail::RequestAllCollect, detail::RemoveCrefT<OnResult>>)
+            {
+                detail::InitiateImmediateCompletion<void(std::vector<agrpc::UnaryResult<Response>>)>{}(
+                    static_cast<CompletionHandler&&>(ch), std::vector<agrpc::UnaryResult<Response>>{});
+            }
+            else
+            {
+                detail::InitiateImmediateCompletion<void(grpc::Status)>{}(static_cast<CompletionHandler&&>(ch),
+                                                                          grpc::Status{});
+            }
+            return;
+        }
+        auto* const self = Operation::create(static_cast<CompletionHandler&&>(ch), static_cast<OnResult&&>(on_result),
+                                             size, cancel_on_error_);
+        auto* const slots = self->slots();
+        {
+            // Calls are only created here, destroying them before StartCall is fine.
+            detail::ScopeGuard guard{[&]
+                                     {
+                                         self->destroy();
+                                     }};
+            auto* const completion_queue = grpc_context_.get_completion_queue();
+            auto request = std::begin(requests_);
+            for (std::size_t i{}; i < size; ++i, ++request)
+            {
+                auto& slot = slots[i];
+                if (deadline_ != std::chrono::system_clock::time_point::max())
+                {
+                    slot.client_context_.set_deadline(deadline_);
+                }
+                slot.responder_ = (stub_.*rpc_)(&slot.client_context_, *request, completion_queue);
+            }
+            guard.release();
+        }
+        detail::GrpcContextImplementation::work_started(grpc_context_, size);
+        for (std::size_t i{}; i < size; ++i)
+        {
+            auto& slot = slots[i];
+            slot.responder_->StartCall();
+            slot.responder_->Finish(&slot.response_, &slot.status_, &slot);
+        }
+    }
+
+    RPC rpc_;
+    Stub& stub_;
+    const Requests& requests_;
+    agrpc::GrpcContext& grpc_context_;
+    std::chrono::system_clock::time_point deadline_;
+    bool cancel_on_error_;
+};
+}
+
+AGRPC_NAMESPACE_END
+
+#endif
+
+#endif  // AGRPC_DETAIL_REQUEST_ALL_HPP
@@ -0,0 +1,109 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_DETAIL_RING_BUFFER_HPP
+#define AGRPC_DETAIL_RING_BUFFER_HPP
+
+#include <agrpc/detail/config.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+
+AGRPC_NAMESPACE_BEGIN()
+
+namespace detail
+{
+template <class T, std::size_t Capacity>
+class RingBuffer
+{
+  private:
+    static_assert(Capacity > 0, "RingBuffer must have a capacity of at least one");
+
+  public:
+    RingBuffer() = default;
+
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer(RingBuffer&&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+    RingBuffer& operator=(RingBuffer&&) = delete;
+
+    ~RingBuffer() noexcept
+    {
+        while (!empty())
+        {
+            std::destroy_at(front_pointer());
+            pop_front_index();
+        }
+    }
+
+    [[nodiscard]] static constexpr std::size_t capacity() noexcept { return Capacity; }
+
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+
+    [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+
+    [[nodiscard]] bool full() const noexcept { return size_ == Capacity; }
+
+    template <class... Args>
+    void emplace_back(Args&&... args)
+    {
+        assert(!full() && "RingBuffer is full");
+        auto back = begin_ + size_;
+        if (back >= Capacity)
+        {
+            back -= Capacity;
+        }
+        ::new (static_cast<void*>(storage_[back].data_)) T{static_cast<Args&&>(args)...};
+        ++size_;
+    }
+
+    [[nodiscard]] T pop_front()
+    {
+        assert(!empty() && "RingBuffer is empty");
+        auto* const front = front_pointer();
+        T local_value{static_cast<T&&>(*front)};
+        std::destroy_at(front);
+        pop_front_index();
+        return local_value;
+    }
+
+  private:
+    struct Storage
+    {
+        alignas(T) std::byte data_[sizeof(T)];
+    };
+
+    T* front_pointer() noexcept { return std::launder(reinterpret_cast<T*>(storage_[begin_].data_)); }
+
+    void pop_front_index() noexcept
+    {
+        ++begin_;
+        if (begin_ == Capacity)
+        {
+            begin_ = 0;
+        }
+        --size_;
+    }
+
+    Storage storage_[Capacity];
+    std::size_t begin_{};
+    std::size_t size_{};
+};
+}
+
+AGRPC_NAMESPACE_END
+
+#endif  // AGRPC_DETAIL_RING_BUFFER_HPP
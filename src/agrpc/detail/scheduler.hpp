@@ -0,0 +1,404 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_DETAIL_SCHEDULER_HPP
+#define AGRPC_DETAIL_SCHEDULER_HPP
+
+#include <agrpc/detail/asio_forward.hpp>
+#include <agrpc/detail/config.hpp>
+
+#if defined(AGRPC_STANDALONE_ASIO) || defined(AGRPC_BOOST_ASIO)
+
+#include <agrpc/detail/allocate_operation.hpp>
+#include <agrpc/detail/allocation_type.hpp>
+#include <agrpc/detail/grpc_context_implementation.hpp>
+#include <agrpc/detail/grpc_executor_base.hpp>
+#include <agrpc/detail/operation_base.hpp>
+#include <agrpc/detail/utility.hpp>
+#include <agrpc/grpc_context.hpp>
+
+#include <cassert>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+AGRPC_NAMESPACE_BEGIN()
+
+namespace detail
+{
+template <class Key>
+class SchedulerBase;
+
+// Work that has been submitted through a scheduler's executor. `key_` is interpreted by the scheduling policy, e.g.
+// as a deadline.
+template <class Key>
+class ScheduledOperationBase : public detail::QueueableOperationBase
+{
+  public:
+    using detail::QueueableOperationBase::complete;
+
+    Key key_;
+    std::uint64_t sequence_{};
+
+  protected:
+    ScheduledOperationBase(detail::OperationOnComplete on_complete, const Key& key) noexcept
+        : detail::QueueableOperationBase(on_complete), key_(key)
+    {
+    }
+
+  private:
+    friend detail::SchedulerBase<Key>;
+
+    detail::OperationOnComplete on_complete_{};
+    detail::SchedulerBase<Key>* scheduler_{};
+};
+
+template <class Key>
+struct ScheduledOperationTemplate
+{
+    template <class Handler>
+    class Type : public detail::ScheduledOperationBase<Key>
+    {
+      private:
+        using Base = detail::ScheduledOperationBase<Key>;
+
+      public:
+        template <class CompletionHandler>
+        Type(detail::AllocationType allocation_type, CompletionHandler&& handler, const Key& key)
+            : Base(detail::AllocationType::LOCAL == allocation_type ? detail::DO_COMPLETE_LOCAL_NO_ARG_HANDLER<Type>
+                                                                    : detail::DO_COMPLETE_NO_ARG_HANDLER<Type>,
+                   key),
+              handler_(static_cast<CompletionHandler&&>(handler))
+        {
+        }
+
+        [[nodiscard]] Handler& completion_handler() noexcept { return handler_; }
+
+        [[nodiscard]] auto get_allocator() noexcept { return detail::exec::get_allocator(handler_); }
+
+      private:
+        Handler handler_;
+    };
+};
+
+// Common part of all schedulers: Ready work is handed to the scheduling policy through `push_`. A single, embedded
+// operation is placed into the GrpcContext's local queue while the policy holds work. When the GrpcContext processes
+// it, `drain_` runs some of that work in the order decided by the policy. Must only be accessed from the thread that
+// runs the GrpcContext, work submitted from other threads is first routed through the GrpcContext's remote queue.
+template <class Key>
+class SchedulerBase
+{
+  protected:
+    using Operation = detail::ScheduledOperationBase<Key>;
+    using Push = void (*)(SchedulerBase*, Operation*);
+    using Drain = void (*)(SchedulerBase*, detail::OperationResult);
+
+    SchedulerBase(agrpc::GrpcContext& grpc_context, Push push, Drain drain) noexcept
+        : grpc_context_(grpc_context), push_(push), drain_operation_(*this, drain)
+    {
+    }
+
+    SchedulerBase(const SchedulerBase&) = delete;
+    SchedulerBase(SchedulerBase&&) = delete;
+    SchedulerBase& operator=(const SchedulerBase&) = delete;
+    SchedulerBase& operator=(SchedulerBase&&) = delete;
+
+    ~SchedulerBase() noexcept
+    {
+        assert(!is_drain_scheduled_ && "A scheduler must not be destroyed while it still has work");
+    }
+
+  public:
+    [[nodiscard]] agrpc::GrpcContext& grpc_context() const noexcept { return grpc_context_; }
+
+    template <class Function>
+    void submit(const Key& key, Function&& function)
+    {
+        if AGRPC_UNLIKELY (detail::GrpcContextImplementation::is_shutdown(grpc_context_))
+        {
+            return;
+        }
+        if (detail::GrpcContextImplementation::running_in_this_thread(grpc_context_))
+        {
+            auto* const operation = detail::allocate_local_operation<ScheduledOperationTemplate<Key>::template Type>(
+                grpc_context_, static_cast<Function&&>(function), key);
+            push(operation);
+            return;
+        }
+        detail::StartWorkAndGuard guard{grpc_context_};
+        auto* const operation = detail::allocate_custom_operation<ScheduledOperationTemplate<Key>::template Type>(
+            static_cast<Function&&>(function), key);
+        auto& on_complete = detail::OperationBaseAccess::get_on_complete(*operation);
+        operation->on_complete_ = on_complete;
+        operation->scheduler_ = this;
+        on_complete = &do_arrive;
+        detail::GrpcContextImplementation::add_remote_operation(grpc_context_, operation);
+        guard.release();
+    }
+
+  protected:
+    // To be called by the drain function once it is done, `has_more` indicates that the policy still holds work.
+    void on_drained(bool has_more) noexcept
+    {
+        is_drain_scheduled_ = false;
+        if (has_more)
+        {
+            schedule_drain();
+        }
+    }
+
+  private:
+    class DrainOperation : public detail::QueueableOperationBase
+    {
+      public:
+        DrainOperation(SchedulerBase& self, Drain drain) noexcept
+            : detail::QueueableOperationBase(&do_complete), self_(self), drain_(drain)
+        {
+        }
+
+      private:
+        static void do_complete(detail::OperationBase* op, detail::OperationResult result, agrpc::GrpcContext&)
+        {
+            auto& self = *static_cast<DrainOperation*>(op);
+            self.drain_(&self.self_, result);
+        }
+
+        SchedulerBase& self_;
+        Drain drain_;
+    };
+
+    void schedule_drain() noexcept
+    {
+        is_drain_scheduled_ = true;
+        detail::GrpcContextImplementation::work_started(grpc_context_);
+        detail::GrpcContextImplementation::add_local_operation(grpc_context_, &drain_operation_);
+    }
+
+    void push(Operation* operation)
+    {
+        operation->sequence_ = next_sequence_++;
+        push_(this, operation);
+        if (!is_drain_scheduled_)
+        {
+            schedule_drain();
+        }
+    }
+
+    // Work submitted from another thread has arrived in the GrpcContext's thread.
+    static void do_arrive(detail::OperationBase* op, detail::OperationResult result, agrpc::GrpcContext& grpc_context)
+    {
+        auto* const operation = static_cast<Operation*>(static_cast<detail::QueueableOperationBase*>(op));
+        detail::OperationBaseAccess::get_on_complete(*operation) = operation->on_complete_;
+        if AGRPC_UNLIKELY (detail::is_shutdown(result))
+        {
+            operation->complete(result, grpc_context);
+            return;
+        }
+        operation->scheduler_->push(operation);
+    }
+
+    agrpc::GrpcContext& grpc_context_;
+    Push push_;
+    DrainOperation drain_operation_;
+    std::uint64_t next_sequence_{};
+    bool is_drain_scheduled_{};
+};
+
+// Executor that submits work to a scheduler along with a key
+template <class Scheduler>
+class BasicSchedulerExecutor
+{
+  private:
+    using Key = typename Scheduler::Key;
+
+  public:
+    BasicSchedulerExecutor(Scheduler& scheduler, const Key& key) noexcept : scheduler_(&scheduler), key_(key) {}
+
+    BasicSchedulerExecutor(const BasicSchedulerExecutor& other) noexcept
+        : scheduler_(other.scheduler_), key_(other.key_), is_tracked_(other.is_tracked_)
+    {
+        start_work();
+    }
+
+    BasicSchedulerExecutor(BasicSchedulerExecutor&& other) noexcept
+        : scheduler_(other.scheduler_), key_(other.key_), is_tracked_(std::exchange(other.is_tracked_, false))
+    {
+    }
+
+    ~BasicSchedulerExecutor() noexcept { finish_work(); }
+
+    BasicSchedulerExecutor& operator=(const BasicSchedulerExecutor& other) noexcept
+    {
+        if (this != &other)
+        {
+            *this = BasicSchedulerExecutor{other};
+        }
+        return *this;
+    }
+
+    BasicSchedulerExecutor& operator=(BasicSchedulerExecutor&& other) noexcept
+    {
+        if (this != &other)
+        {
+            finish_work();
+            scheduler_ = other.scheduler_;
+            key_ = other.key_;
+            is_tracked_ = std::exchange(other.is_tracked_, false);
+        }
+        return *this;
+    }
+
+    [[nodiscard]] Scheduler& scheduler() const noexcept { return *scheduler_; }
+
+    [[nodiscard]] const Key& key() const noexcept { return key_; }
+
+    [[nodiscard]] friend bool operator==(const BasicSchedulerExecutor& lhs, const BasicSchedulerExecutor& rhs) noexcept
+    {
+        return lhs.scheduler_ == rhs.scheduler_ && lhs.key_ == rhs.key_;
+    }
+
+    [[nodiscard]] friend bool operator!=(const BasicSchedulerExecutor& lhs, const BasicSchedulerExecutor& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+
+    template <class Function>
+    void execute(Function&& function) const
+    {
+        scheduler_->submit(key_, static_cast<Function&&>(function));
+    }
+
+    [[nodiscard]] agrpc::GrpcContext& query(asio::execution::context_t) const noexcept
+    {
+        return scheduler_->grpc_context();
+    }
+
+    [[nodiscard]] static constexpr asio::execution::blocking_t query(asio::execution::blocking_t) noexcept
+    {
+        return asio::execution::blocking.never;
+    }
+
+    [[nodiscard]] BasicSchedulerExecutor require(asio::execution::blocking_t::never_t) const noexcept { return *this; }
+
+    [[nodiscard]] BasicSchedulerExecutor prefer(asio::execution::outstanding_work_t::tracked_t) const noexcept
+    {
+        return BasicSchedulerExecutor{*scheduler_, key_, true};
+    }
+
+    [[nodiscard]] BasicSchedulerExecutor prefer(asio::execution::outstanding_work_t::untracked_t) const noexcept
+    {
+        return BasicSchedulerExecutor{*scheduler_, key_, false};
+    }
+
+  private:
+    BasicSchedulerExecutor(Scheduler& scheduler, const Key& key, bool is_tracked) noexcept
+        : scheduler_(&scheduler), key_(key), is_tracked_(is_tracked)
+    {
+        start_work();
+    }
+
+    void start_work() const noexcept
+    {
+        if (is_tracked_)
+        {
+            scheduler_->grpc_context().work_started();
+        }
+    }
+
+    void finish_work() const noexcept
+    {
+        if (is_tracked_)
+        {
+            scheduler_->grpc_context().work_finished();
+        }
+    }
+
+    Scheduler* scheduler_;
+    Key key_;
+    bool is_tracked_{};
+};
+}
+
+AGRPC_NAMESPACE_END
+
+#if !defined(BOOST_ASIO_HAS_DEDUCED_EQUALITY_COMPARABLE_TRAIT) && \
+    !defined(ASIO_HAS_DEDUCED_EQUALITY_COMPARABLE_TRAIT)
+template <class Scheduler>
+struct agrpc::asio::traits::equality_comparable<agrpc::detail::BasicSchedulerExecutor<Scheduler>>
+{
+    static constexpr bool is_valid = true;
+    static constexpr bool is_noexcept = true;
+};
+#endif
+
+#if !defined(BOOST_ASIO_HAS_DEDUCED_EXECUTE_MEMBER_TRAIT) && !defined(ASIO_HAS_DEDUCED_EXECUTE_MEMBER_TRAIT)
+template <class Scheduler, class F>
+struct agrpc::asio::traits::execute_member<agrpc::detail::BasicSchedulerExecutor<Scheduler>, F>
+{
+    static constexpr bool is_valid = true;
+    static constexpr bool is_noexcept = false;
+
+    using result_type = void;
+};
+#endif
+
+#if !defined(BOOST_ASIO_HAS_DEDUCED_QUERY_MEMBER_TRAIT) && !defined(ASIO_HAS_DEDUCED_QUERY_MEMBER_TRAIT)
+template <class Scheduler>
+struct agrpc::asio::traits::query_member<agrpc::detail::BasicSchedulerExecutor<Scheduler>,
+                                         agrpc::asio::execution::context_t>
+{
+    static constexpr bool is_valid = true;
+    static constexpr bool is_noexcept = true;
+
+    using result_type = agrpc::GrpcContext&;
+};
+#endif
+
+template <class Scheduler, class Property>
+struct agrpc::asio::traits::query_static_constexpr_member<
+    agrpc::detail::BasicSchedulerExecutor<Scheduler>, Property,
+    typename std::enable_if_t<std::is_convertible_v<Property, agrpc::asio::execution::blocking_t>>>
+    : agrpc::detail::QueryStaticBlocking<true>
+{
+};
+
+#if !defined(BOOST_ASIO_HAS_DEDUCED_REQUIRE_MEMBER_TRAIT) && !defined(ASIO_HAS_DEDUCED_REQUIRE_MEMBER_TRAIT)
+template <class Scheduler>
+struct agrpc::asio::traits::require_member<agrpc::detail::BasicSchedulerExecutor<Scheduler>,
+                                           agrpc::asio::execution::blocking_t::never_t>
+{
+    static constexpr bool is_valid = true;
+    static constexpr bool is_noexcept = true;
+
+    using result_type = agrpc::detail::BasicSchedulerExecutor<Scheduler>;
+};
+#endif
+
+#if !defined(BOOST_ASIO_HAS_DEDUCED_PREFER_MEMBER_TRAIT) && !defined(ASIO_HAS_DEDUCED_PREFER_MEMBER_TRAIT)
+template <class Scheduler, class Property>
+struct agrpc::asio::traits::prefer_member<
+    agrpc::detail::BasicSchedulerExecutor<Scheduler>, Property,
+    std::enable_if_t<std::is_same_v<Property, agrpc::asio::execution::outstanding_work_t::tracked_t> ||
+                     std::is_same_v<Property, agrpc::asio::execution::outstanding_work_t::untracked_t>>>
+{
+    static constexpr bool is_valid = true;
+    static constexpr bool is_noexcept = true;
+
+    using result_type = agrpc::detail::BasicSchedulerExecutor<Scheduler>;
+};
+#endif
+
+#endif
+
+#endif  // AGRPC_DETAIL_SCHEDULER_HPP
@@ -0,0 +1,168 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_DETAIL_SERVER_MIDDLEWARE_HPP
+#define AGRPC_DETAIL_SERVER_MIDDLEWARE_HPP
+
+#include <agrpc/detail/config.hpp>
+#include <grpcpp/server_context.h>
+#include <grpcpp/support/status.h>
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+AGRPC_NAMESPACE_BEGIN()
+
+template <class RequestHandler, class... Interceptors>
+class ServerMiddleware;
+
+namespace detail
+{
+template <class T>
+inline constexpr bool IS_SERVER_MIDDLEWARE = false;
+
+template <class RequestHandler, class... Interceptors>
+inline constexpr bool IS_SERVER_MIDDLEWARE<agrpc::ServerMiddleware<RequestHandler, Interceptors...>> = true;
+
+// The request handler that a ServerMiddleware wraps, used to deduce the awaitable type.
+template <class RequestHandler>
+struct UnwrapServerMiddleware
+{
+    using Type = RequestHandler;
+};
+
+template <class RequestHandler, class... Interceptors>
+struct UnwrapServerMiddleware<agrpc::ServerMiddleware<RequestHandler, Interceptors...>>
+{
+    using Type = RequestHandler;
+};
+
+template <class RequestHandler>
+using UnwrapServerMiddlewareT = typename detail::UnwrapServerMiddleware<RequestHandler>::Type;
+
+template <class Interceptor, class = void>
+inline constexpr bool INTERCEPTOR_HAS_BEFORE = false;
+
+template <class Interceptor>
+inline constexpr bool INTERCEPTOR_HAS_BEFORE<
+    Interceptor, decltype((void)std::declval<Interceptor&>().before(std::declval<grpc::ServerContext&>()))> = true;
+
+template <class Interceptor, class = void>
+inline constexpr bool INTERCEPTOR_HAS_AFTER = false;
+
+template <class Interceptor>
+inline constexpr bool INTERCEPTOR_HAS_AFTER<
+    Interceptor, decltype((void)std::declval<Interceptor&>().after(std::declval<grpc::ServerContext&>()))> = true;
+
+template <class Interceptor>
+grpc::Status invoke_interceptor_before(Interceptor& interceptor, grpc::ServerContext& server_context)
+{
+    if constexpr (!detail::INTERCEPTOR_HAS_BEFORE<Interceptor>)
+    {
+        return grpc::Status::OK;
+    }
+    else if constexpr (std::is_void_v<decltype(interceptor.before(server_context))>)
+    {
+        interceptor.before(server_context);
+        return grpc::Status::OK;
+    }
+    else
+    {
+        return interceptor.before(server_context);
+    }
+}
+
+template <class Interceptor>
+void invoke_interceptor_after(Interceptor& interceptor, grpc::ServerContext& server_context) noexcept
+{
+    if constexpr (detail::INTERCEPTOR_HAS_AFTER<Interceptor>)
+    {
+        interceptor.after(server_context);
+    }
+}
+
+// Runs `before` hooks in order until one of them rejects the RPC and `after` hooks in reverse order for all
+// interceptors whose `before` hook has returned.
+template <class... Interceptors>
+class ServerInterceptorChain
+{
+  public:
+    template <class... Args>
+    explicit ServerInterceptorChain(Args&&... args) : interceptors_(static_cast<Args&&>(args)...)
+    {
+    }
+
+    grpc::Status before(grpc::ServerContext& server_context)
+    {
+        grpc::Status status;
+        before_impl(server_context, status, std::index_sequence_for<Interceptors...>{});
+        return status;
+    }
+
+    void after(grpc::ServerContext& server_context) noexcept
+    {
+        after_impl(server_context, std::index_sequence_for<Interceptors...>{});
+    }
+
+  private:
+    template <std::size_t... I>
+    void before_impl(grpc::ServerContext& server_context, grpc::Status& status, std::index_sequence<I...>)
+    {
+        static_cast<void>(
+            ((status = detail::invoke_interceptor_before(std::get<I>(interceptors_), server_context), ++entered_,
+              status.ok()) &&
+             ...));
+    }
+
+    template <std::size_t... I>
+    void after_impl(grpc::ServerContext& server_context, std::index_sequence<I...>) noexcept
+    {
+        static constexpr auto SIZE = sizeof...(Interceptors);
+        (after_one<SIZE - 1 - I>(server_context), ...);
+    }
+
+    template <std::size_t I>
+    void after_one(grpc::ServerContext& server_context) noexcept
+    {
+        if (I < entered_)
+        {
+            detail::invoke_interceptor_after(std::get<I>(interceptors_), server_context);
+        }
+    }
+
+    std::tuple<Interceptors...> interceptors_;
+    std::size_t entered_{};
+};
+
+struct ServerMiddlewareAccess
+{
+    template <class Middleware>
+    static auto& request_handler(Middleware& middleware) noexcept
+    {
+        return middleware.request_handler_;
+    }
+
+    template <class Middleware>
+    static auto& chain(Middleware& middleware) noexcept
+    {
+        return middleware.chain_;
+    }
+};
+}
+
+AGRPC_NAMESPACE_END
+
+#endif  // AGRPC_DETAIL_SERVER_MIDDLEWARE_HPP
@@ -0,0 +1,470 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_DETAIL_TASK_HPP
+#define AGRPC_DETAIL_TASK_HPP
+
+#include <agrpc/detail/asio_forward.hpp>
+#include <agrpc/detail/config.hpp>
+
+#if (defined(AGRPC_STANDALONE_ASIO) || defined(AGRPC_BOOST_ASIO)) && defined(AGRPC_HAS_STD_COROUTINE)
+
+#include <agrpc/detail/allocate.hpp>
+#include <agrpc/detail/execution.hpp>
+#include <agrpc/detail/forward.hpp>
+#include <agrpc/detail/grpc_context_implementation.hpp>
+#include <agrpc/detail/memory.hpp>
+#include <agrpc/detail/operation_base.hpp>
+#include <agrpc/detail/utility.hpp>
+#include <agrpc/detail/work_tracking_completion_handler.hpp>
+#include <agrpc/grpc_context.hpp>
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+
+AGRPC_NAMESPACE_BEGIN()
+
+namespace detail
+{
+// Coroutine frames that are created on a thread that runs a GrpcContext are allocated from its local memory pool. The
+// GrpcContext is remembered in front of the frame so that it can be deallocated into the same pool.
+struct TaskFrameAllocator
+{
+    static constexpr std::size_t HEADER_SIZE = detail::align(sizeof(agrpc::GrpcContext*), detail::MAX_ALIGN);
+
+    static void* allocate(std::size_t size)
+    {
+        auto* const grpc_context = detail::GrpcContextImplementation::running_grpc_context();
+        const auto allocation_size = size + HEADER_SIZE;
+        void* p = grpc_context
+                      ? static_cast<void*>(detail::get_local_allocator(*grpc_context).allocate(allocation_size))
+                      : detail::MaxAlignAllocator::allocate(allocation_size);
+        ::new (p) agrpc::GrpcContext*(grpc_context);
+        return static_cast<char*>(p) + HEADER_SIZE;
+    }
+
+    static void deallocate(void* ptr, std::size_t size) noexcept
+    {
+        void* p = static_cast<char*>(ptr) - HEADER_SIZE;
+        auto* const grpc_context = *static_cast<agrpc::GrpcContext**>(p);
+        const auto allocation_size = size + HEADER_SIZE;
+        if (grpc_context)
+        {
+            detail::get_local_allocator(*grpc_context).deallocate(static_cast<std::byte*>(p), allocation_size);
+        }
+        else
+        {
+            detail::MaxAlignAllocator::deallocate(p, allocation_size);
+        }
+    }
+};
+
+struct TaskFinalAwaiter
+{
+    static constexpr bool await_ready() noexcept { return false; }
+
+    template <class Promise>
+    static std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+    {
+        auto& promise = handle.promise();
+        if (promise.continuation_)
+        {
+            return promise.continuation_;
+        }
+        auto& grpc_context = *promise.grpc_context_;
+        grpc_context.work_started();
+        detail::GrpcContextImplementation::add_operation(grpc_context, promise.root_operation_);
+        return std::noop_coroutine();
+    }
+
+    static constexpr void await_resume() noexcept {}
+};
+
+template <class T>
+inline constexpr bool IS_TASK = false;
+
+template <class T>
+inline constexpr bool IS_TASK<agrpc::Task<T>> = true;
+
+template <class Sender>
+class TaskSenderAwaiter;
+
+class TaskPromiseBase
+{
+  public:
+    static void* operator new(std::size_t size) { return detail::TaskFrameAllocator::allocate(size); }
+
+    static void operator delete(void* ptr, std::size_t size) noexcept
+    {
+        detail::TaskFrameAllocator::deallocate(ptr, size);
+    }
+
+    static constexpr std::suspend_always initial_suspend() noexcept { return {}; }
+
+    static constexpr detail::TaskFinalAwaiter final_suspend() noexcept { return {}; }
+
+    void unhandled_exception() noexcept { exception_ = std::current_exception(); }
+
+    template <class Awaitable>
+    decltype(auto) await_transform(Awaitable&& awaitable) noexcept(detail::IS_TASK<detail::RemoveCrefT<Awaitable>>)
+    {
+        if constexpr (detail::IS_TASK<detail::RemoveCrefT<Awaitable>>)
+        {
+            return static_cast<Awaitable&&>(awaitable);
+        }
+        else
+        {
+            return detail::TaskSenderAwaiter<Awaitable>{static_cast<Awaitable&&>(awaitable)};
+        }
+    }
+
+    // Invoked when an awaited sender completed with `set_done`, e.g. because the GrpcContext is being shut down. Like
+    // an asio::awaitable, the whole chain of Tasks is destroyed without being resumed.
+    void stop() noexcept
+    {
+        auto* root = this;
+        while (root->parent_)
+        {
+            root = root->parent_;
+        }
+        root->root_operation_->complete(detail::OperationResult::SHUTDOWN_NOT_OK, *root->grpc_context_);
+    }
+
+    void rethrow_if_exception() const
+    {
+        if AGRPC_UNLIKELY (exception_)
+        {
+            std::rethrow_exception(exception_);
+        }
+    }
+
+    std::coroutine_handle<> continuation_;
+    TaskPromiseBase* parent_{};
+    detail::QueueableOperationBase* root_operation_{};
+    agrpc::GrpcContext* grpc_context_{};
+    std::exception_ptr exception_;
+};
+
+struct TaskAccess
+{
+    template <class T>
+    static agrpc::Task<T> create(std::coroutine_handle<typename agrpc::Task<T>::promise_type> handle) noexcept
+    {
+        return agrpc::Task<T>{handle};
+    }
+
+    template <class T>
+    static auto handle(const agrpc::Task<T>& task) noexcept
+    {
+        return task.handle_;
+    }
+};
+
+template <class T>
+class TaskPromiseReturn : public detail::TaskPromiseBase
+{
+  public:
+    template <class U>
+    void return_value(U&& u)
+    {
+        value_.emplace(static_cast<U&&>(u));
+    }
+
+    T result()
+    {
+        this->rethrow_if_exception();
+        return static_cast<T&&>(*value_);
+    }
+
+    std::optional<T> value_;
+};
+
+template <>
+class TaskPromiseReturn<void> : public detail::TaskPromiseBase
+{
+  public:
+    static constexpr void return_void() noexcept {}
+
+    void result() const { this->rethrow_if_exception(); }
+};
+
+template <class T>
+class TaskPromise : public detail::TaskPromiseReturn<T>
+{
+  public:
+    agrpc::Task<T> get_return_object() noexcept
+    {
+        return detail::TaskAccess::create<T>(std::coroutine_handle<TaskPromise>::from_promise(*this));
+    }
+};
+
+template <class... Values>
+struct TaskSenderValue
+{
+    using Type = std::tuple<Values...>;
+};
+
+template <>
+struct TaskSenderValue<>
+{
+    using Type = void;
+};
+
+template <class Value>
+struct TaskSenderValue<Value>
+{
+    using Type = Value;
+};
+
+template <class... Tuples>
+struct TaskSenderSingleVariant;
+
+template <class Tuple>
+struct TaskSenderSingleVariant<Tuple>
+{
+    using Type = typename Tuple::Type;
+};
+
+template <class Sender>
+using TaskSenderValueT = typename detail::RemoveCrefT<Sender>::template value_types<detail::TaskSenderSingleVariant,
+                                                                                     detail::TaskSenderValue>::Type;
+
+template <class Value>
+struct TaskSenderAwaiterBase
+{
+    std::coroutine_handle<> handle_;
+    detail::TaskPromiseBase* promise_;
+    std::optional<detail::ConditionalT<std::is_void_v<Value>, detail::Empty, Value>> value_;
+    std::exception_ptr exception_;
+};
+
+// Resumes the awaiting coroutine directly from within the completion of the operation.
+template <class Value>
+class TaskReceiver
+{
+  public:
+    explicit TaskReceiver(detail::TaskSenderAwaiterBase<Value>& awaiter) noexcept : awaiter_(&awaiter) {}
+
+    template <class... Args>
+    void set_value(Args&&... args) && noexcept
+    {
+        AGRPC_TRY { awaiter_->value_.emplace(static_cast<Args&&>(args)...); }
+        AGRPC_CATCH(...) { awaiter_->exception_ = std::current_exception(); }
+        awaiter_->handle_.resume();
+    }
+
+    void set_error(std::exception_ptr ep) && noexcept
+    {
+        awaiter_->exception_ = static_cast<std::exception_ptr&&>(ep);
+        awaiter_->handle_.resume();
+    }
+
+    void set_done() && noexcept { awaiter_->promise_->stop(); }
+
+  private:
+    detail::TaskSenderAwaiterBase<Value>* awaiter_;
+};
+
+template <class Sender>
+class TaskSenderAwaiter : public detail::TaskSenderAwaiterBase<detail::TaskSenderValueT<Sender>>
+{
+  private:
+    using Value = detail::TaskSenderValueT<Sender>;
+    using Receiver = detail::TaskReceiver<Value>;
+
+  public:
+    explicit TaskSenderAwaiter(Sender&& sender)
+        : operation_state_(detail::exec::connect(static_cast<Sender&&>(sender), Receiver{*this}))
+    {
+    }
+
+    TaskSenderAwaiter(const TaskSenderAwaiter&) = delete;
+    TaskSenderAwaiter(TaskSenderAwaiter&&) = delete;
+    TaskSenderAwaiter& operator=(const TaskSenderAwaiter&) = delete;
+    TaskSenderAwaiter& operator=(TaskSenderAwaiter&&) = delete;
+
+    static constexpr bool await_ready() noexcept { return false; }
+
+    // The coroutine may be resumed or destroyed before `start` returns, this object must not be accessed afterwards.
+    template <class Promise>
+    void await_suspend(std::coroutine_handle<Promise> handle) noexcept
+    {
+        this->handle_ = handle;
+        this->promise_ = &handle.promise();
+        detail::exec::start(operation_state_);
+    }
+
+    Value await_resume()
+    {
+        if AGRPC_UNLIKELY (this->exception_)
+        {
+            std::rethrow_exception(this->exception_);
+        }
+        if constexpr (!std::is_void_v<Value>)
+        {
+            return static_cast<Value&&>(*this->value_);
+        }
+    }
+
+  private:
+    detail::exec::connect_result_t<Sender, Receiver> operation_state_;
+};
+
+// Follows `asio::co_spawn` and passes a default constructed value along with an exception. Types that cannot be default
+// constructed are passed as an optional that is empty in that case.
+template <class T>
+struct TaskSignature
+{
+    using Type = void(std::exception_ptr, detail::ConditionalT<std::is_default_constructible_v<T>, T, std::optional<T>>);
+};
+
+template <>
+struct TaskSignature<void>
+{
+    using Type = void(std::exception_ptr);
+};
+
+template <class T>
+using TaskSignatureT = typename detail::TaskSignature<T>::Type;
+
+// Queued once to start the Task on the GrpcContext and once more by the final awaiter of the Task to invoke the
+// completion handler from within the GrpcContext's run loop, where it may throw.
+template <class T, class CompletionHandler>
+class TaskSpawnOperation : public detail::QueueableOperationBase
+{
+  private:
+    using Base = detail::QueueableOperationBase;
+
+  public:
+    template <class Ch>
+    TaskSpawnOperation(Ch&& ch, agrpc::Task<T>&& task)
+        : Base(&do_complete), completion_handler_(static_cast<Ch&&>(ch)), task_(static_cast<agrpc::Task<T>&&>(task))
+    {
+    }
+
+    [[nodiscard]] auto get_allocator() const noexcept { return completion_handler_.get_allocator(); }
+
+  private:
+    static void do_complete(detail::OperationBase* op, detail::OperationResult result, agrpc::GrpcContext& grpc_context)
+    {
+        auto* self = static_cast<TaskSpawnOperation*>(static_cast<Base*>(op));
+        detail::AllocationGuard ptr{self, self->get_allocator()};
+        if AGRPC_UNLIKELY (detail::is_shutdown(result))
+        {
+            return;
+        }
+        const auto handle = detail::TaskAccess::handle(self->task_);
+        auto& promise = handle.promise();
+        if (!handle.done())
+        {
+            promise.root_operation_ = self;
+            promise.grpc_context_ = &grpc_context;
+            ptr.release();
+            handle.resume();
+            return;
+        }
+        auto ch{static_cast<detail::WorkTrackingCompletionHandler<CompletionHandler>&&>(self->completion_handler_)};
+        auto exception = static_cast<std::exception_ptr&&>(promise.exception_);
+        if constexpr (std::is_void_v<T>)
+        {
+            ptr.reset();
+            static_cast<decltype(ch)&&>(ch)(static_cast<std::exception_ptr&&>(exception));
+        }
+        else
+        {
+            std::optional<T> value{static_cast<std::optional<T>&&>(promise.value_)};
+            ptr.reset();
+            if constexpr (std::is_default_constructible_v<T>)
+            {
+                static_cast<decltype(ch)&&>(ch)(static_cast<std::exception_ptr&&>(exception),
+                                                value ? static_cast<T&&>(*value) : T{});
+            }
+            else
+            {
+                static_cast<decltype(ch)&&>(ch)(static_cast<std::exception_ptr&&>(exception),
+                                                static_cast<std::optional<T>&&>(value));
+            }
+        }
+    }
+
+    detail::WorkTrackingCompletionHandler<CompletionHandler> completion_handler_;
+    agrpc::Task<T> task_;
+};
+
+template <class T>
+struct TaskSpawnInitiation
+{
+    template <class CompletionHandler>
+    void operator()(CompletionHandler&& completion_handler, agrpc::Task<T>&& task) const
+    {
+        if AGRPC_UNLIKELY (detail::GrpcContextImplementation::is_shutdown(grpc_context_))
+        {
+            return;
+        }
+        using Operation = detail::TaskSpawnOperation<T, detail::RemoveCrefT<CompletionHandler>>;
+        const auto allocator = asio::get_associated_allocator(completion_handler);
+        auto operation = detail::allocate<Operation>(allocator, static_cast<CompletionHandler&&>(completion_handler),
+                                                     static_cast<agrpc::Task<T>&&>(task));
+        grpc_context_.work_started();
+        detail::GrpcContextImplementation::add_operation(grpc_context_, operation.release());
+    }
+
+    agrpc::GrpcContext& grpc_context_;
+};
+}
+
+AGRPC_NAMESPACE_END
+
+#ifdef AGRPC_ASIO_HAS_SENDER_RECEIVER
+#if !defined(BOOST_ASIO_HAS_DEDUCED_SET_DONE_MEMBER_TRAIT) && !defined(ASIO_HAS_DEDUCED_SET_DONE_MEMBER_TRAIT)
+template <class Value>
+struct agrpc::asio::traits::set_done_member<agrpc::detail::TaskReceiver<Value>>
+{
+    static constexpr bool is_valid = true;
+    static constexpr bool is_noexcept = true;
+
+    using result_type = void;
+};
+#endif
+
+#if !defined(BOOST_ASIO_HAS_DEDUCED_SET_VALUE_MEMBER_TRAIT) && !defined(ASIO_HAS_DEDUCED_SET_VALUE_MEMBER_TRAIT)
+template <class Value, class Vs>
+struct agrpc::asio::traits::set_value_member<agrpc::detail::TaskReceiver<Value>, Vs>
+{
+    static constexpr bool is_valid = true;
+    static constexpr bool is_noexcept = true;
+
+    using result_type = void;
+};
+#endif
+
+#if !defined(BOOST_ASIO_HAS_DEDUCED_SET_ERROR_MEMBER_TRAIT) && !defined(ASIO_HAS_DEDUCED_SET_ERROR_MEMBER_TRAIT)
+template <class Value, class E>
+struct agrpc::asio::traits::set_error_member<agrpc::detail::TaskReceiver<Value>, E>
+{
+    static constexpr bool is_valid = true;
+    static constexpr bool is_noexcept = true;
+
+    using result_type = void;
+};
+#endif
+#endif
+
+#endif
+
+#endif  // AGRPC_DETAIL_TASK_HPP
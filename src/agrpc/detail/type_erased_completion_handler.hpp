@@ -19,8 +19,12 @@
 #include <agrpc/detail/asio_forward.hpp>
 #include <agrpc/detail/atomic.hpp>
 #include <agrpc/detail/config.hpp>
+#include <agrpc/detail/memory.hpp>
 
 #include <cassert>
+#include <cstddef>
+#include <new>
+#include <type_traits>
 
 AGRPC_NAMESPACE_BEGIN()
 
@@ -42,6 +46,41 @@ void deallocate_and_invoke(void* data, Args... args)
     static_cast<CompletionHandler&&>(local_completion_handler)(static_cast<Args&&>(args)...);
 }
 
+template <class CompletionHandler, class... Args>
+void destroy_and_invoke(void* data, Args... args)
+{
+    auto* completion_handler = static_cast<CompletionHandler*>(data);
+    CompletionHandler local_completion_handler{static_cast<CompletionHandler&&>(*completion_handler)};
+    completion_handler->~CompletionHandler();
+    static_cast<CompletionHandler&&>(local_completion_handler)(static_cast<Args&&>(args)...);
+}
+
+// Inline storage for a type-erased completion handler. Handlers that do not fit are allocated using their associated
+// allocator instead.
+template <std::size_t Size>
+class CompletionHandlerBuffer
+{
+  public:
+    template <class CompletionHandler>
+    static constexpr bool FITS = sizeof(CompletionHandler) <= Size && alignof(CompletionHandler) <= detail::MAX_ALIGN &&
+                                 std::is_nothrow_move_constructible_v<CompletionHandler>;
+
+    [[nodiscard]] void* data() noexcept { return buffer_; }
+
+  private:
+    alignas(std::max_align_t) std::byte buffer_[Size];
+};
+
+template <>
+class CompletionHandlerBuffer<0>
+{
+  public:
+    template <class CompletionHandler>
+    static constexpr bool FITS = false;
+
+    [[nodiscard]] static void* data() noexcept { return nullptr; }
+};
+
 template <class Signature, class VoidPointer>
 class BasicTypeErasedCompletionHandler;
 
@@ -80,6 +119,21 @@ class BasicTypeErasedCompletionHandler<void(Args...), VoidPointer>
         complete_ = &detail::deallocate_and_invoke<Target, Args...>;
     }
 
+    // The buffer must not be reused before the completion handler has been completed.
+    template <class Target, class CompletionHandler, std::size_t BufferSize>
+    void emplace(CompletionHandler&& ch, detail::CompletionHandlerBuffer<BufferSize>& buffer)
+    {
+        if constexpr (detail::CompletionHandlerBuffer<BufferSize>::template FITS<Target>)
+        {
+            complete_ = &detail::destroy_and_invoke<Target, Args...>;
+            completion_handler_ = ::new (buffer.data()) Target(static_cast<CompletionHandler&&>(ch));
+        }
+        else
+        {
+            this->template emplace<Target>(static_cast<CompletionHandler&&>(ch));
+        }
+    }
+
     detail::TypeErasedCompletionHandler<void(Args...)> release() noexcept
     {
         return {release_completion_handler(), complete_};
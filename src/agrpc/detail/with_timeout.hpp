@@ -0,0 +1,136 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_DETAIL_WITH_TIMEOUT_HPP
+#define AGRPC_DETAIL_WITH_TIMEOUT_HPP
+
+#include <agrpc/detail/alarm_pool.hpp>
+#include <agrpc/detail/config.hpp>
+#include <agrpc/detail/grpc_context_implementation.hpp>
+#include <agrpc/detail/grpc_sender.hpp>
+#include <agrpc/detail/operation_base.hpp>
+#include <agrpc/grpc_context.hpp>
+
+AGRPC_NAMESPACE_BEGIN()
+
+namespace detail
+{
+template <class InitiatingFunction, class Deadline>
+struct WithTimeoutInitiation
+{
+    InitiatingFunction initiating_function_;
+    Deadline deadline_;
+};
+
+template <class InitiatingFunction, class Deadline, class Context>
+class WithTimeoutSenderImplementation : public detail::GrpcSenderImplementationBase
+{
+  private:
+    template <bool IsAlarm>
+    struct Tag : detail::OperationBase
+    {
+        Tag() noexcept : detail::OperationBase(&do_complete) {}
+
+        static void do_complete(detail::OperationBase* op, detail::OperationResult result,
+                                agrpc::GrpcContext& grpc_context)
+        {
+            static_cast<Tag*>(op)->self_->template on_tag_complete<IsAlarm>(result, grpc_context);
+        }
+
+        WithTimeoutSenderImplementation* self_;
+    };
+
+  public:
+    using Initiation = detail::WithTimeoutInitiation<InitiatingFunction, Deadline>;
+
+    WithTimeoutSenderImplementation(Context& context) noexcept : context_(context) {}
+
+    WithTimeoutSenderImplementation(WithTimeoutSenderImplementation&& other) noexcept : context_(other.context_) {}
+
+    template <class Init>
+    void initiate(Init init, const Initiation& initiation)
+    {
+        auto& grpc_context = init.grpc_context();
+        operation_ = init.self();
+        step_tag_.self_ = this;
+        alarm_tag_.self_ = this;
+        // The alarm pool may only be accessed from the GrpcContext's thread, elsewhere a new alarm is created. Either
+        // way it is returned to the pool on completion, which always happens on that thread.
+        alarm_ = detail::GrpcContextImplementation::running_in_this_thread(grpc_context)
+                     ? detail::GrpcContextImplementation::alarm_pool(grpc_context).acquire()
+                     : detail::AlarmPool::create();
+        // The operation itself accounts for one outstanding tag, the alarm is the second one.
+        grpc_context.work_started();
+        alarm_->alarm_.Set(grpc_context.get_completion_queue(), initiation.deadline_, &alarm_tag_);
+        initiation.initiating_function_(grpc_context, &step_tag_);
+    }
+
+    template <class OnDone>
+    static void done(OnDone on_done, bool ok)
+    {
+        on_done(ok);
+    }
+
+  private:
+    template <bool IsAlarm>
+    void on_tag_complete(detail::OperationResult result, agrpc::GrpcContext& grpc_context)
+    {
+        if (detail::is_shutdown(result))
+        {
+            is_shutdown_ = true;
+        }
+        if constexpr (IsAlarm)
+        {
+            is_alarm_done_ = true;
+            if (!is_step_done_ && detail::is_ok(result))
+            {
+                context_.TryCancel();
+            }
+        }
+        else
+        {
+            is_step_done_ = true;
+            step_ok_ = detail::is_ok(result);
+            if (!is_alarm_done_)
+            {
+                alarm_->alarm_.Cancel();
+            }
+        }
+        // Both tags are embedded into this object, therefore the operation may only complete once both have been
+        // delivered by the completion queue.
+        if (is_alarm_done_ && is_step_done_)
+        {
+            detail::GrpcContextImplementation::alarm_pool(grpc_context).release(alarm_);
+            const auto final_result = is_shutdown_ ? detail::OperationResult::SHUTDOWN_NOT_OK
+                                      : step_ok_   ? detail::OperationResult::OK
+                                                   : detail::OperationResult::NOT_OK;
+            operation_->complete(final_result, grpc_context);
+        }
+    }
+
+    Context& context_;
+    detail::OperationBase* operation_;
+    Tag<false> step_tag_;
+    Tag<true> alarm_tag_;
+    detail::PooledAlarm* alarm_;
+    bool is_step_done_{};
+    bool is_alarm_done_{};
+    bool step_ok_{};
+    bool is_shutdown_{};
+};
+}
+
+AGRPC_NAMESPACE_END
+
+#endif  // AGRPC_DETAIL_WITH_TIMEOUT_HPP
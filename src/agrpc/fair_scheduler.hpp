@@ -0,0 +1,243 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_AGRPC_FAIR_SCHEDULER_HPP
+#define AGRPC_AGRPC_FAIR_SCHEDULER_HPP
+
+#include <agrpc/detail/asio_forward.hpp>
+#include <agrpc/detail/config.hpp>
+
+#if defined(AGRPC_STANDALONE_ASIO) || defined(AGRPC_BOOST_ASIO)
+
+#include <agrpc/detail/intrusive_queue.hpp>
+#include <agrpc/detail/operation_base.hpp>
+#include <agrpc/detail/scheduler.hpp>
+#include <agrpc/detail/utility.hpp>
+#include <agrpc/grpc_context.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+AGRPC_NAMESPACE_BEGIN()
+
+/**
+ * @brief (experimental) Weighted fair scheduling of completion handlers across classes of work
+ *
+ * A GrpcContext runs ready completion handlers in the order in which they became ready. When it is shared among
+ * tenants then a burst of work from one of them delays the work of all others. Completion handlers that are associated
+ * with an executor of this scheduler are instead tagged with a class id, e.g. one per tenant, and placed into a queue
+ * per class. The queues are serviced by deficit round robin: In every round each class with pending work may run as
+ * many handlers as its weight, which defaults to one. Work that is not submitted through this scheduler is unaffected.
+ *
+ * The scheduler must outlive all work that has been submitted through its executors, e.g. by destroying it after the
+ * GrpcContext has run out of work.
+ *
+ * Example:
+ *
+ * @snippet server.cpp fair-scheduler
+ *
+ * @since 2.5.0
+ */
+class FairScheduler : private detail::SchedulerBase<std::size_t>
+{
+  private:
+    using Base = detail::SchedulerBase<std::size_t>;
+
+  public:
+    /**
+     * @brief The type of the class id
+     */
+    using Key = std::size_t;
+
+    /**
+     * @brief The executor type
+     *
+     * Refers to the GrpcContext, never blocks and supports the outstanding_work property.
+     */
+    using executor_type = detail::BasicSchedulerExecutor<FairScheduler>;
+
+    /**
+     * @brief Construct from a GrpcContext and the number of classes
+     *
+     * Class ids range from zero to `class_count - 1`.
+     */
+    FairScheduler(agrpc::GrpcContext& grpc_context, std::size_t class_count)
+        : Base(grpc_context, &do_push, &do_drain), classes_(class_count)
+    {
+        active_.reserve(class_count);
+        round_.reserve(class_count);
+    }
+
+    /**
+     * @brief Get an executor whose handlers belong to the given class
+     *
+     * Thread-safe
+     *
+     * @throws std::out_of_range If `class_id` is not less than `class_count()`.
+     */
+    [[nodiscard]] executor_type get_executor(Key class_id)
+    {
+        if AGRPC_UNLIKELY (class_id >= classes_.size())
+        {
+            AGRPC_THROW(std::out_of_range("agrpc::FairScheduler: class id out of range"));
+        }
+        return executor_type{*this, class_id};
+    }
+
+    /**
+     * @brief Get the GrpcContext
+     *
+     * Thread-safe
+     */
+    using Base::grpc_context;
+
+    /**
+     * @brief Number of classes
+     *
+     * Thread-safe
+     */
+    [[nodiscard]] std::size_t class_count() const noexcept { return classes_.size(); }
+
+    /**
+     * @brief Set the number of handlers that a class may run per round
+     *
+     * Must be called from the thread that runs the GrpcContext.
+     *
+     * @param weight Must be greater than zero.
+     */
+    void set_weight(Key class_id, std::size_t weight) noexcept
+    {
+        assert(weight > 0 && "The weight must be greater than zero");
+        classes_[class_id].weight_ = weight;
+    }
+
+    /**
+     * @brief Number of handlers that a class may run per round
+     *
+     * Must be called from the thread that runs the GrpcContext.
+     */
+    [[nodiscard]] std::size_t weight(Key class_id) const noexcept { return classes_[class_id].weight_; }
+
+    /**
+     * @brief Number of handlers of a class that are ready to run
+     *
+     * Handlers that have been submitted from another thread are included once they have arrived in the thread that
+     * runs the GrpcContext. Must be called from the thread that runs the GrpcContext.
+     */
+    [[nodiscard]] std::size_t size(Key class_id) const noexcept { return classes_[class_id].size_; }
+
+  private:
+    friend executor_type;
+
+    struct Class
+    {
+        detail::IntrusiveQueue<detail::QueueableOperationBase> queue_;
+        std::size_t size_{};
+        std::size_t weight_{1};
+        std::size_t deficit_{};
+        bool is_active_{};
+    };
+
+    static Operation* pop(Class& cls) noexcept
+    {
+        --cls.size_;
+        return static_cast<Operation*>(cls.queue_.pop_front());
+    }
+
+    // Classes that still have work take part in the next round.
+    void requeue(Key class_id) noexcept
+    {
+        auto& cls = classes_[class_id];
+        if (cls.queue_.empty())
+        {
+            cls.deficit_ = 0;
+            cls.is_active_ = false;
+        }
+        else
+        {
+            active_.push_back(class_id);
+        }
+    }
+
+    static void do_push(Base* base, Operation* operation)
+    {
+        auto& self = static_cast<FairScheduler&>(*base);
+        auto& cls = self.classes_[operation->key_];
+        cls.queue_.push_back(operation);
+        ++cls.size_;
+        if (!cls.is_active_)
+        {
+            cls.is_active_ = true;
+            self.active_.push_back(operation->key_);
+        }
+    }
+
+    static void do_drain(Base* base, detail::OperationResult result)
+    {
+        auto& self = static_cast<FairScheduler&>(*base);
+        auto& grpc_context = self.grpc_context();
+        if AGRPC_UNLIKELY (detail::is_shutdown(result))
+        {
+            for (auto& cls : self.classes_)
+            {
+                while (!cls.queue_.empty())
+                {
+                    pop(cls)->complete(detail::OperationResult::SHUTDOWN_NOT_OK, grpc_context);
+                }
+                cls.deficit_ = 0;
+                cls.is_active_ = false;
+            }
+            self.active_.clear();
+            self.on_drained(false);
+            return;
+        }
+        // One round per drain so that completion queue events and other local work are not starved. Classes that
+        // become active during the round wait for the next one.
+        self.round_.swap(self.active_);
+        std::size_t index{};
+        detail::ScopeGuard guard{[&]
+                                 {
+                                     for (; index < self.round_.size(); ++index)
+                                     {
+                                         self.requeue(self.round_[index]);
+                                     }
+                                     self.round_.clear();
+                                     self.on_drained(!self.active_.empty());
+                                 }};
+        for (; index < self.round_.size(); ++index)
+        {
+            const auto class_id = self.round_[index];
+            auto& cls = self.classes_[class_id];
+            cls.deficit_ += cls.weight_;
+            while (cls.deficit_ > 0 && !cls.queue_.empty())
+            {
+                --cls.deficit_;
+                pop(cls)->complete(detail::OperationResult::OK, grpc_context);
+            }
+            self.requeue(class_id);
+        }
+    }
+
+    std::vector<Class> classes_;
+    std::vector<Key> active_;
+    std::vector<Key> round_;
+};
+
+AGRPC_NAMESPACE_END
+
+#endif
+
+#endif  // AGRPC_AGRPC_FAIR_SCHEDULER_HPP
@@ -0,0 +1,178 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_AGRPC_GENERIC_ROUTER_HPP
+#define AGRPC_AGRPC_GENERIC_ROUTER_HPP
+
+#include <agrpc/detail/config.hpp>
+#include <agrpc/detail/generic_router.hpp>
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+AGRPC_NAMESPACE_BEGIN()
+
+/**
+ * @brief (experimental) Full method name of an RPC as reported by `grpc::GenericServerContext::method()`
+ *
+ * E.g. for `agrpc::RPC<&example::v1::Example::Stub::PrepareAsyncUnary>` the return value would be
+ * `"/example.v1.Example/Unary"`.
+ *
+ * @tparam RPC A type with static `service_name()` and `method_name()` member functions, like `agrpc::RPC`.
+ *
+ * @since 2.5.0
+ */
+template <class RPC>
+std::string generic_method_name()
+{
+    constexpr std::string_view service = RPC::service_name();
+    constexpr std::string_view method = RPC::method_name();
+    std::string name;
+    name.reserve(service.size() + method.size() + 2);
+    name.append(1, '/').append(service).append(1, '/').append(method);
+    return name;
+}
+
+/**
+ * @brief (experimental) Route generic RPCs to handlers by method name
+ *
+ * Immutable table from full method names, e.g. `"/example.v1.Example/Unary"`, to handlers. It is built once at
+ * startup into a collision-free (perfect) hash table, so that a lookup hashes the method name once and compares it
+ * against a single candidate, independent of the number of routes and without allocating memory.
+ *
+ * The router can be passed to `agrpc::repeatedly_request(grpc::AsyncGenericService&, ...)` directly, e.g. through
+ * `asio::bind_executor(grpc_context, std::cref(router))`. It then invokes the handler of the requested method, or the
+ * fallback handler for unknown methods, with the `agrpc::GenericRepeatedlyRequestContext`. Alternatively, `find()` can
+ * be used from within an existing request handler.
+ *
+ * Example:
+ *
+ * @snippet server.cpp generic-router-server-side
+ *
+ * @tparam Handler The handler type, e.g. a function pointer.
+ *
+ * @since 2.5.0
+ */
+template <class Handler>
+class GenericRouter
+{
+  public:
+    /**
+     * @brief The handler type
+     */
+    using handler_type = Handler;
+
+    /**
+     * @brief A route from a full method name to its handler
+     */
+    using route_type = std::pair<std::string, Handler>;
+
+    /**
+     * @brief Build the routing table
+     *
+     * @param routes If a method name occurs more than once then only its first route is used and the others are
+     * reported by `duplicate_methods()`.
+     * @param fallback Handler for methods that have no route.
+     */
+    GenericRouter(std::vector<route_type> routes, Handler fallback)
+        : index_(take_methods(routes)), handlers_(take_handlers(routes)), fallback_(std::move(fallback))
+    {
+    }
+
+    /**
+     * @brief Find the handler of a method
+     *
+     * @return The fallback handler if there is no route for `method`.
+     */
+    [[nodiscard]] const Handler& find(std::string_view method) const noexcept
+    {
+        const auto index = index_.find(method);
+        return index == detail::PerfectHashIndex::NPOS ? fallback_ : handlers_[index];
+    }
+
+    /**
+     * @brief Is there a route for the given method?
+     */
+    [[nodiscard]] bool contains(std::string_view method) const noexcept
+    {
+        return index_.find(method) != detail::PerfectHashIndex::NPOS;
+    }
+
+    /**
+     * @brief Number of routes
+     */
+    [[nodiscard]] std::size_t size() const noexcept { return index_.size(); }
+
+    /**
+     * @brief Method names of the routes that have been ignored because an earlier route has the same name
+     *
+     * Empty if all method names passed to the constructor were unique. Meant to be checked once after construction.
+     */
+    [[nodiscard]] std::vector<std::string_view> duplicate_methods() const
+    {
+        std::vector<std::string_view> methods;
+        methods.reserve(index_.duplicates().size());
+        for (const auto index : index_.duplicates())
+        {
+            methods.emplace_back(index_.key(index));
+        }
+        return methods;
+    }
+
+    /**
+     * @brief Invoke the handler of the context's method
+     *
+     * @param context An `agrpc::GenericRepeatedlyRequestContext` or any other object whose `server_context()` member
+     * function returns a `grpc::GenericServerContext`.
+     */
+    template <class RPCContext>
+    void operator()(RPCContext&& context) const
+    {
+        std::invoke(find(context.server_context().method()), static_cast<RPCContext&&>(context));
+    }
+
+  private:
+    static std::vector<std::string> take_methods(std::vector<route_type>& routes)
+    {
+        std::vector<std::string> methods;
+        methods.reserve(routes.size());
+        for (auto& route : routes)
+        {
+            methods.push_back(std::move(route.first));
+        }
+        return methods;
+    }
+
+    static std::vector<Handler> take_handlers(std::vector<route_type>& routes)
+    {
+        std::vector<Handler> handlers;
+        handlers.reserve(routes.size());
+        for (auto& route : routes)
+        {
+            handlers.push_back(std::move(route.second));
+        }
+        return handlers;
+    }
+
+    detail::PerfectHashIndex index_;
+    std::vector<Handler> handlers_;
+    Handler fallback_;
+};
+
+AGRPC_NAMESPACE_END
+
+#endif  // AGRPC_AGRPC_GENERIC_ROUTER_HPP
@@ -56,8 +56,9 @@ struct GetCompletionQueueFn
      *
      * @since 2.0.0
      */
-    template <class Executor>
-    [[nodiscard]] grpc::CompletionQueue* operator()(const agrpc::BasicGrpcStream<Executor>& grpc_stream) const noexcept
+    template <class Executor, std::size_t Capacity>
+    [[nodiscard]] grpc::CompletionQueue* operator()(
+        const agrpc::BasicGrpcStream<Executor, Capacity>& grpc_stream) const noexcept
     {
         return detail::get_completion_queue(grpc_stream);
     }
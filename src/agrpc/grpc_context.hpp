@@ -15,6 +15,7 @@
 #ifndef AGRPC_AGRPC_GRPC_CONTEXT_HPP
 #define AGRPC_AGRPC_GRPC_CONTEXT_HPP
 
+#include <agrpc/detail/alarm_pool.hpp>
 #include <agrpc/detail/asio_forward.hpp>
 #include <agrpc/detail/atomic_intrusive_queue.hpp>
 #include <agrpc/detail/config.hpp>
@@ -27,10 +28,12 @@
 #include <agrpc/detail/memory_resource.hpp>
 #include <agrpc/detail/notify_when_done.hpp>
 #include <agrpc/detail/operation_base.hpp>
+#include <agrpc/detail/parked_operations.hpp>
 #include <grpcpp/alarm.h>
 #include <grpcpp/completion_queue.h>
 
 #include <atomic>
+#include <cstddef>
 #include <memory>
 
 AGRPC_NAMESPACE_BEGIN()
@@ -286,16 +289,45 @@ class GrpcContext
      */
     [[nodiscard]] grpc::ServerCompletionQueue* get_server_completion_queue() noexcept;
 
+    /**
+     * @brief (experimental) Limit the number of completion handlers that run between polls of the completion queue
+     *
+     * By default, all completion handlers that are ready when the GrpcContext looks at its local queue are run before
+     * the `grpc::CompletionQueue` is polled again. A long chain of handlers, e.g. one that posts many continuations,
+     * therefore delays the processing of completion queue events. With a budget of `n`, at most `n` handlers are run
+     * before the completion queue is polled once without waiting. The remaining handlers run afterwards, before any
+     * handler that has become ready in the meantime. Zero means unlimited, which is the default.
+     *
+     * See also `agrpc::yield`.
+     *
+     * Not thread-safe. Call before run() or from the thread that runs the GrpcContext.
+     *
+     * @since 2.5.0
+     */
+    void set_local_work_budget(std::size_t budget) noexcept;
+
+    /**
+     * @brief (experimental) Get the number of completion handlers that run between polls of the completion queue
+     *
+     * Zero means unlimited.
+     *
+     * @since 2.5.0
+     */
+    [[nodiscard]] std::size_t local_work_budget() const noexcept;
+
   private:
     using RemoteWorkQueue = detail::AtomicIntrusiveQueue<detail::QueueableOperationBase>;
     using LocalWorkQueue = detail::IntrusiveQueue<detail::QueueableOperationBase>;
     using NotifyWhenDoneList = detail::IntrusiveList<detail::NotfiyWhenDoneSenderImplementation>;
+    using ParkedOperationsList = detail::IntrusiveList<detail::ParkedOperations>;
 
     friend detail::GrpcContextImplementation;
 
     bool run_until_impl(::gpr_timespec deadline);
 
     grpc::Alarm work_alarm_;
+    grpc::Alarm yield_alarm_;
+    detail::YieldOperation yield_operation_;
     std::atomic_long outstanding_work_{};
     std::atomic_bool stopped_{false};
     std::atomic_bool shutdown_{false};
@@ -303,7 +335,11 @@ class GrpcContext
     std::unique_ptr<grpc::CompletionQueue> completion_queue_{std::make_unique<grpc::CompletionQueue>()};
     detail::GrpcContextLocalMemoryResource local_resource_;
     LocalWorkQueue local_work_queue_;
+    LocalWorkQueue yielded_work_queue_;
+    std::size_t local_work_budget_{};
     NotifyWhenDoneList notify_when_done_list_;
+    ParkedOperationsList parked_operations_list_;
+    detail::AlarmPool alarm_pool_;
     RemoteWorkQueue remote_work_queue_{false};
 };
 
@@ -79,7 +79,8 @@ class BasicGrpcExecutor
     {
     }
 
-#if defined(AGRPC_UNIFEX) || (defined(AGRPC_BOOST_ASIO) && !defined(BOOST_ASIO_NO_TS_EXECUTORS)) || \
+#if defined(AGRPC_UNIFEX) || defined(AGRPC_STDEXEC) || \
+    (defined(AGRPC_BOOST_ASIO) && !defined(BOOST_ASIO_NO_TS_EXECUTORS)) || \
     (defined(AGRPC_STANDALONE_ASIO) && !defined(ASIO_NO_TS_EXECUTORS))
     /**
      * @brief Get the underlying GrpcContext
@@ -147,7 +148,8 @@ class BasicGrpcExecutor
         return detail::GrpcContextImplementation::running_in_this_thread(*this->grpc_context());
     }
 
-#if !defined(AGRPC_UNIFEX) && !defined(BOOST_ASIO_NO_TS_EXECUTORS) && !defined(ASIO_NO_TS_EXECUTORS)
+#if !defined(AGRPC_UNIFEX) && !defined(AGRPC_STDEXEC) && !defined(BOOST_ASIO_NO_TS_EXECUTORS) && \
+    !defined(ASIO_NO_TS_EXECUTORS)
     /**
      * @brief Signal the GrpcContext that an asynchronous operation is in progress
      *
@@ -223,7 +225,7 @@ class BasicGrpcExecutor
     }
 #endif
 
-#if !defined(AGRPC_UNIFEX)
+#if !defined(AGRPC_UNIFEX) && !defined(AGRPC_STDEXEC)
     /**
      * @brief Request the GrpcContext to invoke the given function object
      *
@@ -511,7 +513,7 @@ struct agrpc::detail::container::uses_allocator<agrpc::BasicGrpcExecutor<Allocat
 {
 };
 
-#if !defined(AGRPC_UNIFEX) && !defined(BOOST_ASIO_HAS_DEDUCED_EQUALITY_COMPARABLE_TRAIT) && \
+#if !defined(AGRPC_UNIFEX) && !defined(AGRPC_STDEXEC) && !defined(BOOST_ASIO_HAS_DEDUCED_EQUALITY_COMPARABLE_TRAIT) && \
     !defined(ASIO_HAS_DEDUCED_EQUALITY_COMPARABLE_TRAIT)
 template <class Allocator, std::uint32_t Options>
 struct agrpc::asio::traits::equality_comparable<agrpc::BasicGrpcExecutor<Allocator, Options>>
@@ -521,7 +523,7 @@ struct agrpc::asio::traits::equality_comparable<agrpc::BasicGrpcExecutor<Allocat
 };
 #endif
 
-#if !defined(AGRPC_UNIFEX) && !defined(BOOST_ASIO_HAS_DEDUCED_EXECUTE_MEMBER_TRAIT) && \
+#if !defined(AGRPC_UNIFEX) && !defined(AGRPC_STDEXEC) && !defined(BOOST_ASIO_HAS_DEDUCED_EXECUTE_MEMBER_TRAIT) && \
     !defined(ASIO_HAS_DEDUCED_EXECUTE_MEMBER_TRAIT)
 template <class Allocator, std::uint32_t Options, class F>
 struct agrpc::asio::traits::execute_member<agrpc::BasicGrpcExecutor<Allocator, Options>, F>
@@ -533,7 +535,7 @@ struct agrpc::asio::traits::execute_member<agrpc::BasicGrpcExecutor<Allocator, O
 };
 #endif
 
-#if !defined(AGRPC_UNIFEX) && !defined(BOOST_ASIO_HAS_DEDUCED_REQUIRE_MEMBER_TRAIT) && \
+#if !defined(AGRPC_UNIFEX) && !defined(AGRPC_STDEXEC) && !defined(BOOST_ASIO_HAS_DEDUCED_REQUIRE_MEMBER_TRAIT) && \
     !defined(ASIO_HAS_DEDUCED_REQUIRE_MEMBER_TRAIT)
 template <class Allocator, std::uint32_t Options>
 struct agrpc::asio::traits::require_member<agrpc::BasicGrpcExecutor<Allocator, Options>,
@@ -597,7 +599,7 @@ struct agrpc::asio::traits::require_member<agrpc::BasicGrpcExecutor<Allocator, O
 };
 #endif
 
-#if !defined(AGRPC_UNIFEX) && !defined(BOOST_ASIO_HAS_DEDUCED_PREFER_MEMBER_TRAIT) && \
+#if !defined(AGRPC_UNIFEX) && !defined(AGRPC_STDEXEC) && !defined(BOOST_ASIO_HAS_DEDUCED_PREFER_MEMBER_TRAIT) && \
     !defined(ASIO_HAS_DEDUCED_PREFER_MEMBER_TRAIT)
 template <class Allocator, std::uint32_t Options>
 struct agrpc::asio::traits::prefer_member<agrpc::BasicGrpcExecutor<Allocator, Options>,
@@ -621,7 +623,7 @@ struct agrpc::asio::traits::prefer_member<agrpc::BasicGrpcExecutor<Allocator, Op
 };
 #endif
 
-#if !defined(AGRPC_UNIFEX)
+#if !defined(AGRPC_UNIFEX) && !defined(AGRPC_STDEXEC)
 template <class Allocator, std::uint32_t Options, class Property>
 struct agrpc::asio::traits::query_static_constexpr_member<
     agrpc::BasicGrpcExecutor<Allocator, Options>, Property,
@@ -655,7 +657,7 @@ struct agrpc::asio::traits::query_static_constexpr_member<
 };
 #endif
 
-#if !defined(AGRPC_UNIFEX) && !defined(BOOST_ASIO_HAS_DEDUCED_QUERY_MEMBER_TRAIT) && \
+#if !defined(AGRPC_UNIFEX) && !defined(AGRPC_STDEXEC) && !defined(BOOST_ASIO_HAS_DEDUCED_QUERY_MEMBER_TRAIT) && \
     !defined(ASIO_HAS_DEDUCED_QUERY_MEMBER_TRAIT)
 template <class Allocator, std::uint32_t Options>
 struct agrpc::asio::traits::query_member<agrpc::BasicGrpcExecutor<Allocator, Options>,
@@ -20,16 +20,15 @@
 
 #ifdef AGRPC_ASIO_HAS_CANCELLATION_SLOT
 
-#include <agrpc/bind_allocator.hpp>
-#include <agrpc/cancel_safe.hpp>
 #include <agrpc/default_completion_token.hpp>
-#include <agrpc/detail/async_initiate.hpp>
+#include <agrpc/detail/forward.hpp>
 #include <agrpc/detail/get_completion_queue.hpp>
-#include <agrpc/detail/utility.hpp>
+#include <agrpc/detail/grpc_stream.hpp>
 #include <agrpc/grpc_context.hpp>
 #include <agrpc/grpc_executor.hpp>
 
-#include <atomic>
+#include <cstddef>
+#include <memory>
 
 AGRPC_NAMESPACE_BEGIN()
 
@@ -38,13 +37,22 @@ AGRPC_NAMESPACE_BEGIN()
  *
  * Lightweight, IoObject-like class with cancellation safety for RPC functions.
  *
+ * Up to `Capacity` operations may be running or awaiting `next()` at the same time. Their results are delivered by
+ * `next()` in the order in which the operations completed. Since `next()` does not tell which operation has
+ * completed, all operations that are initiated at the same time should be of the same kind, e.g. several alarms. Use
+ * `agrpc::BasicSelector` to tell operations apart, e.g. a read and a write on a bidirectional stream.
+ *
+ * Operations must complete with `bool`, which is the case for all RPC functions and `agrpc::wait`.
+ *
+ * @tparam Capacity The maximum number of concurrently initiated operations (since 2.5.0).
+ *
  * @since 1.7.0 (and Boost.Asio 1.77.0)
  */
-template <class Executor>
-class BasicGrpcStream
+template <class Executor, std::size_t Capacity>
+class BasicGrpcStream : private detail::GrpcStreamBase<Executor, Capacity>
 {
   private:
-    class CompletionHandler;
+    using Base = detail::GrpcStreamBase<Executor, Capacity>;
 
   public:
     /**
@@ -61,40 +69,65 @@ class BasicGrpcStream
         /**
          * @brief The stream type when rebound to the specified executor
          */
-        using other = BasicGrpcStream<OtherExecutor>;
+        using other = BasicGrpcStream<OtherExecutor, Capacity>;
     };
 
     /**
      * @brief Construct from an executor
      */
     template <class Exec>
-    explicit BasicGrpcStream(Exec&& executor) noexcept : executor_(static_cast<Exec&&>(executor))
+    explicit BasicGrpcStream(Exec&& executor) noexcept : Base(static_cast<Exec&&>(executor))
     {
     }
 
     /**
      * @brief Construct from a `agrpc::GrpcContext`
      */
-    explicit BasicGrpcStream(agrpc::GrpcContext& grpc_context) noexcept : executor_(grpc_context.get_executor()) {}
+    explicit BasicGrpcStream(agrpc::GrpcContext& grpc_context) noexcept : Base(grpc_context.get_executor()) {}
 
     /**
      * @brief Get the associated executor
      *
      * Thread-safe
      */
-    [[nodiscard]] const executor_type& get_executor() const noexcept { return executor_; }
+    [[nodiscard]] const executor_type& get_executor() const noexcept { return Base::executor(); }
 
     /**
      * @brief Is an operation currently running?
      *
      * Thread-safe
      */
-    [[nodiscard]] bool is_running() const noexcept { return running_.load(std::memory_order_relaxed); }
+    [[nodiscard]] bool is_running() const noexcept { return running_count() != 0; }
+
+    /**
+     * @brief Number of initiated operations that have not completed yet
+     *
+     * Thread-safe
+     *
+     * @since 2.5.0
+     */
+    [[nodiscard]] std::size_t running_count() const noexcept { return Base::running_count(); }
 
     /**
-     * @brief Wait for the initiated operation to complete
+     * @brief Can another operation be initiated?
      *
-     * Only one call to `next()` may be outstanding at a time.
+     * False if `Capacity` operations are running or awaiting `next()`.
+     *
+     * @since 2.5.0
+     */
+    [[nodiscard]] bool has_capacity() const noexcept { return Base::has_capacity(); }
+
+    /**
+     * @brief The maximum number of concurrently initiated operations
+     *
+     * @since 2.5.0
+     */
+    [[nodiscard]] static constexpr std::size_t capacity() noexcept { return Capacity; }
+
+    /**
+     * @brief Wait for the next initiated operation to complete
+     *
+     * Only one call to `next()` may be outstanding at a time. Results are delivered in completion order.
      *
      * **Per-Operation Cancellation**
      *
@@ -103,41 +136,40 @@ class BasicGrpcStream
     template <class CompletionToken = asio::default_completion_token_t<Executor>>
     auto next(CompletionToken&& token = asio::default_completion_token_t<Executor>{})
     {
-        return safe_.wait(static_cast<CompletionToken&&>(token));
+        return Base::next(static_cast<CompletionToken&&>(token));
     }
 
     /**
      * @brief Initiate an operation using the specified allocator
      *
-     * Only one operation may be running at a time.
+     * May only be called while `has_capacity()` is true.
      */
     template <class Allocator, class Function, class... Args>
     BasicGrpcStream& initiate(std::allocator_arg_t, Allocator allocator, Function&& function, Args&&... args)
     {
-        running_.store(true, std::memory_order_relaxed);
-        std::invoke(static_cast<Function&&>(function), static_cast<Args&&>(args)...,
-                    agrpc::bind_allocator(allocator, CompletionHandler{*this}));
+        Base::initiate(std::allocator_arg, allocator, {}, static_cast<Function&&>(function),
+                       static_cast<Args&&>(args)...);
         return *this;
     }
 
     /**
      * @brief Initiate an operation
      *
-     * Only one operation may be running at a time.
+     * May only be called while `has_capacity()` is true.
      */
     template <class Function, class... Args>
     BasicGrpcStream& initiate(Function&& function, Args&&... args)
     {
-        running_.store(true, std::memory_order_relaxed);
-        std::invoke(static_cast<Function&&>(function), static_cast<Args&&>(args)..., CompletionHandler{*this});
+        Base::initiate({}, static_cast<Function&&>(function), static_cast<Args&&>(args)...);
         return *this;
     }
 
     /**
-     * @brief Either wait for the initiated operation to complete or complete immediately
+     * @brief Wait for all initiated operations to complete
      *
-     * If the initiated operation has already completed then the completion handler will be invoked in a manner
-     * equivalent to using `asio::post`.
+     * Discards the results that have not been obtained through `next()` and completes with the last one. Completes
+     * immediately, in a manner equivalent to using `asio::post`, if no operation has been initiated since the last
+     * result was obtained. Should be called before the stream is destroyed.
      *
      * **Per-Operation Cancellation**
      *
@@ -146,37 +178,8 @@ class BasicGrpcStream
     template <class CompletionToken = asio::default_completion_token_t<Executor>>
     auto cleanup(CompletionToken&& token = asio::default_completion_token_t<Executor>{})
     {
-        if (is_running())
-        {
-            return safe_.wait(static_cast<CompletionToken&&>(token));
-        }
-        return detail::async_initiate_immediate_completion<void(detail::ErrorCode, bool)>(
-            static_cast<CompletionToken&&>(token));
+        return Base::cleanup(static_cast<CompletionToken&&>(token));
     }
-
-  private:
-    class CompletionHandler
-    {
-      public:
-        using executor_type = Executor;
-
-        explicit CompletionHandler(BasicGrpcStream& stream) : self_(stream) {}
-
-        void operator()(bool ok)
-        {
-            self_.running_.store(false, std::memory_order_relaxed);
-            self_.safe_.token()(ok);
-        }
-
-        [[nodiscard]] const executor_type& get_executor() const noexcept { return self_.executor_; }
-
-      private:
-        BasicGrpcStream& self_;
-    };
-
-    Executor executor_;
-    agrpc::GrpcCancelSafe safe_;
-    std::atomic_bool running_{};
 };
 
 /**
@@ -189,8 +192,8 @@ using GrpcStream = agrpc::DefaultCompletionToken::as_default_on_t<agrpc::BasicGr
 // Implementation details
 namespace detail
 {
-template <class Executor>
-grpc::CompletionQueue* get_completion_queue(const agrpc::BasicGrpcStream<Executor>& grpc_stream) noexcept
+template <class Executor, std::size_t Capacity>
+grpc::CompletionQueue* get_completion_queue(const agrpc::BasicGrpcStream<Executor, Capacity>& grpc_stream) noexcept
 {
     return detail::get_completion_queue(grpc_stream.get_executor());
 }
@@ -0,0 +1,152 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_AGRPC_MESSAGE_POOL_HPP
+#define AGRPC_AGRPC_MESSAGE_POOL_HPP
+
+#include <agrpc/detail/config.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+AGRPC_NAMESPACE_BEGIN()
+
+template <class Message>
+class MessagePool;
+
+namespace detail
+{
+template <class Message>
+class MessagePoolDeleter
+{
+  public:
+    MessagePoolDeleter() = default;
+
+    explicit MessagePoolDeleter(agrpc::MessagePool<Message>& pool) noexcept : pool_(&pool) {}
+
+    void operator()(Message* message) const noexcept { pool_->recycle(message); }
+
+  private:
+    agrpc::MessagePool<Message>* pool_{};
+};
+}
+
+/**
+ * @brief (experimental) Pool of reusable messages for high-rate streaming reads
+ *
+ * Reading every message of a stream into a freshly constructed protobuf re-allocates all of its nested strings and
+ * repeated fields. Messages obtained from this pool are returned to it upon destruction of the `pointer` instead of
+ * being deleted. They are `Clear()`ed, which keeps the capacity of their fields, so that the next read deserializes
+ * into already allocated memory.
+ *
+ * This class is not thread-safe. Messages may be passed to other threads for processing but must be destroyed on
+ * the thread that owns the pool, typically the one that runs the GrpcContext. The pool must outlive its messages.
+ *
+ * Example:
+ *
+ * @snippet server.cpp message-pool-server-side
+ *
+ * @tparam Message A default constructible type with a `Clear()` member function, e.g. a protobuf message or
+ * `grpc::ByteBuffer`.
+ *
+ * @since 2.5.0
+ */
+template <class Message>
+class MessagePool
+{
+  public:
+    /**
+     * @brief Owning pointer to a message that returns it to the pool upon destruction
+     */
+    using pointer = std::unique_ptr<Message, detail::MessagePoolDeleter<Message>>;
+
+    /**
+     * @brief Construct an empty pool
+     *
+     * @param max_size Maximum number of idle messages kept by the pool. Messages that are returned to a full pool are
+     * deleted.
+     */
+    explicit MessagePool(std::size_t max_size = 16) : max_size_(max_size) { free_.reserve(max_size); }
+
+    MessagePool(const MessagePool&) = delete;
+    MessagePool(MessagePool&&) = delete;
+    MessagePool& operator=(const MessagePool&) = delete;
+    MessagePool& operator=(MessagePool&&) = delete;
+
+    ~MessagePool() noexcept
+    {
+        assert(outstanding_ == 0 && "All messages must be returned before the pool is destroyed");
+    }
+
+    /**
+     * @brief Obtain a cleared message
+     *
+     * Reuses an idle message if available, otherwise allocates a new one.
+     */
+    [[nodiscard]] pointer acquire()
+    {
+        std::unique_ptr<Message> message;
+        if (free_.empty())
+        {
+            message = std::make_unique<Message>();
+        }
+        else
+        {
+            message = std::move(free_.back());
+            free_.pop_back();
+        }
+        ++outstanding_;
+        return pointer{message.release(), detail::MessagePoolDeleter<Message>{*this}};
+    }
+
+    /**
+     * @brief Number of idle messages
+     */
+    [[nodiscard]] std::size_t size() const noexcept { return free_.size(); }
+
+    /**
+     * @brief Maximum number of idle messages
+     */
+    [[nodiscard]] std::size_t max_size() const noexcept { return max_size_; }
+
+    /**
+     * @brief Number of messages that have been acquired and not yet returned
+     */
+    [[nodiscard]] std::size_t outstanding() const noexcept { return outstanding_; }
+
+  private:
+    friend detail::MessagePoolDeleter<Message>;
+
+    void recycle(Message* message) noexcept
+    {
+        --outstanding_;
+        std::unique_ptr<Message> owned{message};
+        if (free_.size() < max_size_)
+        {
+            owned->Clear();
+            // Does not allocate since the capacity has been reserved upon construction.
+            free_.push_back(std::move(owned));
+        }
+    }
+
+    std::vector<std::unique_ptr<Message>> free_;
+    std::size_t max_size_;
+    std::size_t outstanding_{};
+};
+
+AGRPC_NAMESPACE_END
+
+#endif  // AGRPC_AGRPC_MESSAGE_POOL_HPP
@@ -0,0 +1,838 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_AGRPC_MULTIPLEXER_HPP
+#define AGRPC_AGRPC_MULTIPLEXER_HPP
+
+#include <agrpc/detail/asio_forward.hpp>
+#include <agrpc/detail/config.hpp>
+
+#if defined(AGRPC_STANDALONE_ASIO) || defined(AGRPC_BOOST_ASIO)
+
+#include <agrpc/default_completion_token.hpp>
+#include <agrpc/detail/allocate.hpp>
+#include <agrpc/detail/async_initiate.hpp>
+#include <agrpc/detail/intrusive_list.hpp>
+#include <agrpc/detail/multiplexer.hpp>
+#include <agrpc/detail/query_grpc_context.hpp>
+#include <agrpc/detail/type_erased_completion_handler.hpp>
+#include <agrpc/detail/utility.hpp>
+#include <agrpc/detail/work_tracking_completion_handler.hpp>
+#include <agrpc/grpc_context.hpp>
+#include <agrpc/grpc_executor.hpp>
+#include <agrpc/high_level_client.hpp>
+#include <agrpc/rpc.hpp>
+#include <agrpc/wait.hpp>
+#include <grpcpp/alarm.h>
+#include <grpcpp/client_context.h>
+#include <grpcpp/support/async_stream.h>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+AGRPC_NAMESPACE_BEGIN()
+
+/**
+ * @brief (experimental) Multiplex requests over a pool of long-lived bidirectional streams
+ *
+ * For small messages the cost of a unary RPC is dominated by the creation of a new HTTP/2 stream, its headers and the
+ * `grpc::ClientContext`. This class instead keeps up to `stream_count` bidirectional streams open and sends each
+ * request over the stream with the fewest outstanding requests. A correlation id is written into every request and
+ * the request completes once a response with the same id arrives, in any order. Use `agrpc::ServerDemultiplexer` to
+ * implement the server side.
+ *
+ * Streams are started lazily. A stream that fails completes all of its outstanding requests with its status (or
+ * `grpc::StatusCode::UNAVAILABLE`) and is restarted by the next request that is assigned to it. Requests that are
+ * assigned to it while it is finishing are sent over the restarted stream. Requests that have not received a response
+ * within `request_timeout` complete with `grpc::StatusCode::DEADLINE_EXCEEDED` and are not sent anymore, a single
+ * `grpc::Alarm` is used for all of them.
+ *
+ * Running streams count as outstanding work. Call `shutdown()` and wait for it to complete before destroying the
+ * multiplexer. All member functions must be called from the thread that runs the GrpcContext.
+ *
+ * Example:
+ *
+ * @snippet client.cpp client-multiplexer
+ *
+ * @tparam PrepareAsync A pointer to the async version of a bidirectional-streaming RPC method, e.g.
+ * `&example::v1::Example::Stub::PrepareAsyncBidirectionalStreaming`.
+ * @tparam CorrelationTraits A type with the static member functions `void set_id(Request&, std::uint64_t)` and
+ * `std::uint64_t get_id(const Response&)`.
+ * @tparam Executor The executor type, must be capable of referring to a `agrpc::GrpcContext`.
+ *
+ * **Per-Operation Cancellation**
+ *
+ * None. Use `shutdown()` to complete all outstanding requests with `grpc::StatusCode::CANCELLED`.
+ *
+ * @since 2.5.0
+ */
+template <auto PrepareAsync, class CorrelationTraits, class Executor = agrpc::GrpcExecutor>
+class BasicClientMultiplexer
+{
+  private:
+    using StreamRPC = agrpc::RPC<PrepareAsync, Executor, agrpc::RPCType::CLIENT_BIDIRECTIONAL_STREAMING>;
+    using StreamState = detail::ClientMultiplexerStreamState;
+    using RequestBase = detail::ClientMultiplexerRequestBase<typename StreamRPC::Response>;
+
+  public:
+    /**
+     * @brief The stub type
+     */
+    using Stub = typename StreamRPC::Stub;
+
+    /**
+     * @brief The request message type
+     */
+    using Request = typename StreamRPC::Request;
+
+    /**
+     * @brief The response message type
+     */
+    using Response = typename StreamRPC::Response;
+
+    /**
+     * @brief The executor type
+     */
+    using executor_type = Executor;
+
+    /**
+     * @brief Construct from an executor
+     *
+     * @param stream_count The maximum number of streams, must be greater than zero.
+     * @param request_timeout The time after which a request completes with `grpc::StatusCode::DEADLINE_EXCEEDED`.
+     */
+    BasicClientMultiplexer(const Executor& executor, Stub& stub, std::size_t stream_count,
+                           std::chrono::system_clock::duration request_timeout)
+        : executor_(executor), stub_(stub), streams_(stream_count), request_timeout_(request_timeout)
+    {
+        assert(stream_count > 0 && "A multiplexer needs at least one stream");
+    }
+
+    /**
+     * @brief Construct from a GrpcContext
+     */
+    BasicClientMultiplexer(agrpc::GrpcContext& grpc_context, Stub& stub, std::size_t stream_count,
+                           std::chrono::system_clock::duration request_timeout)
+        : BasicClientMultiplexer(grpc_context.get_executor(), stub, stream_count, request_timeout)
+    {
+    }
+
+    BasicClientMultiplexer(const BasicClientMultiplexer&) = delete;
+    BasicClientMultiplexer(BasicClientMultiplexer&&) = delete;
+    BasicClientMultiplexer& operator=(const BasicClientMultiplexer&) = delete;
+    BasicClientMultiplexer& operator=(BasicClientMultiplexer&&) = delete;
+
+    ~BasicClientMultiplexer() noexcept
+    {
+        assert(is_idle() && pending_.empty() &&
+               "shutdown() must have completed before the multiplexer is destroyed");
+    }
+
+    /**
+     * @brief Send a request and wait for the matching response
+     *
+     * The correlation id of `request` is overwritten.
+     *
+     * @param response Receives the response. Must remain valid until the operation completes.
+     * @param token A completion token like `asio::yield_context` or `asio::use_awaitable`. The completion signature is
+     * `void(grpc::Status)`.
+     */
+    template <class CompletionToken = detail::DefaultCompletionTokenT<Executor>>
+    auto request(Request request, Response& response,
+                 CompletionToken token = detail::DefaultCompletionTokenT<Executor>{})
+    {
+        return asio::async_initiate<CompletionToken, void(grpc::Status)>(
+            RequestInitiation{*this}, token, static_cast<Request&&>(request), &response);
+    }
+
+    /**
+     * @brief Cancel all streams and complete all outstanding requests
+     *
+     * Outstanding and subsequent requests complete with `grpc::StatusCode::CANCELLED`. May only be called once.
+     *
+     * @param token A completion token like `asio::yield_context` or `asio::use_awaitable`. The completion signature is
+     * `void()`. Completes once all streams have finished.
+     */
+    template <class CompletionToken = detail::DefaultCompletionTokenT<Executor>>
+    auto shutdown(CompletionToken token = detail::DefaultCompletionTokenT<Executor>{})
+    {
+        return asio::async_initiate<CompletionToken, void()>(ShutdownInitiation{*this}, token);
+    }
+
+    /**
+     * @brief Number of requests that are waiting for a response
+     */
+    [[nodiscard]] std::size_t pending_count() const noexcept { return pending_.size(); }
+
+    /**
+     * @brief The maximum number of streams
+     */
+    [[nodiscard]] std::size_t stream_count() const noexcept { return streams_.size(); }
+
+    /**
+     * @brief Get the executor
+     *
+     * Thread-safe
+     */
+    [[nodiscard]] const executor_type& get_executor() const noexcept { return executor_; }
+
+  private:
+    struct QueuedRequest
+    {
+        std::uint64_t id_;
+        Request request_;
+    };
+
+    struct Stream
+    {
+        std::unique_ptr<grpc::ClientContext> client_context_;
+        std::optional<StreamRPC> rpc_;
+        Response response_;
+        std::deque<QueuedRequest> write_queue_;
+        std::size_t in_flight_{};
+
+        // Requests with a smaller id fail when the stream has finished, the others are sent over the restarted stream.
+        std::uint64_t finishing_id_{};
+        StreamState state_{StreamState::IDLE};
+        bool is_writing_{};
+        bool is_finish_deferred_{};
+    };
+
+    struct RequestInitiation
+    {
+        template <class CompletionHandler>
+        void operator()(CompletionHandler&& ch, Request request, Response* response) const
+        {
+            self_.initiate_request(static_cast<CompletionHandler&&>(ch), static_cast<Request&&>(request), *response);
+        }
+
+        BasicClientMultiplexer& self_;
+    };
+
+    struct ShutdownInitiation
+    {
+        template <class CompletionHandler>
+        void operator()(CompletionHandler&& ch) const
+        {
+            self_.initiate_shutdown(static_cast<CompletionHandler&&>(ch));
+        }
+
+        BasicClientMultiplexer& self_;
+    };
+
+    template <class CompletionHandler>
+    void initiate_request(CompletionHandler&& ch, Request&& request, Response& response)
+    {
+        if (is_shutting_down_)
+        {
+            detail::InitiateImmediateCompletion<void(grpc::Status)>{}(
+                static_cast<CompletionHandler&&>(ch),
+                grpc::Status{grpc::StatusCode::CANCELLED, "Multiplexer has been shut down"});
+            return;
+        }
+        using Target = detail::ClientMultiplexerRequest<Response, detail::RemoveCrefT<CompletionHandler>>;
+        const auto id = next_id_++;
+        const auto stream_index = select_stream();
+        auto& stream = streams_[stream_index];
+        const auto allocator = asio::get_associated_allocator(ch);
+        auto guard = detail::allocate<Target>(allocator, static_cast<CompletionHandler&&>(ch), response, id,
+                                              std::chrono::system_clock::now() + request_timeout_, stream_index);
+        CorrelationTraits::set_id(request, id);
+        stream.write_queue_.push_back({id, static_cast<Request&&>(request)});
+        pending_.emplace(id, guard.get());
+        timeout_queue_.push_back(guard.release());
+        ++stream.in_flight_;
+        if (stream.state_ == StreamState::IDLE)
+        {
+            start_stream(stream);
+        }
+        else if (stream.state_ == StreamState::RUNNING && !stream.is_writing_)
+        {
+            start_write(stream);
+        }
+        if (!is_alarm_armed_)
+        {
+            arm_alarm();
+        }
+    }
+
+    template <class CompletionHandler>
+    void initiate_shutdown(CompletionHandler&& ch)
+    {
+        assert(!is_shutting_down_ && "shutdown() may only be called once");
+        is_shutting_down_ = true;
+        if (is_alarm_armed_)
+        {
+            alarm_.Cancel();
+        }
+        for (auto& stream : streams_)
+        {
+            if (stream.state_ != StreamState::IDLE)
+            {
+                stream.client_context_->TryCancel();
+            }
+            stream.in_flight_ = 0;
+        }
+        detail::IntrusiveList<RequestBase> cancelled;
+        while (!timeout_queue_.empty())
+        {
+            cancelled.push_back(timeout_queue_.pop_front());
+        }
+        pending_.clear();
+        if (is_idle())
+        {
+            detail::InitiateImmediateCompletion<void()>{}(static_cast<CompletionHandler&&>(ch));
+        }
+        else
+        {
+            using Target = detail::WorkTrackingCompletionHandler<detail::RemoveCrefT<CompletionHandler>>;
+            shutdown_handler_.template emplace<Target>(static_cast<CompletionHandler&&>(ch));
+        }
+        complete_all(cancelled, grpc::Status{grpc::StatusCode::CANCELLED, "Multiplexer has been shut down"});
+    }
+
+    // Least outstanding requests, streams that are finishing are only chosen if there is no other stream.
+    [[nodiscard]] std::size_t select_stream() const noexcept
+    {
+        std::size_t selected{};
+        for (std::size_t i = 1; i < streams_.size(); ++i)
+        {
+            const auto& candidate = streams_[i];
+            const auto& current = streams_[selected];
+            if (candidate.state_ == StreamState::FINISHING)
+            {
+                continue;
+            }
+            if (current.state_ == StreamState::FINISHING || candidate.in_flight_ < current.in_flight_)
+            {
+                selected = i;
+            }
+        }
+        return selected;
+    }
+
+    void start_stream(Stream& stream)
+    {
+        stream.state_ = StreamState::STARTING;
+        stream.client_context_ = std::make_unique<grpc::ClientContext>();
+        StreamRPC::request(grpc_context(), stub_, *stream.client_context_,
+                           asio::bind_executor(grpc_context(),
+                                               [this, &stream](StreamRPC rpc)
+                                               {
+                                                   on_started(stream, static_cast<StreamRPC&&>(rpc));
+                                               }));
+    }
+
+    void on_started(Stream& stream, StreamRPC&& rpc)
+    {
+        stream.rpc_.emplace(static_cast<StreamRPC&&>(rpc));
+        if (!stream.rpc_->ok())
+        {
+            begin_finishing(stream);
+            on_finished(stream);
+            return;
+        }
+        stream.state_ = StreamState::RUNNING;
+        start_read(stream);
+        if (!stream.write_queue_.empty())
+        {
+            start_write(stream);
+        }
+    }
+
+    void start_read(Stream& stream)
+    {
+        stream.rpc_->read(stream.response_, asio::bind_executor(grpc_context(),
+                                                                [this, &stream](bool ok)
+                                                                {
+                                                                    on_read(stream, ok);
+                                                                }));
+    }
+
+    void on_read(Stream& stream, bool ok)
+    {
+        if (!ok)
+        {
+            begin_finishing(stream);
+            if (stream.is_writing_)
+            {
+                // finish() may only be called once the outstanding write has completed.
+                stream.is_finish_deferred_ = true;
+                return;
+            }
+            start_finish(stream);
+            return;
+        }
+        const auto it = pending_.find(CorrelationTraits::get_id(stream.response_));
+        if (it == pending_.end())
+        {
+            // The request has already timed out.
+            start_read(stream);
+            return;
+        }
+        auto* const request = it->second;
+        pending_.erase(it);
+        timeout_queue_.remove(request);
+        cancel_alarm_if_unused();
+        --streams_[request->stream_].in_flight_;
+        request->response_ = static_cast<Response&&>(stream.response_);
+        start_read(stream);
+        request->complete(grpc::Status{});
+    }
+
+    void start_write(Stream& stream)
+    {
+        stream.is_writing_ = true;
+        stream.rpc_->write(stream.write_queue_.front().request_, asio::bind_executor(grpc_context(),
+                                                                            [this, &stream](bool ok)
+                                                                            {
+                                                                                on_write(stream, ok);
+                                                                            }));
+    }
+
+    void on_write(Stream& stream, bool ok)
+    {
+        stream.is_writing_ = false;
+        if (stream.is_finish_deferred_)
+        {
+            stream.is_finish_deferred_ = false;
+            start_finish(stream);
+            return;
+        }
+        stream.write_queue_.pop_front();
+        if (!ok)
+        {
+            // The call is dead, the outstanding read completes with false.
+            return;
+        }
+        if (!stream.write_queue_.empty())
+        {
+            start_write(stream);
+        }
+    }
+
+    void begin_finishing(Stream& stream) noexcept
+    {
+        stream.state_ = StreamState::FINISHING;
+        stream.finishing_id_ = next_id_;
+    }
+
+    void start_finish(Stream& stream)
+    {
+        stream.rpc_->finish(asio::bind_executor(grpc_context(),
+                                                [this, &stream](bool)
+                                                {
+                                                    on_finished(stream);
+                                                }));
+    }
+
+    void on_finished(Stream& stream)
+    {
+        const auto& stream_status = stream.rpc_->status();
+        const auto status = stream_status.ok() ? grpc::Status{grpc::StatusCode::UNAVAILABLE, "Stream has been closed"}
+                                               : stream_status;
+        const auto index = static_cast<std::size_t>(&stream - streams_.data());
+        detail::IntrusiveList<RequestBase> failed;
+        for (auto it = timeout_queue_.begin(); it != timeout_queue_.end();)
+        {
+            auto& request = *it;
+            ++it;
+            if (request.stream_ == index && request.id_ < stream.finishing_id_)
+            {
+                timeout_queue_.remove(&request);
+                pending_.erase(request.id_);
+                failed.push_back(&request);
+            }
+        }
+        auto& write_queue = stream.write_queue_;
+        if (is_shutting_down_)
+        {
+            write_queue.clear();
+        }
+        while (!write_queue.empty() && write_queue.front().id_ < stream.finishing_id_)
+        {
+            write_queue.pop_front();
+        }
+        stream.in_flight_ = write_queue.size();
+        cancel_alarm_if_unused();
+        reset_stream(stream);
+        complete_all(failed, status);
+    }
+
+    void reset_stream(Stream& stream)
+    {
+        stream.rpc_.reset();
+        stream.client_context_.reset();
+        stream.state_ = StreamState::IDLE;
+        if (!stream.write_queue_.empty())
+        {
+            // Requests have been assigned to this stream while it was finishing.
+            start_stream(stream);
+            return;
+        }
+        maybe_complete_shutdown();
+    }
+
+    // The request at the front is not removed while it is being written.
+    static void remove_unwritten(Stream& stream, std::uint64_t id)
+    {
+        auto& write_queue = stream.write_queue_;
+        auto begin = write_queue.begin();
+        if (stream.is_writing_ && begin != write_queue.end())
+        {
+            ++begin;
+        }
+        const auto it = std::find_if(begin, write_queue.end(),
+                                     [&](const QueuedRequest& queued)
+                                     {
+                                         return queued.id_ == id;
+                                     });
+        if (it != write_queue.end())
+        {
+            write_queue.erase(it);
+        }
+    }
+
+    void arm_alarm()
+    {
+        is_alarm_armed_ = true;
+        agrpc::wait(alarm_, (*timeout_queue_.begin()).deadline_, asio::bind_executor(grpc_context(),
+                                                                                     [this](bool)
+                                                                                     {
+                                                                                         on_alarm();
+                                                                                     }));
+    }
+
+    // An armed alarm is outstanding work. It is cancelled once no request can time out anymore so that the GrpcContext
+    // does not wait for it. A request that is made before the cancellation has completed re-arms it from on_alarm().
+    void cancel_alarm_if_unused()
+    {
+        if (is_alarm_armed_ && timeout_queue_.empty())
+        {
+            alarm_.Cancel();
+        }
+    }
+
+    void on_alarm()
+    {
+        is_alarm_armed_ = false;
+        const auto now = std::chrono::system_clock::now();
+        detail::IntrusiveList<RequestBase> expired;
+        while (!timeout_queue_.empty() && (*timeout_queue_.begin()).deadline_ <= now)
+        {
+            auto* const request = timeout_queue_.pop_front();
+            pending_.erase(request->id_);
+            auto& stream = streams_[request->stream_];
+            --stream.in_flight_;
+            remove_unwritten(stream, request->id_);
+            expired.push_back(request);
+        }
+        if (!timeout_queue_.empty() && !is_shutting_down_)
+        {
+            arm_alarm();
+        }
+        else
+        {
+            maybe_complete_shutdown();
+        }
+        complete_all(expired, grpc::Status{grpc::StatusCode::DEADLINE_EXCEEDED, "Request has timed out"});
+    }
+
+    static void complete_all(detail::IntrusiveList<RequestBase>& requests, const grpc::Status& status)
+    {
+        while (!requests.empty())
+        {
+            requests.pop_front()->complete(grpc::Status{status});
+        }
+    }
+
+    [[nodiscard]] bool is_idle() const noexcept
+    {
+        if (is_alarm_armed_)
+        {
+            return false;
+        }
+        for (const auto& stream : streams_)
+        {
+            if (stream.state_ != StreamState::IDLE)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void maybe_complete_shutdown()
+    {
+        if (shutdown_handler_ && is_idle())
+        {
+            std::move(shutdown_handler_).complete();
+        }
+    }
+
+    [[nodiscard]] agrpc::GrpcContext& grpc_context() const noexcept { return detail::query_grpc_context(executor_); }
+
+    Executor executor_;
+    Stub& stub_;
+    std::vector<Stream> streams_;
+    std::chrono::system_clock::duration request_timeout_;
+    std::unordered_map<std::uint64_t, RequestBase*> pending_;
+    detail::IntrusiveList<RequestBase> timeout_queue_;
+    grpc::Alarm alarm_;
+    detail::TypeErasedCompletionHandler<void()> shutdown_handler_;
+    std::uint64_t next_id_{};
+    bool is_alarm_armed_{};
+    bool is_shutting_down_{};
+};
+
+/**
+ * @brief (experimental) A BasicClientMultiplexer that uses `agrpc::GrpcExecutor`
+ *
+ * @since 2.5.0
+ */
+template <auto PrepareAsync, class CorrelationTraits>
+using ClientMultiplexer = agrpc::BasicClientMultiplexer<PrepareAsync, CorrelationTraits>;
+
+/**
+ * @brief (experimental) Server side of `agrpc::BasicClientMultiplexer`
+ *
+ * Reads requests from a bidirectional stream and hands each of them to a request handler together with a
+ * `Responder`. Responses may be sent in any order, they are written one after another and carry the correlation id
+ * of their request.
+ *
+ * Example:
+ *
+ * @snippet server.cpp server-demultiplexer
+ *
+ * @tparam CorrelationTraits A type with the static member functions `std::uint64_t get_id(const Request&)` and
+ * `void set_id(Response&, std::uint64_t)`.
+ *
+ * @since 2.5.0
+ */
+template <class Request, class Response, class CorrelationTraits>
+class ServerDemultiplexer
+{
+  public:
+    /**
+     * @brief Move-only handle to send the response of one request
+     *
+     * Destroying a Responder without calling `send()` leaves the request unanswered, the client side will eventually
+     * time out. Must not outlive the ServerDemultiplexer.
+     */
+    class Responder
+    {
+      public:
+        Responder(Responder&& other) noexcept : self_(std::exchange(other.self_, nullptr)), id_(other.id_) {}
+
+        Responder(const Responder&) = delete;
+        Responder& operator=(const Responder&) = delete;
+        Responder& operator=(Responder&&) = delete;
+
+        ~Responder() noexcept
+        {
+            if (self_ != nullptr)
+            {
+                self_->release();
+            }
+        }
+
+        /**
+         * @brief Send the response
+         *
+         * Sets the correlation id of the response. May only be called once and only from the thread that runs the
+         * GrpcContext.
+         */
+        void send(Response response)
+        {
+            assert(self_ != nullptr && "send() may only be called once");
+            CorrelationTraits::set_id(response, id_);
+            std::exchange(self_, nullptr)->send(static_cast<Response&&>(response));
+        }
+
+        /**
+         * @brief The correlation id of the request
+         */
+        [[nodiscard]] std::uint64_t id() const noexcept { return id_; }
+
+      private:
+        friend ServerDemultiplexer;
+
+        Responder(ServerDemultiplexer& self, std::uint64_t id) noexcept : self_(&self), id_(id) {}
+
+        ServerDemultiplexer* self_;
+        std::uint64_t id_;
+    };
+
+    /**
+     * @brief The underlying reader-writer type
+     */
+    using ReaderWriter = grpc::ServerAsyncReaderWriterInterface<Response, Request>;
+
+    ServerDemultiplexer(agrpc::GrpcContext& grpc_context, ReaderWriter& reader_writer) noexcept
+        : grpc_context_(grpc_context), reader_writer_(reader_writer)
+    {
+    }
+
+    ServerDemultiplexer(const ServerDemultiplexer&) = delete;
+    ServerDemultiplexer(ServerDemultiplexer&&) = delete;
+    ServerDemultiplexer& operator=(const ServerDemultiplexer&) = delete;
+    ServerDemultiplexer& operator=(ServerDemultiplexer&&) = delete;
+
+    ~ServerDemultiplexer() noexcept
+    {
+        assert(run_ == nullptr && "run() must have completed before the demultiplexer is destroyed");
+    }
+
+    /**
+     * @brief Read requests until the client has finished
+     *
+     * May only be called once. Afterwards, the RPC should be finished, e.g. using `agrpc::finish`.
+     *
+     * @param request_handler A callable with the signature `void(Request&&, Responder&&)`. Invoked on the GrpcContext
+     * for every request.
+     * @param token A completion token like `asio::yield_context` or `asio::use_awaitable`. The completion signature is
+     * `void(bool)`. Completes once the client has stopped sending requests and all Responders have been destroyed.
+     * `true` if all responses have been written.
+     */
+    template <class RequestHandler, class CompletionToken = agrpc::DefaultCompletionToken>
+    auto run(RequestHandler request_handler, CompletionToken token = {})
+    {
+        return asio::async_initiate<CompletionToken, void(bool)>(RunInitiation{*this}, token,
+                                                                 static_cast<RequestHandler&&>(request_handler));
+    }
+
+  private:
+    using RunBase = detail::ServerDemultiplexerRunBase<Request, Responder>;
+
+    struct RunInitiation
+    {
+        template <class CompletionHandler, class RequestHandler>
+        void operator()(CompletionHandler&& ch, RequestHandler&& request_handler) const
+        {
+            using Target = detail::ServerDemultiplexerRun<Request, Responder, detail::RemoveCrefT<RequestHandler>,
+                                                          detail::RemoveCrefT<CompletionHandler>>;
+            assert(self_.run_ == nullptr && "run() may only be called once");
+            const auto allocator = asio::get_associated_allocator(ch);
+            self_.run_ = detail::allocate<Target>(allocator, static_cast<RequestHandler&&>(request_handler),
+                                                  static_cast<CompletionHandler&&>(ch))
+                             .release();
+            self_.start_read();
+        }
+
+        ServerDemultiplexer& self_;
+    };
+
+    void start_read()
+    {
+        agrpc::read(reader_writer_, request_, asio::bind_executor(grpc_context_,
+                                                                  [this](bool ok)
+                                                                  {
+                                                                      on_read(ok);
+                                                                  }));
+    }
+
+    void on_read(bool ok)
+    {
+        if (!ok)
+        {
+            is_reading_done_ = true;
+            maybe_complete();
+            return;
+        }
+        Responder responder{*this, CorrelationTraits::get_id(request_)};
+        ++outstanding_responders_;
+        Request request{static_cast<Request&&>(request_)};
+        start_read();
+        run_->on_request(static_cast<Request&&>(request), static_cast<Responder&&>(responder));
+    }
+
+    void send(Response&& response)
+    {
+        if (!is_write_failed_)
+        {
+            write_queue_.push_back(static_cast<Response&&>(response));
+            if (!is_writing_)
+            {
+                start_write();
+            }
+        }
+        release();
+    }
+
+    void release()
+    {
+        --outstanding_responders_;
+        maybe_complete();
+    }
+
+    void start_write()
+    {
+        is_writing_ = true;
+        agrpc::write(reader_writer_, write_queue_.front(), asio::bind_executor(grpc_context_,
+                                                                               [this](bool ok)
+                                                                               {
+                                                                                   on_write(ok);
+                                                                               }));
+    }
+
+    void on_write(bool ok)
+    {
+        write_queue_.pop_front();
+        if (!ok)
+        {
+            is_write_failed_ = true;
+            write_queue_.clear();
+        }
+        if (!write_queue_.empty())
+        {
+            start_write();
+            return;
+        }
+        is_writing_ = false;
+        maybe_complete();
+    }
+
+    void maybe_complete()
+    {
+        if (run_ != nullptr && is_reading_done_ && outstanding_responders_ == 0 && !is_writing_)
+        {
+            std::exchange(run_, nullptr)->complete(!is_write_failed_);
+        }
+    }
+
+    agrpc::GrpcContext& grpc_context_;
+    ReaderWriter& reader_writer_;
+    Request request_;
+    std::deque<Response> write_queue_;
+    RunBase* run_{};
+    std::size_t outstanding_responders_{};
+    bool is_reading_done_{};
+    bool is_writing_{};
+    bool is_write_failed_{};
+};
+
+AGRPC_NAMESPACE_END
+
+#endif
+
+#endif  // AGRPC_AGRPC_MULTIPLEXER_HPP
@@ -0,0 +1,93 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_AGRPC_OFFLOAD_HPP
+#define AGRPC_AGRPC_OFFLOAD_HPP
+
+#include <agrpc/detail/asio_forward.hpp>
+#include <agrpc/detail/config.hpp>
+
+#if defined(AGRPC_STANDALONE_ASIO) || defined(AGRPC_BOOST_ASIO)
+
+#include <agrpc/default_completion_token.hpp>
+#include <agrpc/detail/initiate_sender_implementation.hpp>
+#include <agrpc/detail/offload.hpp>
+#include <agrpc/detail/utility.hpp>
+#include <agrpc/grpc_context.hpp>
+
+AGRPC_NAMESPACE_BEGIN()
+
+namespace detail
+{
+/**
+ * @brief Function object to run a function on another executor and complete on a GrpcContext
+ *
+ * **Per-Operation Cancellation**
+ *
+ * All. Prevents the function from being invoked if it has not started yet, the operation then completes with an
+ * exception of `asio::error::operation_aborted`. Once started, the function runs to completion.
+ *
+ * @since 2.5.0
+ */
+struct OffloadFn
+{
+    /**
+     * @brief Run a function on an executor and deliver its result to the GrpcContext
+     *
+     * Submits `function` to `executor`, e.g. that of an `asio::thread_pool`, and completes on `grpc_context` through
+     * its remote work queue once the function returns. In contrast to switching back and forth between executors with
+     * `asio::post` only one operation is allocated: the memory that `executor` needs for the submitted function object
+     * is part of it. The operation can be recycled by the GrpcContext's local allocator when initiated from the
+     * GrpcContext's thread.
+     *
+     * Example:
+     *
+     * @snippet server.cpp offload-server-side
+     *
+     * @param executor The executor to run `function` on. Must satisfy the Asio executor requirements.
+     * @param function Callable without arguments. An exception that it throws is delivered to the completion handler.
+     * @param token A completion token like `asio::use_awaitable` or `agrpc::use_sender`. The completion signature is
+     * `void(std::exception_ptr, R)` where `R` is the decayed return type of `function`, which must be default
+     * constructible, or `void(std::exception_ptr)` if `function` returns void.
+     */
+    template <class Executor, class Function, class CompletionToken = agrpc::DefaultCompletionToken>
+    auto operator()(agrpc::GrpcContext& grpc_context, const Executor& executor, Function&& function,
+                    CompletionToken token = {}) const
+    {
+        return detail::async_initiate_sender_implementation<
+            detail::OffloadSenderImplementation<Executor, detail::RemoveCrefT<Function>>>(
+            grpc_context, executor,
+            detail::OffloadSenderImplementation<Executor, detail::RemoveCrefT<Function>>{
+                static_cast<Function&&>(function)},
+            token);
+    }
+};
+}  // namespace detail
+
+/**
+ * @brief Offload a function to another executor
+ *
+ * @link detail::OffloadFn
+ * Function to run a function on another executor and complete on a GrpcContext.
+ * @endlink
+ *
+ * @since 2.5.0
+ */
+inline constexpr detail::OffloadFn offload{};
+
+AGRPC_NAMESPACE_END
+
+#endif
+
+#endif  // AGRPC_AGRPC_OFFLOAD_HPP
@@ -0,0 +1,216 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_AGRPC_ORDERED_STAGE_HPP
+#define AGRPC_AGRPC_ORDERED_STAGE_HPP
+
+#include <agrpc/detail/asio_forward.hpp>
+#include <agrpc/detail/config.hpp>
+
+#if defined(AGRPC_STANDALONE_ASIO) || defined(AGRPC_BOOST_ASIO)
+
+#include <agrpc/default_completion_token.hpp>
+#include <agrpc/detail/asio_association.hpp>
+#include <agrpc/detail/initiate_sender_implementation.hpp>
+#include <agrpc/detail/ordered_stage.hpp>
+#include <agrpc/detail/utility.hpp>
+#include <agrpc/grpc_context.hpp>
+
+#include <cstddef>
+#include <exception>
+#include <type_traits>
+
+AGRPC_NAMESPACE_BEGIN()
+
+/**
+ * @brief (experimental) Process independent requests in parallel while preserving their order
+ *
+ * Intended for bidirectional streams whose requests can be processed independently but whose responses must be
+ * written in request order. The reading side submits one function per request which runs on `executor`, typically
+ * that of an `asio::thread_pool`. The writing side obtains the results through `next()` strictly in submission order,
+ * so that exactly one write is outstanding at any time and the wire semantics are the same as when processing one
+ * request after another.
+ *
+ * Results are held in a reorder buffer of `max_in_flight` slots which is allocated once upon construction. A slot is
+ * freed when its result has been obtained through `next()`. `submit()` waits for a free slot, providing backpressure to
+ * the reading side. Workers signal the GrpcContext through its remote work queue without using a mutex.
+ *
+ * At most one `submit()` and one `next()` may be outstanding at a time. All operations must have completed before the
+ * stage is destroyed.
+ *
+ * Example:
+ *
+ * @snippet server.cpp ordered-stage-server-side
+ *
+ * @tparam Result The type of the results, must be default constructible and move constructible.
+ * @tparam Executor The executor to run functions on. Must satisfy the Asio executor requirements.
+ *
+ * **Per-Operation Cancellation**
+ *
+ * None.
+ *
+ * @since 2.5.0
+ */
+template <class Result, class Executor>
+class BasicOrderedStage
+{
+  private:
+    template <class Function>
+    struct Job
+    {
+        void operator()() noexcept
+        {
+            AGRPC_TRY { slot_.result_.emplace(function_()); }
+            AGRPC_CATCH(...) { slot_.exception_ = std::current_exception(); }
+            state_.complete(slot_);
+        }
+
+        detail::OrderedStageState<Result>& state_;
+        detail::OrderedStageSlot<Result>& slot_;
+        Function function_;
+    };
+
+  public:
+    /**
+     * @brief The result type
+     */
+    using result_type = Result;
+
+    /**
+     * @brief The executor type used for running functions
+     */
+    using executor_type = Executor;
+
+    /**
+     * @brief Construct a BasicOrderedStage
+     *
+     * @param max_in_flight Maximum number of requests that are being processed or whose results have not been
+     * obtained through `next()` yet. Must be greater than zero.
+     */
+    BasicOrderedStage(agrpc::GrpcContext& grpc_context, const Executor& executor, std::size_t max_in_flight)
+        : state_(grpc_context, max_in_flight), executor_(executor)
+    {
+    }
+
+    BasicOrderedStage(const BasicOrderedStage&) = delete;
+    BasicOrderedStage(BasicOrderedStage&&) = delete;
+    BasicOrderedStage& operator=(const BasicOrderedStage&) = delete;
+    BasicOrderedStage& operator=(BasicOrderedStage&&) = delete;
+
+    /**
+     * @brief Submit a function, waiting for a free slot if necessary
+     *
+     * Completes on the GrpcContext once the function has been handed to the executor or, without running the
+     * function, once the stage has been closed.
+     *
+     * @param function Callable without arguments that returns `Result`. An exception that it exits with is delivered
+     * to the `next()` that obtains its result.
+     * @param token A completion token like `asio::yield_context` or the one created by `agrpc::use_sender`. The
+     * completion signature is `void(bool)`. `true` if the function has been handed to the executor, `false` if the
+     * stage has been closed.
+     */
+    template <class Function, class CompletionToken = agrpc::DefaultCompletionToken>
+    auto submit(Function&& function, CompletionToken token = {})
+    {
+        using Implementation =
+            detail::OrderedStageSubmitSenderImplementation<BasicOrderedStage, detail::RemoveCrefT<Function>>;
+        return detail::async_initiate_sender_implementation<Implementation>(
+            state_.grpc_context(), {}, Implementation{*this, static_cast<Function&&>(function)}, token);
+    }
+
+    /**
+     * @brief Obtain the result of the oldest submitted function
+     *
+     * Waits for that function to complete even if younger ones have already completed.
+     *
+     * @param token A completion token like `asio::yield_context` or the one created by `agrpc::use_sender`. The
+     * completion signature is `void(std::exception_ptr, bool, Result)`. `true` if a result has been obtained, `false`
+     * if the stage has been closed and all results have been obtained, in which case the result is default
+     * constructed. If the function has exited with an exception then it is passed as the first argument, the second
+     * argument is `true` and the result is default constructed.
+     */
+    template <class CompletionToken = agrpc::DefaultCompletionToken>
+    auto next(CompletionToken token = {})
+    {
+        return detail::async_initiate_sender_implementation<detail::OrderedStageNextSenderImplementation<Result>>(
+            state_.grpc_context(), {}, detail::OrderedStageNextSenderImplementation<Result>{state_}, token);
+    }
+
+    /**
+     * @brief Signal that no more functions will be submitted
+     *
+     * A waiting `next()` completes with `false` once the results of all previously submitted functions have been
+     * obtained. A waiting `submit()` completes with `false`. Must be called from the thread that runs the GrpcContext.
+     */
+    void close() noexcept { state_.close(); }
+
+    /**
+     * @brief Has the stage been closed?
+     */
+    [[nodiscard]] bool is_closed() const noexcept { return state_.is_closed(); }
+
+    /**
+     * @brief Number of submitted functions whose results have not been obtained yet
+     */
+    [[nodiscard]] std::size_t size() const noexcept { return state_.size(); }
+
+    /**
+     * @brief The size of the reorder buffer
+     */
+    [[nodiscard]] std::size_t max_in_flight() const noexcept { return state_.max_in_flight(); }
+
+    /**
+     * @brief Get the executor used for running functions
+     *
+     * Thread-safe
+     */
+    [[nodiscard]] const executor_type& get_executor() const noexcept { return executor_; }
+
+  private:
+    static_assert(std::is_default_constructible_v<Result> && std::is_move_constructible_v<Result>,
+                  "The result type of an ordered stage must be default constructible and move constructible");
+
+    template <class, class>
+    friend class detail::OrderedStageSubmitSenderImplementation;
+
+    template <class Function>
+    void start(detail::OrderedStageSlot<Result>& slot, Function&& function)
+    {
+        detail::post_to_foreign_executor(
+            executor_, Job<detail::RemoveCrefT<Function>>{state_, slot, static_cast<Function&&>(function)});
+    }
+
+    detail::OrderedStageState<Result> state_;
+    Executor executor_;
+};
+
+/**
+ * @brief (experimental) Create a BasicOrderedStage
+ *
+ * The returned object is neither copyable nor movable and must therefore be used to initialize a variable directly.
+ *
+ * @since 2.5.0
+ */
+template <class Result, class Executor>
+BasicOrderedStage<Result, Executor> make_ordered_stage(agrpc::GrpcContext& grpc_context, const Executor& executor,
+                                                       std::size_t max_in_flight)
+{
+    return {grpc_context, executor, max_in_flight};
+}
+
+AGRPC_NAMESPACE_END
+
+#endif
+
+#endif  // AGRPC_AGRPC_ORDERED_STAGE_HPP
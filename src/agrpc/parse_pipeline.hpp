@@ -0,0 +1,225 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_AGRPC_PARSE_PIPELINE_HPP
+#define AGRPC_AGRPC_PARSE_PIPELINE_HPP
+
+#include <agrpc/detail/asio_forward.hpp>
+#include <agrpc/detail/config.hpp>
+
+#if defined(AGRPC_STANDALONE_ASIO) || defined(AGRPC_BOOST_ASIO)
+
+#include <agrpc/default_completion_token.hpp>
+#include <agrpc/detail/asio_association.hpp>
+#include <agrpc/detail/initiate_sender_implementation.hpp>
+#include <agrpc/detail/parse_pipeline.hpp>
+#include <agrpc/detail/utility.hpp>
+#include <agrpc/grpc_context.hpp>
+#include <grpcpp/support/byte_buffer.h>
+#include <grpcpp/support/status.h>
+
+#include <cstddef>
+
+AGRPC_NAMESPACE_BEGIN()
+
+/**
+ * @brief (experimental) Deserialize and process streamed messages on a worker pool
+ *
+ * Moves protobuf parsing off the GrpcContext's thread: the protocol loop reads raw `grpc::ByteBuffer`s, e.g. using
+ * the generic API or a raw method of the generated service, and submits them to this pipeline. Each buffer is
+ * deserialized into a fresh `Message` on `executor`, typically that of an `asio::thread_pool`, and handed to
+ * `function` right there. The protocol loop can therefore issue the next read immediately while parsing scales
+ * across the threads of the pool.
+ *
+ * At most `max_depth` messages are being parsed or processed at any time. `submit()` waits for one of them to finish
+ * when that limit has been reached, which in turn delays the next read and provides backpressure to the client.
+ * Workers signal the protocol loop through the GrpcContext's remote work queue without using a mutex.
+ *
+ * At most one `submit()` or `wait_idle()` may be outstanding at a time. All messages must have been processed before
+ * the pipeline is destroyed.
+ *
+ * Example:
+ *
+ * @snippet server.cpp parse-pipeline-server-side
+ *
+ * @tparam Message The message type, must be default constructible and have a specialization of
+ * `grpc::SerializationTraits`, e.g. a protobuf message.
+ * @tparam Executor The executor to parse and process messages on. Must satisfy the Asio executor requirements.
+ * @tparam Function Callable with the signature `void(const grpc::Status&, Message&)`. It is invoked concurrently from
+ * the threads of `executor` and must not throw, otherwise `std::terminate` is called. The status is not ok if the
+ * buffer could not be deserialized.
+ *
+ * **Per-Operation Cancellation**
+ *
+ * None.
+ *
+ * @since 2.5.0
+ */
+template <class Message, class Executor, class Function>
+class BasicParsePipeline
+{
+  private:
+    struct Job
+    {
+        Job(BasicParsePipeline& self, grpc::ByteBuffer& buffer) noexcept : self_(self) { buffer_.Swap(&buffer); }
+
+        Job(Job&& other) noexcept : self_(other.self_) { buffer_.Swap(&other.buffer_); }
+
+        void operator()() noexcept { self_.run(buffer_); }
+
+        BasicParsePipeline& self_;
+        grpc::ByteBuffer buffer_;
+    };
+
+  public:
+    /**
+     * @brief The message type
+     */
+    using message_type = Message;
+
+    /**
+     * @brief The executor type used for parsing and processing
+     */
+    using executor_type = Executor;
+
+    /**
+     * @brief Construct a BasicParsePipeline
+     *
+     * @param max_depth Maximum number of messages that are being parsed or processed at the same time, must be
+     * greater than zero.
+     */
+    template <class F>
+    BasicParsePipeline(agrpc::GrpcContext& grpc_context, const Executor& executor, std::size_t max_depth,
+                       F&& function)
+        : state_(grpc_context, max_depth), executor_(executor), function_(static_cast<F&&>(function))
+    {
+    }
+
+    BasicParsePipeline(const BasicParsePipeline&) = delete;
+    BasicParsePipeline(BasicParsePipeline&&) = delete;
+    BasicParsePipeline& operator=(const BasicParsePipeline&) = delete;
+    BasicParsePipeline& operator=(BasicParsePipeline&&) = delete;
+
+    /**
+     * @brief Submit a serialized message, waiting for capacity if necessary
+     *
+     * The contents of `buffer` are taken over without copying the underlying slices, leaving it empty for the next
+     * read. Completes on the GrpcContext once the message has been handed to the executor.
+     *
+     * @param token A completion token like `asio::yield_context` or the one created by `agrpc::use_sender`. The
+     * completion signature is `void()`.
+     */
+    template <class CompletionToken = agrpc::DefaultCompletionToken>
+    auto submit(grpc::ByteBuffer& buffer, CompletionToken token = {})
+    {
+        return detail::async_initiate_sender_implementation<
+            detail::ParsePipelineSubmitSenderImplementation<BasicParsePipeline>>(
+            state_.grpc_context(), {}, {*this, buffer}, token);
+    }
+
+    /**
+     * @brief Try to submit a serialized message without waiting
+     *
+     * @return False if `max_depth()` messages are in flight, in which case `buffer` has not been modified.
+     */
+    [[nodiscard]] bool try_submit(grpc::ByteBuffer& buffer)
+    {
+        if (!state_.try_acquire())
+        {
+            return false;
+        }
+        start(buffer);
+        return true;
+    }
+
+    /**
+     * @brief Wait for all submitted messages to be processed
+     *
+     * Typically awaited after the client has finished writing and before finishing the RPC. Completes on the
+     * GrpcContext, side effects of `function` are visible at that point.
+     *
+     * @param token A completion token like `asio::yield_context` or the one created by `agrpc::use_sender`. The
+     * completion signature is `void()`.
+     */
+    template <class CompletionToken = agrpc::DefaultCompletionToken>
+    auto wait_idle(CompletionToken token = {})
+    {
+        return detail::async_initiate_sender_implementation<detail::ParsePipelineWaitIdleSenderImplementation>(
+            state_.grpc_context(), {}, detail::ParsePipelineWaitIdleSenderImplementation{state_}, token);
+    }
+
+    /**
+     * @brief Number of messages that are currently being parsed or processed
+     *
+     * Thread-safe
+     */
+    [[nodiscard]] std::size_t in_flight() const noexcept { return state_.in_flight(); }
+
+    /**
+     * @brief Maximum number of messages that are parsed or processed at the same time
+     *
+     * Thread-safe
+     */
+    [[nodiscard]] std::size_t max_depth() const noexcept { return state_.max_depth(); }
+
+    /**
+     * @brief Get the executor used for parsing and processing
+     *
+     * Thread-safe
+     */
+    [[nodiscard]] const executor_type& get_executor() const noexcept { return executor_; }
+
+  private:
+    friend detail::ParsePipelineSubmitSenderImplementation<BasicParsePipeline>;
+
+    void start(grpc::ByteBuffer& buffer)
+    {
+        // The function object is small which allows Asio to recycle its memory.
+        detail::post_to_foreign_executor(executor_, Job{*this, buffer});
+    }
+
+    void run(grpc::ByteBuffer& buffer) noexcept
+    {
+        {
+            Message message;
+            const auto status = grpc::SerializationTraits<Message>::Deserialize(&buffer, &message);
+            function_(status, message);
+        }
+        state_.release();
+    }
+
+    detail::ParsePipelineState state_;
+    Executor executor_;
+    Function function_;
+};
+
+/**
+ * @brief (experimental) Create a BasicParsePipeline
+ *
+ * The returned object is neither copyable nor movable and must therefore be used to initialize a variable directly.
+ *
+ * @since 2.5.0
+ */
+template <class Message, class Executor, class Function>
+BasicParsePipeline<Message, Executor, detail::RemoveCrefT<Function>> make_parse_pipeline(
+    agrpc::GrpcContext& grpc_context, const Executor& executor, std::size_t max_depth, Function&& function)
+{
+    return {grpc_context, executor, max_depth, static_cast<Function&&>(function)};
+}
+
+AGRPC_NAMESPACE_END
+
+#endif
+
+#endif  // AGRPC_AGRPC_PARSE_PIPELINE_HPP
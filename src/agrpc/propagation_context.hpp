@@ -0,0 +1,226 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_AGRPC_PROPAGATION_CONTEXT_HPP
+#define AGRPC_AGRPC_PROPAGATION_CONTEXT_HPP
+
+#include <agrpc/detail/asio_forward.hpp>
+#include <agrpc/detail/config.hpp>
+#include <agrpc/detail/intrusive_list.hpp>
+#include <agrpc/detail/intrusive_list_hook.hpp>
+#include <grpcpp/client_context.h>
+#include <grpcpp/server_context.h>
+
+#include <cassert>
+#include <chrono>
+
+AGRPC_NAMESPACE_BEGIN()
+
+class PropagatedClientContext;
+
+/**
+ * @brief (experimental) Propagate deadline and cancellation from a server-side RPC to outgoing client-side RPCs
+ *
+ * Created from the `grpc::ServerContext` of an inbound RPC. Each `agrpc::PropagatedClientContext` created from it
+ * receives the remaining deadline of the inbound RPC minus a configurable margin, leaving time to process the
+ * downstream response. `cancel()` cancels all outstanding children at once, they are tracked in an intrusive list
+ * without additional memory allocations. Typically `cancel()` is called upon completion of
+ * `agrpc::notify_when_done` if `grpc::ServerContext::IsCancelled()` returns true, so that abandoned work stops
+ * downstream as well. Alternatively, `cancel_on()` connects it to an Asio cancellation slot.
+ *
+ * This class is not thread-safe. The children must be destroyed before this object.
+ *
+ * Example:
+ *
+ * @snippet server.cpp propagation-context-server-side
+ *
+ * @since 2.5.0
+ */
+class PropagationContext
+{
+  public:
+    /**
+     * @brief The clock type of deadlines
+     */
+    using clock_type = std::chrono::system_clock;
+
+    /**
+     * @brief Construct from a `grpc::ServerContext`
+     *
+     * @param deadline_margin Duration to subtract from the deadline of the inbound RPC.
+     */
+    explicit PropagationContext(grpc::ServerContext& server_context,
+                                clock_type::duration deadline_margin = {}) noexcept
+        : server_context_(server_context), deadline_margin_(deadline_margin)
+    {
+    }
+
+    PropagationContext(const PropagationContext&) = delete;
+    PropagationContext(PropagationContext&&) = delete;
+    PropagationContext& operator=(const PropagationContext&) = delete;
+    PropagationContext& operator=(PropagationContext&&) = delete;
+
+    ~PropagationContext() noexcept
+    {
+        assert(children_.empty() && "All PropagatedClientContexts must be destroyed before their PropagationContext");
+#ifdef AGRPC_ASIO_HAS_CANCELLATION_SLOT
+        cancellation_slot_.clear();
+#endif
+    }
+
+    /**
+     * @brief The `grpc::ServerContext` of the inbound RPC
+     */
+    [[nodiscard]] grpc::ServerContext& server_context() const noexcept { return server_context_; }
+
+    /**
+     * @brief The deadline for outgoing RPCs
+     *
+     * `clock_type::time_point::max()` if the inbound RPC has no deadline.
+     */
+    [[nodiscard]] clock_type::time_point deadline() const
+    {
+        const auto deadline = server_context_.deadline();
+        if (deadline == clock_type::time_point::max())
+        {
+            return deadline;
+        }
+        return deadline - deadline_margin_;
+    }
+
+    /**
+     * @brief Has `cancel()` been called?
+     */
+    [[nodiscard]] bool is_cancelled() const noexcept { return cancelled_; }
+
+    /**
+     * @brief Cancel all outgoing RPCs
+     *
+     * Calls `grpc::ClientContext::TryCancel()` on every child. Children created afterwards are cancelled immediately.
+     */
+    void cancel() noexcept;
+
+#ifdef AGRPC_ASIO_HAS_CANCELLATION_SLOT
+    /**
+     * @brief Call `cancel()` when a cancellation is emitted on the slot
+     *
+     * Any type of cancellation triggers `cancel()`. Installs a handler into `slot`, replacing the previous one, and
+     * clears it upon destruction of this object, the corresponding `asio::cancellation_signal` must therefore outlive
+     * it. The signal must be emitted from the thread that uses this object.
+     *
+     * Example, with `signal` being emitted when the inbound RPC has been cancelled:
+     *
+     * @code{cpp}
+     * agrpc::PropagationContext context{server_context};
+     * context.cancel_on(signal.slot());
+     * @endcode
+     */
+    void cancel_on(asio::cancellation_slot slot)
+    {
+        cancellation_slot_.clear();
+        cancellation_slot_ = slot;
+        if (cancellation_slot_.is_connected())
+        {
+            cancellation_slot_.emplace<CancellationHandler>(*this);
+        }
+    }
+#endif
+
+  private:
+    friend agrpc::PropagatedClientContext;
+
+#ifdef AGRPC_ASIO_HAS_CANCELLATION_SLOT
+    struct CancellationHandler
+    {
+        explicit CancellationHandler(PropagationContext& self) noexcept : self_(self) {}
+
+        void operator()(asio::cancellation_type) const noexcept { self_.cancel(); }
+
+        PropagationContext& self_;
+    };
+#endif
+
+    grpc::ServerContext& server_context_;
+    clock_type::duration deadline_margin_;
+    detail::IntrusiveList<agrpc::PropagatedClientContext> children_;
+#ifdef AGRPC_ASIO_HAS_CANCELLATION_SLOT
+    asio::cancellation_slot cancellation_slot_;
+#endif
+    bool cancelled_{};
+};
+
+/**
+ * @brief (experimental) `grpc::ClientContext` for an outgoing RPC made on behalf of an inbound RPC
+ *
+ * Applies the deadline of the `agrpc::PropagationContext` upon construction and is cancelled together with it. Pass
+ * `client_context()` to functions like `agrpc::RPC::request`.
+ *
+ * @since 2.5.0
+ */
+class PropagatedClientContext : public detail::IntrusiveListHook<PropagatedClientContext>
+{
+  public:
+    /**
+     * @brief Construct a child of the specified PropagationContext
+     */
+    explicit PropagatedClientContext(agrpc::PropagationContext& parent) : parent_(parent)
+    {
+        const auto deadline = parent.deadline();
+        if (deadline != PropagationContext::clock_type::time_point::max())
+        {
+            client_context_.set_deadline(deadline);
+        }
+        parent.children_.push_back(this);
+        if (parent.is_cancelled())
+        {
+            client_context_.TryCancel();
+        }
+    }
+
+    PropagatedClientContext(const PropagatedClientContext&) = delete;
+    PropagatedClientContext(PropagatedClientContext&&) = delete;
+    PropagatedClientContext& operator=(const PropagatedClientContext&) = delete;
+    PropagatedClientContext& operator=(PropagatedClientContext&&) = delete;
+
+    ~PropagatedClientContext() noexcept { parent_.children_.remove(this); }
+
+    /**
+     * @brief The `grpc::ClientContext` to use for the outgoing RPC
+     */
+    [[nodiscard]] grpc::ClientContext& client_context() noexcept { return client_context_; }
+
+    /**
+     * @brief The `grpc::ClientContext` to use for the outgoing RPC (const overload)
+     */
+    [[nodiscard]] const grpc::ClientContext& client_context() const noexcept { return client_context_; }
+
+  private:
+    friend agrpc::PropagationContext;
+
+    agrpc::PropagationContext& parent_;
+    grpc::ClientContext client_context_;
+};
+
+inline void PropagationContext::cancel() noexcept
+{
+    cancelled_ = true;
+    for (auto& child : children_)
+    {
+        child.client_context_.TryCancel();
+    }
+}
+
+AGRPC_NAMESPACE_END
+
+#endif  // AGRPC_AGRPC_PROPAGATION_CONTEXT_HPP
@@ -21,6 +21,7 @@
 #include <agrpc/detail/repeatedly_request_sender.hpp>
 #include <agrpc/detail/rpc.hpp>
 #include <agrpc/detail/rpc_context.hpp>
+#include <agrpc/detail/server_middleware.hpp>
 #include <agrpc/detail/use_sender.hpp>
 #include <agrpc/detail/utility.hpp>
 #include <agrpc/repeatedly_request_context.hpp>
@@ -98,8 +99,9 @@ class RepeatedlyRequestFn
     {
 #ifdef AGRPC_ASIO_HAS_CO_AWAIT
         using RPCContext = detail::RPCContextForRPCT<RPC>;
-        if constexpr (detail::INVOKE_RESULT_IS_CO_SPAWNABLE<detail::RemoveCrefT<RequestHandler>&,
-                                                            typename RPCContext::Signature>)
+        if constexpr (detail::INVOKE_RESULT_IS_CO_SPAWNABLE<
+                          detail::UnwrapServerMiddlewareT<detail::RemoveCrefT<RequestHandler>>&,
+                          typename RPCContext::Signature>)
         {
             return asio::async_initiate<CompletionToken, void()>(detail::RepeatedlyRequestCoroutineInitiator{}, token,
                                                                  static_cast<RequestHandler&&>(request_handler), rpc,
@@ -108,6 +110,8 @@ class RepeatedlyRequestFn
         else
 #endif
         {
+            static_assert(!detail::IS_SERVER_MIDDLEWARE<detail::RemoveCrefT<RequestHandler>>,
+                          "agrpc::ServerMiddleware requires a request handler that returns an awaitable");
             return asio::async_initiate<CompletionToken, void()>(detail::RepeatedlyRequestInitiator{}, token,
                                                                  static_cast<RequestHandler&&>(request_handler), rpc,
                                                                  service);
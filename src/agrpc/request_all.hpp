@@ -0,0 +1,177 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_AGRPC_REQUEST_ALL_HPP
+#define AGRPC_AGRPC_REQUEST_ALL_HPP
+
+#include <agrpc/detail/asio_forward.hpp>
+#include <agrpc/detail/config.hpp>
+
+#if defined(AGRPC_STANDALONE_ASIO) || defined(AGRPC_BOOST_ASIO)
+
+#include <agrpc/default_completion_token.hpp>
+#include <agrpc/detail/memory.hpp>
+#include <agrpc/detail/request_all.hpp>
+#include <agrpc/detail/rpc_type.hpp>
+#include <agrpc/detail/utility.hpp>
+#include <agrpc/grpc_context.hpp>
+#include <grpcpp/support/status.h>
+
+#include <chrono>
+#include <vector>
+
+AGRPC_NAMESPACE_BEGIN()
+
+/**
+ * @brief (experimental) Options for `agrpc::request_all` and `agrpc::request_each`
+ *
+ * @since 2.5.0
+ */
+struct RequestAllOptions
+{
+    /**
+     * @brief Deadline that is set on every `grpc::ClientContext`, `time_point::max()` for none
+     */
+    std::chrono::system_clock::time_point deadline{std::chrono::system_clock::time_point::max()};
+
+    /**
+     * @brief Cancel all outstanding requests once one of them completes with a non-OK status
+     */
+    bool cancel_on_error{};
+};
+
+/**
+ * @brief (experimental) Result of one unary request performed by `agrpc::request_all`
+ *
+ * @since 2.5.0
+ */
+template <class Response>
+struct UnaryResult
+{
+    grpc::Status status;
+    Response response;
+};
+
+namespace detail
+{
+/**
+ * @brief Function object to perform many unary requests at once
+ *
+ * **Per-Operation Cancellation**
+ *
+ * None. Use `RequestAllOptions::cancel_on_error` or `RequestAllOptions::deadline` instead.
+ *
+ * @since 2.5.0
+ */
+struct RequestAllFn
+{
+    /**
+     * @brief Perform one unary request for every element of `requests`
+     *
+     * All `grpc::ClientContext`s, responders, statuses and responses are placed in a single allocation that is made
+     * using the completion handler's associated allocator. The completion handler is invoked once, after all requests
+     * have finished.
+     *
+     * Example:
+     *
+     * @snippet client.cpp request-all-client-side
+     *
+     * @param rpc A pointer to the async version of the RPC method. The async version starts with `PrepareAsync` or
+     * `Async`.
+     * @param requests A forward range of request messages. Must remain valid until this function returns.
+     * @param token A completion token like `asio::yield_context` or `asio::use_awaitable`. The completion signature is
+     * `void(std::vector<agrpc::UnaryResult<Response>>)`. The results are in the order of `requests`.
+     */
+    template <class Stub, class DerivedStub, class Request, template <class> class Responder, class Response,
+              class Requests, class CompletionToken = agrpc::DefaultCompletionToken>
+    auto operator()(agrpc::GrpcContext& grpc_context,
+                    detail::ClientUnaryRequest<Stub, Request, Responder<Response>> rpc, DerivedStub& stub,
+                    const Requests& requests, const agrpc::RequestAllOptions& options = {},
+                    CompletionToken token = {}) const
+    {
+        return asio::async_initiate<CompletionToken, void(std::vector<agrpc::UnaryResult<Response>>)>(
+            detail::RequestAllInitiation<Responder<Response>, Response, decltype(rpc), Stub, Requests>{
+                rpc, detail::unwrap_unique_ptr(stub), requests, grpc_context, options.deadline,
+                options.cancel_on_error},
+            token, detail::RequestAllCollect{});
+    }
+};
+
+/**
+ * @brief Function object to perform many unary requests at once and process their results one by one
+ *
+ * **Per-Operation Cancellation**
+ *
+ * None. Use `RequestAllOptions::cancel_on_error` or `RequestAllOptions::deadline` instead.
+ *
+ * @since 2.5.0
+ */
+struct RequestEachFn
+{
+    /**
+     * @brief Perform one unary request for every element of `requests`
+     *
+     * Like `agrpc::request_all` but instead of collecting the results, `on_result` is invoked on the GrpcContext as
+     * soon as a request finishes.
+     *
+     * @param requests A forward range of request messages. Must remain valid until this function returns.
+     * @param on_result Callable with the signature `void(std::size_t index, grpc::Status&&, Response&&)`. An
+     * exception thrown by it propagates out of `GrpcContext::run()`, the remaining requests are still awaited and the
+     * operation completes as usual.
+     * @param token A completion token like `asio::yield_context` or `asio::use_awaitable`. The completion signature is
+     * `void(grpc::Status)`. The first non-OK status or OK if all requests succeeded.
+     */
+    template <class Stub, class DerivedStub, class Request, template <class> class Responder, class Response,
+              class Requests, class OnResult, class CompletionToken = agrpc::DefaultCompletionToken>
+    auto operator()(agrpc::GrpcContext& grpc_context,
+                    detail::ClientUnaryRequest<Stub, Request, Responder<Response>> rpc, DerivedStub& stub,
+                    const Requests& requests, const agrpc::RequestAllOptions& options, OnResult on_result,
+                    CompletionToken token = {}) const
+    {
+        return asio::async_initiate<CompletionToken, void(grpc::Status)>(
+            detail::RequestAllInitiation<Responder<Response>, Response, decltype(rpc), Stub, Requests>{
+                rpc, detail::unwrap_unique_ptr(stub), requests, grpc_context, options.deadline,
+                options.cancel_on_error},
+            token, static_cast<OnResult&&>(on_result));
+    }
+};
+}  // namespace detail
+
+/**
+ * @brief (experimental) Perform many unary requests with a single allocation
+ *
+ * @link detail::RequestAllFn
+ * Function to perform many unary requests at once.
+ * @endlink
+ *
+ * @since 2.5.0
+ */
+inline constexpr detail::RequestAllFn request_all{};
+
+/**
+ * @brief (experimental) Perform many unary requests with a single allocation and process their results one by one
+ *
+ * @link detail::RequestEachFn
+ * Function to perform many unary requests at once and process their results one by one.
+ * @endlink
+ *
+ * @since 2.5.0
+ */
+inline constexpr detail::RequestEachFn request_each{};
+
+AGRPC_NAMESPACE_END
+
+#endif
+
+#endif  // AGRPC_AGRPC_REQUEST_ALL_HPP
@@ -0,0 +1,174 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_AGRPC_RPC_ARENA_HPP
+#define AGRPC_AGRPC_RPC_ARENA_HPP
+
+#include <agrpc/detail/config.hpp>
+#include <agrpc/detail/grpc_context.hpp>
+#include <agrpc/detail/math.hpp>
+#include <agrpc/detail/memory.hpp>
+#include <agrpc/detail/memory_resource_allocator.hpp>
+#include <agrpc/detail/pool_resource.hpp>
+#include <agrpc/grpc_context.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <new>
+
+AGRPC_NAMESPACE_BEGIN()
+
+/**
+ * @brief (experimental) Monotonic arena whose lifetime is one RPC
+ *
+ * Memory resource that hands out memory by bumping a pointer through chunks obtained from the GrpcContext's local
+ * pool. Deallocation is a no-op, all memory is returned to the pool at once by `release()` or upon destruction, where
+ * it is recycled for the next RPC. Chunks grow geometrically so no sizing guesswork is required.
+ *
+ * Bind `get_allocator()` to the completion handlers of all operations of an RPC, e.g. using `agrpc::bind_allocator`,
+ * to avoid general-purpose allocations entirely. The arena must outlive those operations.
+ *
+ * This class is not thread-safe. Since the GrpcContext's pool may only be used from the thread that runs the
+ * GrpcContext the same applies to the arena, operations must therefore be initiated from that thread.
+ *
+ * Example:
+ *
+ * @snippet server.cpp rpc-arena-server-side
+ *
+ * @since 2.5.0
+ */
+class RPCArena
+{
+  private:
+    struct Chunk
+    {
+        Chunk* next_;
+        std::size_t size_;
+    };
+
+    using LocalResource = detail::GrpcContextLocalMemoryResource;
+
+    static constexpr std::size_t HEADER_SIZE = detail::align(sizeof(Chunk), detail::MAX_ALIGN);
+
+  public:
+    /**
+     * @brief The allocator type
+     */
+    using allocator_type = detail::MemoryResourceAllocator<std::byte, RPCArena>;
+
+    /**
+     * @brief Construct from a GrpcContext
+     *
+     * Does not allocate memory.
+     *
+     * @param initial_chunk_size Size of the first chunk. Subsequent chunks double in size until they reach
+     * `max_chunk_size`.
+     * @param max_chunk_size Size limit for chunks, allocations larger than that get a chunk of their own. Defaults to
+     * the largest size that the GrpcContext's pool recycles, larger chunks are obtained from the heap every time.
+     */
+    explicit RPCArena(agrpc::GrpcContext& grpc_context, std::size_t initial_chunk_size = 512,
+                      std::size_t max_chunk_size = LocalResource::max_pooled_size()) noexcept
+        : grpc_context_(grpc_context),
+          next_chunk_size_(detail::minimum(initial_chunk_size, max_chunk_size)),
+          max_chunk_size_(max_chunk_size)
+    {
+    }
+
+    RPCArena(const RPCArena&) = delete;
+    RPCArena(RPCArena&&) = delete;
+    RPCArena& operator=(const RPCArena&) = delete;
+    RPCArena& operator=(RPCArena&&) = delete;
+
+    ~RPCArena() noexcept { release(); }
+
+    /**
+     * @brief Get an allocator that allocates from this arena
+     */
+    [[nodiscard]] allocator_type get_allocator() noexcept { return allocator_type{this}; }
+
+    /**
+     * @brief Allocate memory
+     *
+     * @param alignment Must not be greater than `alignof(std::max_align_t)`.
+     */
+    [[nodiscard]] void* allocate(std::size_t bytes, std::size_t alignment = detail::MAX_ALIGN)
+    {
+        assert(alignment <= detail::MAX_ALIGN && "Overaligned types are not supported");
+        auto position = detail::align(position_, alignment);
+        if (head_ == nullptr || position + bytes > head_->size_)
+        {
+            add_chunk(bytes);
+            position = HEADER_SIZE;
+        }
+        position_ = position + bytes;
+        used_bytes_ += bytes;
+        return reinterpret_cast<char*>(head_) + position;
+    }
+
+    /**
+     * @brief Does nothing, memory is returned to the pool by `release()`
+     */
+    static constexpr void deallocate(void*, std::size_t, std::size_t = detail::MAX_ALIGN) noexcept {}
+
+    /**
+     * @brief Return all memory to the GrpcContext's pool
+     *
+     * All memory previously obtained from this arena becomes invalid.
+     */
+    void release() noexcept
+    {
+        auto allocator = detail::get_local_allocator(grpc_context_);
+        while (head_ != nullptr)
+        {
+            auto* const chunk = head_;
+            head_ = chunk->next_;
+            const auto size = chunk->size_;
+            chunk->~Chunk();
+            allocator.deallocate(reinterpret_cast<std::byte*>(chunk), size);
+        }
+        position_ = 0;
+        used_bytes_ = 0;
+    }
+
+    /**
+     * @brief Number of bytes handed out since construction or the last call to `release()`
+     */
+    [[nodiscard]] std::size_t used_bytes() const noexcept { return used_bytes_; }
+
+  private:
+    void add_chunk(std::size_t bytes)
+    {
+        auto size = next_chunk_size_;
+        next_chunk_size_ = detail::minimum(size * 2, max_chunk_size_);
+        if (size < HEADER_SIZE + bytes)
+        {
+            size = HEADER_SIZE + bytes;
+        }
+        // The pool rounds the size up to its block size, make that memory usable
+        size = LocalResource::reserved_size(size);
+        void* p = detail::get_local_allocator(grpc_context_).allocate(size);
+        head_ = ::new (p) Chunk{head_, size};
+    }
+
+    agrpc::GrpcContext& grpc_context_;
+    Chunk* head_{};
+    std::size_t position_{};
+    std::size_t next_chunk_size_;
+    std::size_t max_chunk_size_;
+    std::size_t used_bytes_{};
+};
+
+AGRPC_NAMESPACE_END
+
+#endif  // AGRPC_AGRPC_RPC_ARENA_HPP
@@ -0,0 +1,327 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_AGRPC_RPC_REGISTRY_HPP
+#define AGRPC_AGRPC_RPC_REGISTRY_HPP
+
+#include <agrpc/detail/config.hpp>
+#include <agrpc/detail/intrusive_list.hpp>
+#include <agrpc/detail/intrusive_list_hook.hpp>
+#include <grpcpp/client_context.h>
+#include <grpcpp/server_context.h>
+
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+AGRPC_NAMESPACE_BEGIN()
+
+class RPCRegistration;
+
+/**
+ * @brief (experimental) Information about a registered RPC
+ *
+ * A copy of the data of an `agrpc::RPCRegistration` as returned by `agrpc::RPCRegistry::snapshot()`.
+ *
+ * @since 2.5.0
+ */
+struct RPCInfo
+{
+    /**
+     * @brief The `grpc::ServerContext` of a server-side RPC or nullptr
+     */
+    grpc::ServerContext* server_context;
+
+    /**
+     * @brief The `grpc::ClientContext` of a client-side RPC or nullptr
+     */
+    grpc::ClientContext* client_context;
+
+    /**
+     * @brief The method name that was passed upon registration
+     */
+    std::string_view method;
+
+    /**
+     * @brief The time of the registry's last tick before the RPC has been registered
+     */
+    std::chrono::system_clock::time_point start_time;
+
+    /**
+     * @brief The deadline of the RPC, `std::chrono::system_clock::time_point::max()` if it has none
+     */
+    std::chrono::system_clock::time_point deadline;
+};
+
+/**
+ * @brief (experimental) Registry of the active RPCs of a GrpcContext
+ *
+ * Intrusive list of `agrpc::RPCRegistration`s, typically one per GrpcContext. Registering an RPC does not allocate
+ * memory and merely links the registration into the list. The registry can be used to cancel RPCs in bulk, e.g. all
+ * RPCs of a tenant or all RPCs older than a certain duration, and to inspect stuck calls.
+ *
+ * Registrations do not read the clock either. Their start time is the registry's current time, which is set upon
+ * construction and by every call to `tick()`. Calling `tick()` periodically, e.g. at the beginning of the routine that
+ * cancels old RPCs, makes start times accurate to the tick period.
+ *
+ * This class is not thread-safe, it should only be used from the thread that runs the GrpcContext. All
+ * registrations must be destroyed before the registry.
+ *
+ * Example:
+ *
+ * @snippet server.cpp rpc-registry-server-side
+ *
+ * @since 2.5.0
+ */
+class RPCRegistry
+{
+  public:
+    /**
+     * @brief The clock type of start times
+     */
+    using clock_type = std::chrono::system_clock;
+
+    /**
+     * @brief Default constructor
+     *
+     * The current time is initialized with `clock_type::now()`.
+     */
+    RPCRegistry() : now_(clock_type::now()) {}
+
+    RPCRegistry(const RPCRegistry&) = delete;
+    RPCRegistry(RPCRegistry&&) = delete;
+    RPCRegistry& operator=(const RPCRegistry&) = delete;
+    RPCRegistry& operator=(RPCRegistry&&) = delete;
+
+    ~RPCRegistry() noexcept { assert(empty() && "All RPCRegistrations must be destroyed before their RPCRegistry"); }
+
+    /**
+     * @brief Number of registered RPCs
+     */
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+
+    /**
+     * @brief Are there no registered RPCs?
+     */
+    [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+
+    /**
+     * @brief The time that is recorded as the start time of new registrations
+     */
+    [[nodiscard]] clock_type::time_point now() const noexcept { return now_; }
+
+    /**
+     * @brief Advance the time that is recorded as the start time of new registrations
+     */
+    void tick(clock_type::time_point now = clock_type::now()) noexcept { now_ = now; }
+
+    /**
+     * @brief Invoke a function with every `const agrpc::RPCRegistration&`
+     *
+     * The function must not create or destroy registrations of this registry.
+     */
+    template <class Function>
+    void for_each(Function&& function);
+
+    /**
+     * @brief Call `TryCancel()` on every RPC for which the predicate returns true
+     *
+     * @param predicate Invoked with `const agrpc::RPCRegistration&`.
+     *
+     * @return The number of RPCs that have been cancelled.
+     */
+    template <class Predicate>
+    std::size_t cancel_if(Predicate&& predicate);
+
+    /**
+     * @brief Copy the information of all registered RPCs
+     *
+     * Intended for debugging, allocates memory.
+     */
+    [[nodiscard]] std::vector<agrpc::RPCInfo> snapshot();
+
+  private:
+    friend agrpc::RPCRegistration;
+
+    detail::IntrusiveList<agrpc::RPCRegistration> list_;
+    std::size_t size_{};
+    clock_type::time_point now_;
+};
+
+/**
+ * @brief (experimental) RAII registration of an RPC in an `agrpc::RPCRegistry`
+ *
+ * Place it next to the `grpc::ServerContext` or `grpc::ClientContext` of an RPC. The RPC is unregistered upon
+ * destruction.
+ *
+ * @since 2.5.0
+ */
+class RPCRegistration : public detail::IntrusiveListHook<RPCRegistration>
+{
+  public:
+    /**
+     * @brief Register a server-side RPC
+     *
+     * @param method Name of the method, must remain valid for the lifetime of this object.
+     */
+    RPCRegistration(agrpc::RPCRegistry& registry, grpc::ServerContext& server_context, std::string_view method = {})
+        : registry_(registry),
+          server_context_(&server_context),
+          client_context_(),
+          method_(method),
+          start_time_(registry.now())
+    {
+        link();
+    }
+
+    /**
+     * @brief Register a client-side RPC
+     *
+     * The deadline is read from the `grpc::ClientContext` when queried, it may therefore be set after construction.
+     *
+     * @param method Name of the method, must remain valid for the lifetime of this object.
+     */
+    RPCRegistration(agrpc::RPCRegistry& registry, grpc::ClientContext& client_context, std::string_view method = {})
+        : registry_(registry),
+          server_context_(),
+          client_context_(&client_context),
+          method_(method),
+          start_time_(registry.now())
+    {
+        link();
+    }
+
+    RPCRegistration(const RPCRegistration&) = delete;
+    RPCRegistration(RPCRegistration&&) = delete;
+    RPCRegistration& operator=(const RPCRegistration&) = delete;
+    RPCRegistration& operator=(RPCRegistration&&) = delete;
+
+    ~RPCRegistration() noexcept
+    {
+        registry_.list_.remove(this);
+        --registry_.size_;
+    }
+
+    /**
+     * @brief Is this a server-side RPC?
+     */
+    [[nodiscard]] bool is_server_side() const noexcept { return server_context_ != nullptr; }
+
+    /**
+     * @brief The `grpc::ServerContext` of a server-side RPC or nullptr
+     */
+    [[nodiscard]] grpc::ServerContext* server_context() const noexcept { return server_context_; }
+
+    /**
+     * @brief The `grpc::ClientContext` of a client-side RPC or nullptr
+     */
+    [[nodiscard]] grpc::ClientContext* client_context() const noexcept { return client_context_; }
+
+    /**
+     * @brief The method name that was passed upon construction
+     */
+    [[nodiscard]] std::string_view method() const noexcept { return method_; }
+
+    /**
+     * @brief The time of the registry's last tick before this RPC has been registered
+     */
+    [[nodiscard]] std::chrono::system_clock::time_point start_time() const noexcept { return start_time_; }
+
+    /**
+     * @brief The deadline of the RPC, `std::chrono::system_clock::time_point::max()` if it has none
+     */
+    [[nodiscard]] std::chrono::system_clock::time_point deadline() const
+    {
+        return is_server_side() ? server_context_->deadline() : client_context_->deadline();
+    }
+
+    /**
+     * @brief Cancel the RPC
+     *
+     * A server-side RPC must have been started.
+     */
+    void try_cancel() const
+    {
+        if (is_server_side())
+        {
+            server_context_->TryCancel();
+        }
+        else
+        {
+            client_context_->TryCancel();
+        }
+    }
+
+    /**
+     * @brief Copy the information of this registration
+     */
+    [[nodiscard]] agrpc::RPCInfo info() const
+    {
+        return {server_context_, client_context_, method_, start_time_, deadline()};
+    }
+
+  private:
+    void link() noexcept
+    {
+        registry_.list_.push_back(this);
+        ++registry_.size_;
+    }
+
+    agrpc::RPCRegistry& registry_;
+    grpc::ServerContext* server_context_;
+    grpc::ClientContext* client_context_;
+    std::string_view method_;
+    std::chrono::system_clock::time_point start_time_;
+};
+
+template <class Function>
+inline void RPCRegistry::for_each(Function&& function)
+{
+    for (auto& registration : list_)
+    {
+        function(static_cast<const agrpc::RPCRegistration&>(registration));
+    }
+}
+
+template <class Predicate>
+inline std::size_t RPCRegistry::cancel_if(Predicate&& predicate)
+{
+    std::size_t count{};
+    for (auto& registration : list_)
+    {
+        if (predicate(static_cast<const agrpc::RPCRegistration&>(registration)))
+        {
+            registration.try_cancel();
+            ++count;
+        }
+    }
+    return count;
+}
+
+inline std::vector<agrpc::RPCInfo> RPCRegistry::snapshot()
+{
+    std::vector<agrpc::RPCInfo> result;
+    result.reserve(size_);
+    for (auto& registration : list_)
+    {
+        result.push_back(registration.info());
+    }
+    return result;
+}
+
+AGRPC_NAMESPACE_END
+
+#endif  // AGRPC_AGRPC_RPC_REGISTRY_HPP
@@ -0,0 +1,197 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_AGRPC_SELECTOR_HPP
+#define AGRPC_AGRPC_SELECTOR_HPP
+
+#include <agrpc/detail/asio_forward.hpp>
+#include <agrpc/detail/config.hpp>
+
+#ifdef AGRPC_ASIO_HAS_CANCELLATION_SLOT
+
+#include <agrpc/default_completion_token.hpp>
+#include <agrpc/detail/grpc_stream.hpp>
+#include <agrpc/grpc_context.hpp>
+#include <agrpc/grpc_executor.hpp>
+
+#include <cstddef>
+#include <memory>
+
+AGRPC_NAMESPACE_BEGIN()
+
+/**
+ * @brief (experimental) Wait for whichever of several long-lived operations completes next
+ *
+ * Lightweight, IoObject-like class that multiplexes up to `Capacity` concurrently running operations, e.g. reads on
+ * different streams and alarms. Each operation is initiated with a user-chosen index which is reported back by
+ * `next()` once the operation completes. Operations that did not complete remain armed, only the completed one
+ * needs to be re-initiated. In contrast to `asio::experimental::make_parallel_group` no operation is cancelled or
+ * restarted and no memory is allocated per wait.
+ *
+ * Like `agrpc::BasicGrpcStream`, which shares its implementation, operations must complete with `bool`. This is the
+ * case for all RPC functions and `agrpc::wait`.
+ *
+ * Example:
+ *
+ * @snippet client.cpp selector-client-side
+ *
+ * @tparam Capacity The maximum number of concurrently initiated operations.
+ *
+ * @since 2.5.0 (and Boost.Asio 1.77.0)
+ */
+template <class Executor, std::size_t Capacity>
+class BasicSelector : private detail::GrpcStreamBase<Executor, Capacity, std::size_t>
+{
+  private:
+    using Base = detail::GrpcStreamBase<Executor, Capacity, std::size_t>;
+
+  public:
+    /**
+     * @brief The associated executor type
+     */
+    using executor_type = Executor;
+
+    /**
+     * @brief Rebind the selector to another executor
+     */
+    template <class OtherExecutor>
+    struct rebind_executor
+    {
+        /**
+         * @brief The selector type when rebound to the specified executor
+         */
+        using other = BasicSelector<OtherExecutor, Capacity>;
+    };
+
+    /**
+     * @brief Construct from an executor
+     */
+    template <class Exec>
+    explicit BasicSelector(Exec&& executor) noexcept : Base(static_cast<Exec&&>(executor))
+    {
+    }
+
+    /**
+     * @brief Construct from a `agrpc::GrpcContext`
+     */
+    explicit BasicSelector(agrpc::GrpcContext& grpc_context) noexcept : Base(grpc_context.get_executor()) {}
+
+    /**
+     * @brief Get the associated executor
+     *
+     * Thread-safe
+     */
+    [[nodiscard]] const executor_type& get_executor() const noexcept { return Base::executor(); }
+
+    /**
+     * @brief Is any operation currently running?
+     *
+     * Thread-safe
+     */
+    [[nodiscard]] bool is_running() const noexcept { return running_count() != 0; }
+
+    /**
+     * @brief Number of initiated operations that have not completed yet
+     *
+     * Thread-safe
+     */
+    [[nodiscard]] std::size_t running_count() const noexcept { return Base::running_count(); }
+
+    /**
+     * @brief Can another operation be initiated?
+     *
+     * False if `Capacity` operations are running or awaiting `next()`.
+     */
+    [[nodiscard]] bool has_capacity() const noexcept { return Base::has_capacity(); }
+
+    /**
+     * @brief The maximum number of concurrently initiated operations
+     */
+    [[nodiscard]] static constexpr std::size_t capacity() noexcept { return Capacity; }
+
+    /**
+     * @brief Wait for the next operation to complete
+     *
+     * Only one call to `next()` may be outstanding at a time. Operations are reported in completion order.
+     *
+     * @param token Completion token for the signature `void(error_code, std::size_t, bool)`, where the second argument
+     * is the index that was passed to `initiate()` and the third argument is the result of the operation.
+     *
+     * **Per-Operation Cancellation**
+     *
+     * All. Upon cancellation, the initiated operations continue to run.
+     */
+    template <class CompletionToken = asio::default_completion_token_t<Executor>>
+    auto next(CompletionToken&& token = asio::default_completion_token_t<Executor>{})
+    {
+        return Base::next(static_cast<CompletionToken&&>(token));
+    }
+
+    /**
+     * @brief Initiate an operation identified by `index` using the specified allocator
+     *
+     * May only be called while `has_capacity()` is true.
+     */
+    template <class Allocator, class Function, class... Args>
+    BasicSelector& initiate(std::allocator_arg_t, Allocator allocator, std::size_t index, Function&& function,
+                            Args&&... args)
+    {
+        Base::initiate(std::allocator_arg, allocator, {index}, static_cast<Function&&>(function),
+                       static_cast<Args&&>(args)...);
+        return *this;
+    }
+
+    /**
+     * @brief Initiate an operation identified by `index`
+     *
+     * May only be called while `has_capacity()` is true.
+     */
+    template <class Function, class... Args>
+    BasicSelector& initiate(std::size_t index, Function&& function, Args&&... args)
+    {
+        Base::initiate({index}, static_cast<Function&&>(function), static_cast<Args&&>(args)...);
+        return *this;
+    }
+
+    /**
+     * @brief Wait for all initiated operations to complete
+     *
+     * Discards the results that have not been obtained through `next()` and completes with the last one. Completes
+     * immediately, in a manner equivalent to using `asio::post`, if no operation has been initiated since the last
+     * result was obtained. Should be called before the selector is destroyed.
+     *
+     * **Per-Operation Cancellation**
+     *
+     * All. Upon cancellation, the initiated operations continue to run.
+     */
+    template <class CompletionToken = asio::default_completion_token_t<Executor>>
+    auto cleanup(CompletionToken&& token = asio::default_completion_token_t<Executor>{})
+    {
+        return Base::cleanup(static_cast<CompletionToken&&>(token));
+    }
+};
+
+/**
+ * @brief (experimental) A BasicSelector that uses `agrpc::DefaultCompletionToken`
+ *
+ * @since 2.5.0 (and Boost.Asio 1.77.0)
+ */
+template <std::size_t Capacity>
+using Selector = agrpc::DefaultCompletionToken::as_default_on_t<agrpc::BasicSelector<agrpc::GrpcExecutor, Capacity>>;
+
+AGRPC_NAMESPACE_END
+
+#endif
+
+#endif  // AGRPC_AGRPC_SELECTOR_HPP
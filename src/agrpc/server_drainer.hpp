@@ -0,0 +1,247 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_AGRPC_SERVER_DRAINER_HPP
+#define AGRPC_AGRPC_SERVER_DRAINER_HPP
+
+#include <agrpc/detail/config.hpp>
+#include <agrpc/detail/grpc_context_implementation.hpp>
+#include <agrpc/grpc_context.hpp>
+#include <grpcpp/server.h>
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+AGRPC_NAMESPACE_BEGIN()
+
+/**
+ * @brief (experimental) Graceful shutdown of a `grpc::Server` that waits for in-flight RPCs
+ *
+ * Request handlers obtain an `InFlightGuard` through `track()` for the duration of an RPC. `drain()` shuts down the
+ * server with a deadline: no new RPCs are accepted, outstanding `agrpc::repeatedly_request` registrations complete
+ * and in-flight RPCs may finish until the deadline, after which they are cancelled by gRPC. Once all guards have been
+ * released the outstanding work that the drainer holds on each GrpcContext is discounted, allowing
+ * `GrpcContext::run()` to return as soon as the remaining operations have completed. Shutdown is therefore fast when
+ * the server is idle and does not drop requests that are already being processed.
+ *
+ * Example:
+ *
+ * @snippet server.cpp server-drainer
+ *
+ * @since 2.5.0
+ */
+class ServerDrainer
+{
+  private:
+    struct ContextState
+    {
+        agrpc::GrpcContext* grpc_context_;
+        std::atomic_size_t in_flight_{};
+    };
+
+  public:
+    /**
+     * @brief RAII object that marks an RPC as in-flight
+     *
+     * Move-only. Must not outlive the ServerDrainer.
+     */
+    class InFlightGuard
+    {
+      public:
+        InFlightGuard(InFlightGuard&& other) noexcept
+            : drainer_(std::exchange(other.drainer_, nullptr)), state_(other.state_)
+        {
+        }
+
+        InFlightGuard(const InFlightGuard&) = delete;
+        InFlightGuard& operator=(const InFlightGuard&) = delete;
+        InFlightGuard& operator=(InFlightGuard&&) = delete;
+
+        ~InFlightGuard() noexcept
+        {
+            if (drainer_ != nullptr)
+            {
+                drainer_->finished(*state_);
+            }
+        }
+
+      private:
+        friend agrpc::ServerDrainer;
+
+        InFlightGuard(ServerDrainer& drainer, ContextState& state) noexcept : drainer_(&drainer), state_(&state) {}
+
+        ServerDrainer* drainer_;
+        ContextState* state_;
+    };
+
+    /**
+     * @brief Construct from the server and every GrpcContext that processes its RPCs
+     *
+     * Counts as outstanding work on each GrpcContext until `drain()` completes or the drainer is destroyed.
+     */
+    template <class... GrpcContexts>
+    explicit ServerDrainer(grpc::Server& server, agrpc::GrpcContext& grpc_context, GrpcContexts&... grpc_contexts)
+        : server_(server),
+          contexts_(new ContextState[1 + sizeof...(GrpcContexts)]{{&grpc_context}, {&grpc_contexts}...}),
+          context_count_(1 + sizeof...(GrpcContexts))
+    {
+        for (std::size_t i{}; i < context_count_; ++i)
+        {
+            contexts_[i].grpc_context_->work_started();
+        }
+    }
+
+    ServerDrainer(const ServerDrainer&) = delete;
+    ServerDrainer(ServerDrainer&&) = delete;
+    ServerDrainer& operator=(const ServerDrainer&) = delete;
+    ServerDrainer& operator=(ServerDrainer&&) = delete;
+
+    ~ServerDrainer() noexcept
+    {
+        assert(in_flight_count() == 0 && "All InFlightGuards must be destroyed before the ServerDrainer");
+        release_work();
+    }
+
+    /**
+     * @brief Mark an RPC that is processed by the specified GrpcContext as in-flight
+     *
+     * Thread-safe
+     *
+     * @throws std::invalid_argument If `grpc_context` has not been passed to the constructor.
+     */
+    [[nodiscard]] InFlightGuard track(agrpc::GrpcContext& grpc_context)
+    {
+        auto& state = find(grpc_context);
+        state.in_flight_.fetch_add(1, std::memory_order_relaxed);
+        return InFlightGuard{*this, state};
+    }
+
+    /**
+     * @brief Number of in-flight RPCs of the specified GrpcContext
+     *
+     * Thread-safe
+     *
+     * @throws std::invalid_argument If `grpc_context` has not been passed to the constructor.
+     */
+    [[nodiscard]] std::size_t in_flight_count(agrpc::GrpcContext& grpc_context)
+    {
+        return find(grpc_context).in_flight_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Total number of in-flight RPCs
+     *
+     * Thread-safe
+     */
+    [[nodiscard]] std::size_t in_flight_count() const noexcept
+    {
+        std::size_t count{};
+        for (std::size_t i{}; i < context_count_; ++i)
+        {
+            count += contexts_[i].in_flight_.load(std::memory_order_relaxed);
+        }
+        return count;
+    }
+
+    /**
+     * @brief Has `drain()` been called?
+     *
+     * Thread-safe
+     */
+    [[nodiscard]] bool is_draining() const noexcept { return draining_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Shut down the server and wait for in-flight RPCs
+     *
+     * Blocks until all in-flight RPCs have completed or the deadline has passed. Must not be called from a thread
+     * that runs one of the GrpcContexts, otherwise `grpc::Server::Shutdown` deadlocks.
+     *
+     * @return True if all in-flight RPCs completed before the deadline.
+     */
+    bool drain(std::chrono::system_clock::time_point deadline)
+    {
+        for (std::size_t i{}; i < context_count_; ++i)
+        {
+            assert(!detail::GrpcContextImplementation::running_in_this_thread(*contexts_[i].grpc_context_) &&
+                   "ServerDrainer::drain() must not be called from a thread that runs a GrpcContext");
+        }
+        draining_.store(true);
+        server_.Shutdown(deadline);
+        bool drained;
+        {
+            std::unique_lock lock{mutex_};
+            drained = cv_.wait_until(lock, deadline,
+                                     [&]
+                                     {
+                                         return in_flight_count() == 0;
+                                     });
+        }
+        release_work();
+        return drained;
+    }
+
+  private:
+    ContextState& find(agrpc::GrpcContext& grpc_context)
+    {
+        for (std::size_t i{}; i < context_count_; ++i)
+        {
+            if (contexts_[i].grpc_context_ == &grpc_context)
+            {
+                return contexts_[i];
+            }
+        }
+        AGRPC_THROW(std::invalid_argument("agrpc::ServerDrainer: GrpcContext has not been passed to the constructor"));
+    }
+
+    void finished(ContextState& state) noexcept
+    {
+        // Pairs with the store to draining_ in drain(): either drain() observes the decrement or we observe draining_.
+        if (1 == state.in_flight_.fetch_sub(1) && draining_.load())
+        {
+            std::lock_guard lock{mutex_};
+            cv_.notify_all();
+        }
+    }
+
+    void release_work() noexcept
+    {
+        if (work_released_.exchange(true))
+        {
+            return;
+        }
+        for (std::size_t i{}; i < context_count_; ++i)
+        {
+            contexts_[i].grpc_context_->work_finished();
+        }
+    }
+
+    grpc::Server& server_;
+    std::unique_ptr<ContextState[]> contexts_;
+    std::size_t context_count_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::atomic_bool draining_{};
+    std::atomic_bool work_released_{};
+};
+
+AGRPC_NAMESPACE_END
+
+#endif  // AGRPC_AGRPC_SERVER_DRAINER_HPP
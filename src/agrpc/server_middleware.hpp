@@ -0,0 +1,117 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_AGRPC_SERVER_MIDDLEWARE_HPP
+#define AGRPC_AGRPC_SERVER_MIDDLEWARE_HPP
+
+#include <agrpc/detail/asio_forward.hpp>
+#include <agrpc/detail/config.hpp>
+
+#if defined(AGRPC_STANDALONE_ASIO) || defined(AGRPC_BOOST_ASIO)
+
+#include <agrpc/detail/server_middleware.hpp>
+
+AGRPC_NAMESPACE_BEGIN()
+
+/**
+ * @brief (experimental) Request handler with a statically composed chain of interceptors
+ *
+ * Wraps a request handler for `agrpc::repeatedly_request` that returns an awaitable, e.g. `asio::awaitable<void>`.
+ * For each RPC, `repeatedly_request` invokes the interceptors' hooks from within the coroutine that it already runs
+ * for that RPC. Interceptors are stored by value, their hooks are resolved at compile time and no additional
+ * coroutine frames are created, so that cross-cutting concerns like authentication, metrics, logging and deadline
+ * enforcement only cost their own logic.
+ *
+ * An interceptor may provide any of the following member functions:
+ *
+ * - `grpc::Status before(grpc::ServerContext&)` or `void before(grpc::ServerContext&)`: Invoked in order before the
+ * request handler. If a non-ok status is returned then neither the remaining interceptors nor the request handler
+ * are invoked and the RPC is finished with that status instead.
+ * - `void after(grpc::ServerContext&) noexcept`: Invoked in reverse order after the request handler has completed,
+ * has thrown or the RPC was rejected, but only for interceptors whose `before` hook has returned. The `after` hook of
+ * an interceptor whose `before` hook has thrown is not invoked.
+ *
+ * Like the request handler, the interceptors are copied for each RPC. They can therefore keep per-RPC state, like
+ * the start time, between `before` and `after`.
+ *
+ * Example:
+ *
+ * @snippet server.cpp server-middleware
+ *
+ * @tparam RequestHandler A request handler that returns an awaitable. Its associated executor and allocator are
+ * used by `agrpc::repeatedly_request`.
+ * @tparam Interceptors Copy constructible interceptor types.
+ *
+ * @since 2.5.0
+ */
+template <class RequestHandler, class... Interceptors>
+class ServerMiddleware
+{
+  public:
+    /**
+     * @brief The associated executor type of the request handler
+     */
+    using executor_type = asio::associated_executor_t<RequestHandler>;
+
+    /**
+     * @brief The associated allocator type of the request handler
+     */
+    using allocator_type = asio::associated_allocator_t<RequestHandler>;
+
+    /**
+     * @brief Construct from a request handler and default constructed interceptors
+     */
+    explicit ServerMiddleware(RequestHandler request_handler)
+        : request_handler_(static_cast<RequestHandler&&>(request_handler))
+    {
+    }
+
+    /**
+     * @brief Construct from a request handler and interceptors
+     */
+    template <class... Args, class = std::enable_if_t<(sizeof...(Args) > 0)>>
+    ServerMiddleware(RequestHandler request_handler, Args&&... interceptors)
+        : request_handler_(static_cast<RequestHandler&&>(request_handler)),
+          chain_(static_cast<Args&&>(interceptors)...)
+    {
+    }
+
+    /**
+     * @brief Get the associated executor of the request handler
+     */
+    [[nodiscard]] executor_type get_executor() const noexcept { return asio::get_associated_executor(request_handler_); }
+
+    /**
+     * @brief Get the associated allocator of the request handler
+     */
+    [[nodiscard]] allocator_type get_allocator() const noexcept
+    {
+        return asio::get_associated_allocator(request_handler_);
+    }
+
+  private:
+    friend detail::ServerMiddlewareAccess;
+
+    RequestHandler request_handler_;
+    detail::ServerInterceptorChain<Interceptors...> chain_;
+};
+
+template <class RequestHandler, class... Interceptors>
+ServerMiddleware(RequestHandler, Interceptors...) -> ServerMiddleware<RequestHandler, Interceptors...>;
+
+AGRPC_NAMESPACE_END
+
+#endif
+
+#endif  // AGRPC_AGRPC_SERVER_MIDDLEWARE_HPP
@@ -0,0 +1,182 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_AGRPC_TASK_HPP
+#define AGRPC_AGRPC_TASK_HPP
+
+#include <agrpc/detail/asio_forward.hpp>
+#include <agrpc/detail/config.hpp>
+
+#if (defined(AGRPC_STANDALONE_ASIO) || defined(AGRPC_BOOST_ASIO)) && defined(AGRPC_HAS_STD_COROUTINE)
+
+#include <agrpc/default_completion_token.hpp>
+#include <agrpc/detail/query_grpc_context.hpp>
+#include <agrpc/detail/task.hpp>
+#include <agrpc/grpc_context.hpp>
+#include <agrpc/grpc_executor.hpp>
+
+#include <coroutine>
+#include <type_traits>
+#include <utility>
+
+AGRPC_NAMESPACE_BEGIN()
+
+/**
+ * @brief (experimental) Lightweight coroutine type for the GrpcContext
+ *
+ * A lazily started C++20 coroutine that can `co_await` other Tasks and senders, most notably those created by this
+ * library's functions when used with `agrpc::use_sender`. Compared to `asio::awaitable` it does not carry an executor
+ * or any per-thread state:
+ *
+ * - Awaiting another Task uses symmetric transfer, the awaited Task starts and resumes its awaiter without recursion.
+ * - An awaited sender is connected to a receiver that lives in the coroutine frame and the coroutine is resumed
+ * directly from within the completion of the operation, without allocating an intermediate completion handler.
+ * - Coroutine frames that are created from within `GrpcContext::run` are allocated using the GrpcContext's local
+ * memory pool. Such Tasks must also be run on that GrpcContext.
+ *
+ * Use `agrpc::co_spawn` to launch a Task. If an awaited sender completes with `set_done`, e.g. because the GrpcContext
+ * is being shut down, then the chain of Tasks is destroyed without being resumed, just like `asio::awaitable`.
+ *
+ * Example:
+ *
+ * @snippet client.cpp task-request
+ * @snippet client.cpp task-spawn
+ *
+ * @tparam T The return type of the coroutine. Must be move constructible.
+ *
+ * @since 2.5.0
+ */
+template <class T>
+class Task
+{
+  public:
+    /**
+     * @brief The promise type of the coroutine
+     */
+    using promise_type = detail::TaskPromise<T>;
+
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    Task& operator=(Task&& other) noexcept
+    {
+        if (this != &other)
+        {
+            if (handle_)
+            {
+                handle_.destroy();
+            }
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+
+    ~Task() noexcept
+    {
+        if (handle_)
+        {
+            handle_.destroy();
+        }
+    }
+
+    /**
+     * @brief Part of the awaitable interface, always false
+     */
+    [[nodiscard]] static constexpr bool await_ready() noexcept { return false; }
+
+    /**
+     * @brief Part of the awaitable interface, starts this Task and resumes the awaiting Task once it completes
+     */
+    template <class Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> awaiting) noexcept
+    {
+        static_assert(std::is_base_of_v<detail::TaskPromiseBase, Promise>,
+                      "agrpc::Task can only be awaited from within another agrpc::Task");
+        auto& promise = handle_.promise();
+        promise.continuation_ = awaiting;
+        promise.parent_ = &awaiting.promise();
+        return handle_;
+    }
+
+    /**
+     * @brief Part of the awaitable interface, returns the result or rethrows the exception of this Task
+     */
+    T await_resume() { return handle_.promise().result(); }
+
+  private:
+    friend detail::TaskAccess;
+
+    explicit Task(std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+namespace detail
+{
+/**
+ * @brief Function object to launch an agrpc::Task on a GrpcContext
+ *
+ * @since 2.5.0
+ */
+struct CoSpawnFn
+{
+    /**
+     * @brief Run a Task on a GrpcContext
+     *
+     * The Task is started from within the GrpcContext's run loop. Once it completes, the completion handler is invoked
+     * with the exception thrown by the Task, if any, followed by the return value.
+     *
+     * @param task The Task to launch. Must not have been started.
+     * @param token A completion token like `asio::detached` or `asio::use_future`. The completion signature is
+     * `void(std::exception_ptr, T)` or `void(std::exception_ptr)` if `T` is void. The value is default constructed if
+     * the Task has thrown. If `T` is not default constructible then the completion signature is
+     * `void(std::exception_ptr, std::optional<T>)` instead and the optional is empty if the Task has thrown.
+     */
+    template <class T, class CompletionToken = agrpc::DefaultCompletionToken>
+    auto operator()(agrpc::GrpcContext& grpc_context, agrpc::Task<T> task, CompletionToken token = {}) const
+    {
+        return asio::async_initiate<CompletionToken, detail::TaskSignatureT<T>>(
+            detail::TaskSpawnInitiation<T>{grpc_context}, token, static_cast<agrpc::Task<T>&&>(task));
+    }
+
+    /**
+     * @brief Run a Task on the GrpcContext of an executor
+     */
+    template <class T, class CompletionToken = agrpc::DefaultCompletionToken>
+    auto operator()(const agrpc::GrpcExecutor& executor, agrpc::Task<T> task, CompletionToken&& token = {}) const
+    {
+        return (*this)(detail::query_grpc_context(executor), static_cast<agrpc::Task<T>&&>(task),
+                       static_cast<CompletionToken&&>(token));
+    }
+};
+}  // namespace detail
+
+/**
+ * @brief (experimental) Launch an agrpc::Task
+ *
+ * @link detail::CoSpawnFn
+ * Function object to launch an agrpc::Task on a GrpcContext.
+ * @endlink
+ *
+ * @since 2.5.0
+ */
+inline constexpr detail::CoSpawnFn co_spawn{};
+
+AGRPC_NAMESPACE_END
+
+#endif
+
+#endif  // AGRPC_AGRPC_TASK_HPP
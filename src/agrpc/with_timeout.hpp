@@ -0,0 +1,114 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_AGRPC_WITH_TIMEOUT_HPP
+#define AGRPC_AGRPC_WITH_TIMEOUT_HPP
+
+#include <agrpc/default_completion_token.hpp>
+#include <agrpc/detail/config.hpp>
+#include <agrpc/detail/grpc_initiate.hpp>
+#include <agrpc/detail/initiate_sender_implementation.hpp>
+#include <agrpc/detail/with_timeout.hpp>
+#include <agrpc/grpc_context.hpp>
+
+#include <chrono>
+
+AGRPC_NAMESPACE_BEGIN()
+
+namespace detail
+{
+/**
+ * @brief Function object to race an RPC step against a deadline
+ *
+ * **Per-Operation Cancellation**
+ *
+ * None.
+ *
+ * @since 2.5.0
+ */
+struct WithTimeoutFn
+{
+    /**
+     * @brief Perform an RPC step with a timeout
+     *
+     * Initiates the RPC step returned by `function` and arms a `grpc::Alarm`. If the alarm expires before the step
+     * completes then the RPC is cancelled through `context.TryCancel()`, causing the step to complete with `false`.
+     *
+     * Constructing a `grpc::Alarm` allocates, therefore alarms are recycled by the GrpcContext. When initiated from
+     * the thread that runs the GrpcContext, an alarm of a previous `with_timeout` is reused and no allocations besides
+     * the one for the operation itself are performed. Otherwise a new alarm is created, which is handed to the
+     * GrpcContext for reuse once the operation completes.
+     *
+     * Only the RPC step is affected by the timeout, unlike `grpc::ClientContext::set_deadline` which applies to the
+     * entire RPC. Note however that `TryCancel` cancels the whole RPC, subsequent steps will therefore fail as well.
+     *
+     * Example:
+     *
+     * @snippet client.cpp with-timeout-client-side
+     *
+     * @param context Either a `grpc::ClientContext` or a `grpc::ServerContext`.
+     * @param deadline By default gRPC supports two types of deadlines: `gpr_timespec` and
+     * `std::chrono::system_clock::time_point`. More types can be added by specializing
+     * [grpc::TimePoint](https://grpc.github.io/grpc/cpp/classgrpc_1_1_time_point.html).
+     * @param function Callable that is invoked with an unspecified completion token and must forward it to one of the
+     * functions in this library that complete with `void(bool)`, e.g. `agrpc::read`, `agrpc::write` or `agrpc::finish`.
+     * @param token A completion token like `asio::yield_context` or `agrpc::use_sender`. The completion signature is
+     * `void(bool)`. The result of the RPC step, `false` if it timed out.
+     */
+    template <class Context, class Deadline, class Function, class CompletionToken = agrpc::DefaultCompletionToken>
+    auto operator()(agrpc::GrpcContext& grpc_context, Context& context, const Deadline& deadline, Function&& function,
+                    CompletionToken token = {}) const noexcept(detail::IS_USE_SENDER<CompletionToken>)
+    {
+        using InitiatingFunction = decltype(static_cast<Function&&>(function)(detail::UseInitiatingFunction{}));
+        return detail::async_initiate_sender_implementation<
+            detail::WithTimeoutSenderImplementation<InitiatingFunction, Deadline, Context>>(
+            grpc_context, {static_cast<Function&&>(function)(detail::UseInitiatingFunction{}), deadline}, {context},
+            token);
+    }
+
+    /**
+     * @brief Perform an RPC step with a timeout relative to now
+     *
+     * Equivalent to calling the above overload with `std::chrono::system_clock::now() + timeout` as the deadline.
+     *
+     * @param timeout The duration after which the RPC is cancelled.
+     */
+    template <class Context, class Rep, class Period, class Function,
+              class CompletionToken = agrpc::DefaultCompletionToken>
+    auto operator()(agrpc::GrpcContext& grpc_context, Context& context, std::chrono::duration<Rep, Period> timeout,
+                    Function&& function, CompletionToken token = {}) const
+        noexcept(detail::IS_USE_SENDER<CompletionToken>)
+    {
+        const auto deadline =
+            std::chrono::system_clock::now() + std::chrono::ceil<std::chrono::system_clock::duration>(timeout);
+        return (*this)(grpc_context, context, deadline, static_cast<Function&&>(function),
+                       static_cast<CompletionToken&&>(token));
+    }
+};
+}  // namespace detail
+
+/**
+ * @brief Race an RPC step against a deadline
+ *
+ * @link detail::WithTimeoutFn
+ * Function to perform an RPC step with a timeout.
+ * @endlink
+ *
+ * @since 2.5.0
+ */
+inline constexpr detail::WithTimeoutFn with_timeout{};
+
+AGRPC_NAMESPACE_END
+
+#endif  // AGRPC_AGRPC_WITH_TIMEOUT_HPP
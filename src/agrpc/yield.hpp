@@ -0,0 +1,82 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_AGRPC_YIELD_HPP
+#define AGRPC_AGRPC_YIELD_HPP
+
+#include <agrpc/default_completion_token.hpp>
+#include <agrpc/detail/config.hpp>
+#include <agrpc/detail/initiate_sender_implementation.hpp>
+#include <agrpc/detail/utility.hpp>
+#include <agrpc/detail/yield.hpp>
+#include <agrpc/grpc_context.hpp>
+
+AGRPC_NAMESPACE_BEGIN()
+
+namespace detail
+{
+/**
+ * @brief (experimental) Function object to yield to the completion queue
+ *
+ * **Per-Operation Cancellation**
+ *
+ * None.
+ *
+ * @since 2.5.0
+ */
+struct YieldFn
+{
+    /**
+     * @brief Yield to the completion queue
+     *
+     * Unlike `asio::post`, which resumes the caller as part of the next batch of local completion handlers, this
+     * operation completes through the GrpcContext's `grpc::CompletionQueue`, which gives events that are already
+     * pending there a chance to be handled first. gRPC does not specify the order in which ready events are
+     * delivered, so this is not a guarantee that every such event is handled before the caller resumes. Long-running
+     * handlers, e.g. one that iterates over a large result set, can use it to keep the completion latency of other RPCs
+     * bounded. Multiple yields that are initiated before the GrpcContext polls its completion queue again share a
+     * single completion queue event and complete in the order in which they were initiated.
+     *
+     * When initiated from a thread that does not run the GrpcContext then this operation behaves like `asio::post`.
+     *
+     * Example:
+     *
+     * @snippet server.cpp yield-server-side
+     *
+     * @param token A completion token like `asio::yield_context` or the one created by `agrpc::use_sender`. The
+     * completion signature is `void()`.
+     */
+    template <class CompletionToken = agrpc::DefaultCompletionToken>
+    auto operator()(agrpc::GrpcContext& grpc_context, CompletionToken token = {}) const
+    {
+        return detail::async_initiate_sender_implementation<detail::YieldSenderImplementation>(
+            grpc_context, {}, detail::YieldSenderImplementation{}, token);
+    }
+};
+}  // namespace detail
+
+/**
+ * @brief (experimental) Yield to the completion queue
+ *
+ * @link detail::YieldFn
+ * Function to yield to the completion queue.
+ * @endlink
+ *
+ * @since 2.5.0
+ */
+inline constexpr detail::YieldFn yield{};
+
+AGRPC_NAMESPACE_END
+
+#endif  // AGRPC_AGRPC_YIELD_HPP
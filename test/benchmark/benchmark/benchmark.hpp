@@ -0,0 +1,113 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_BENCHMARK_BENCHMARK_HPP
+#define AGRPC_BENCHMARK_BENCHMARK_HPP
+
+#include <agrpc/grpc_context.hpp>
+#include <agrpc/grpc_executor.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <string_view>
+
+namespace bench
+{
+struct Measurement
+{
+    std::chrono::nanoseconds duration{};
+    std::size_t allocations{};
+};
+
+// Measures the time between construction and stop() as well as the number of allocations counted by the caller in
+// between.
+class Stopwatch
+{
+  public:
+    explicit Stopwatch(std::size_t allocations = 0) noexcept
+        : start_(std::chrono::steady_clock::now()), allocations_(allocations)
+    {
+    }
+
+    [[nodiscard]] Measurement stop(std::size_t allocations = 0) const noexcept
+    {
+        return {std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_),
+                allocations - allocations_};
+    }
+
+  private:
+    std::chrono::steady_clock::time_point start_;
+    std::size_t allocations_;
+};
+
+inline void report(std::string_view name, std::size_t iterations, const Measurement& measurement)
+{
+    const auto per_iteration = static_cast<double>(iterations);
+    std::printf("%-56.*s %12.1f ns/op %10.3f allocations/op\n", static_cast<int>(name.size()), name.data(),
+                static_cast<double>(measurement.duration.count()) / per_iteration,
+                static_cast<double>(measurement.allocations) / per_iteration);
+}
+
+// Number of times the GrpcContext's local memory pool had to allocate from upstream
+inline std::size_t pool_upstream_allocations(agrpc::GrpcContext& grpc_context) noexcept
+{
+    return grpc_context.get_allocator().resource()->upstream_allocations();
+}
+
+// Allocator that always allocates from the heap and counts the number of allocations. Since it is not a
+// std::allocator, operations that are associated with it do not use the GrpcContext's local memory pool.
+template <class T = std::byte>
+class CountingAllocator
+{
+  public:
+    using value_type = T;
+
+    constexpr explicit CountingAllocator(std::size_t& count) noexcept : count_(&count) {}
+
+    template <class U>
+    constexpr CountingAllocator(const bench::CountingAllocator<U>& other) noexcept : count_(other.count_)
+    {
+    }
+
+    [[nodiscard]] T* allocate(std::size_t n)
+    {
+        ++*count_;
+        return std::allocator<T>{}.allocate(n);
+    }
+
+    void deallocate(T* p, std::size_t n) { std::allocator<T>{}.deallocate(p, n); }
+
+    template <class U>
+    friend constexpr bool operator==(const CountingAllocator& lhs, const bench::CountingAllocator<U>& rhs) noexcept
+    {
+        return lhs.count_ == rhs.count_;
+    }
+
+    template <class U>
+    friend constexpr bool operator!=(const CountingAllocator& lhs, const bench::CountingAllocator<U>& rhs) noexcept
+    {
+        return lhs.count_ != rhs.count_;
+    }
+
+  private:
+    template <class>
+    friend class bench::CountingAllocator;
+
+    std::size_t* count_;
+};
+}  // namespace bench
+
+#endif  // AGRPC_BENCHMARK_BENCHMARK_HPP
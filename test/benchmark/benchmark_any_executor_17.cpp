@@ -0,0 +1,130 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compares agrpc::AnyExecutor with asio::any_io_executor and the GrpcExecutor itself, each referring to the same
+// GrpcContext: a handler that re-posts itself through the executor and a loop that dispatches from within a handler.
+// Every allocation from the heap is counted.
+
+#include "benchmark/benchmark.hpp"
+#include "utils/asio_forward.hpp"
+
+#include <agrpc/any_executor.hpp>
+#include <agrpc/grpc_context.hpp>
+#include <agrpc/grpc_executor.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+std::atomic_size_t heap_allocations{};
+}
+
+void* operator new(std::size_t size)
+{
+    heap_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+namespace
+{
+std::size_t allocations(agrpc::GrpcContext& grpc_context)
+{
+    return heap_allocations.load(std::memory_order_relaxed) + bench::pool_upstream_allocations(grpc_context);
+}
+
+template <class Executor>
+struct Repost
+{
+    Executor executor;
+    std::size_t remaining;
+
+    void operator()()
+    {
+        if (--remaining != 0)
+        {
+            asio::post(executor, Repost{executor, remaining});
+        }
+    }
+};
+
+template <class Executor>
+bench::Measurement post(std::size_t iterations)
+{
+    agrpc::GrpcContext grpc_context{std::make_unique<grpc::CompletionQueue>()};
+    const Executor executor{grpc_context.get_executor()};
+    // Warm up the GrpcContext's local memory pool
+    asio::post(executor, Repost<Executor>{executor, 1000});
+    grpc_context.run();
+    grpc_context.reset();
+    asio::post(executor, Repost<Executor>{executor, iterations + 1});
+    bench::Stopwatch stopwatch{allocations(grpc_context)};
+    grpc_context.run();
+    return stopwatch.stop(allocations(grpc_context));
+}
+
+// Dispatches from within a handler, where all executors may invoke the function inline
+template <class Executor>
+bench::Measurement dispatch(std::size_t iterations)
+{
+    agrpc::GrpcContext grpc_context{std::make_unique<grpc::CompletionQueue>()};
+    const Executor executor{grpc_context.get_executor()};
+    bench::Measurement measurement;
+    asio::post(grpc_context,
+               [&]
+               {
+                   std::size_t count{};
+                   bench::Stopwatch stopwatch{allocations(grpc_context)};
+                   for (std::size_t i{}; i != iterations; ++i)
+                   {
+                       asio::dispatch(executor,
+                                      [&]
+                                      {
+                                          ++count;
+                                      });
+                   }
+                   measurement = stopwatch.stop(allocations(grpc_context));
+                   if (count != iterations)
+                   {
+                       std::abort();
+                   }
+               });
+    grpc_context.run();
+    return measurement;
+}
+}
+
+int main(int argc, char* argv[])
+{
+    const std::size_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    std::printf("sizeof: GrpcExecutor %zu, agrpc::AnyExecutor %zu, asio::any_io_executor %zu\n",
+                sizeof(agrpc::GrpcExecutor), sizeof(agrpc::AnyExecutor), sizeof(asio::any_io_executor));
+    bench::report("post, GrpcExecutor", iterations, post<agrpc::GrpcExecutor>(iterations));
+    bench::report("post, agrpc::AnyExecutor", iterations, post<agrpc::AnyExecutor>(iterations));
+    bench::report("post, asio::any_io_executor", iterations, post<asio::any_io_executor>(iterations));
+    bench::report("dispatch, GrpcExecutor", iterations, dispatch<agrpc::GrpcExecutor>(iterations));
+    bench::report("dispatch, agrpc::AnyExecutor", iterations, dispatch<agrpc::AnyExecutor>(iterations));
+    bench::report("dispatch, asio::any_io_executor", iterations, dispatch<asio::any_io_executor>(iterations));
+}
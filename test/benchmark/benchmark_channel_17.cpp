@@ -0,0 +1,244 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compares agrpc::Channel with asio's channels in two scenarios: values sent from another thread with try_send and
+// received on the GrpcContext's thread, and the reader/writer pipeline of example/generic-server.cpp where both sides
+// run on the GrpcContext and a buffer of two provides backpressure. Every allocation from the heap is counted.
+
+#include "benchmark/benchmark.hpp"
+#include "utils/asio_forward.hpp"
+
+#include <agrpc/channel.hpp>
+#include <agrpc/grpc_context.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <thread>
+
+#if defined(AGRPC_STANDALONE_ASIO) && (ASIO_VERSION >= 102200)
+#include <asio/experimental/channel.hpp>
+#include <asio/experimental/concurrent_channel.hpp>
+
+#define AGRPC_BENCHMARK_HAS_ASIO_CHANNEL
+#elif defined(AGRPC_BOOST_ASIO) && (BOOST_VERSION >= 107800)
+#include <boost/asio/experimental/channel.hpp>
+#include <boost/asio/experimental/concurrent_channel.hpp>
+
+#define AGRPC_BENCHMARK_HAS_ASIO_CHANNEL
+#endif
+
+namespace
+{
+constexpr std::size_t BUFFER_SIZE = 16;
+constexpr std::size_t PIPELINE_BUFFER_SIZE = 2;
+
+std::atomic_size_t heap_allocations{};
+}
+
+void* operator new(std::size_t size)
+{
+    heap_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+namespace
+{
+std::size_t allocations(agrpc::GrpcContext& grpc_context)
+{
+    return heap_allocations.load(std::memory_order_relaxed) + bench::pool_upstream_allocations(grpc_context);
+}
+
+template <class TrySend>
+std::thread produce(std::size_t message_count, TrySend try_send)
+{
+    return std::thread{[message_count, try_send]
+                       {
+                           for (std::size_t i{}; i != message_count; ++i)
+                           {
+                               while (!try_send(i))
+                               {
+                                   std::this_thread::yield();
+                               }
+                           }
+                       }};
+}
+
+struct AgrpcReceiver
+{
+    agrpc::Channel<std::size_t>& channel;
+    std::size_t remaining;
+
+    void operator()(bool ok, std::size_t)
+    {
+        if (ok && --remaining != 0)
+        {
+            channel.receive(std::move(*this));
+        }
+    }
+};
+
+bench::Measurement agrpc_channel(std::size_t message_count)
+{
+    agrpc::GrpcContext grpc_context{std::make_unique<grpc::CompletionQueue>()};
+    agrpc::Channel<std::size_t> channel{grpc_context, BUFFER_SIZE};
+    channel.receive(AgrpcReceiver{channel, message_count});
+    bench::Stopwatch stopwatch{allocations(grpc_context)};
+    auto producer = produce(message_count,
+                            [&](std::size_t i)
+                            {
+                                return channel.try_send(i);
+                            });
+    grpc_context.run();
+    const auto measurement = stopwatch.stop(allocations(grpc_context));
+    producer.join();
+    return measurement;
+}
+
+struct AgrpcSender
+{
+    agrpc::Channel<std::size_t>& channel;
+    std::size_t next;
+    std::size_t message_count;
+
+    void operator()(bool ok)
+    {
+        if (ok && ++next != message_count)
+        {
+            channel.send(next, std::move(*this));
+        }
+        else
+        {
+            channel.close();
+        }
+    }
+};
+
+bench::Measurement agrpc_channel_pipeline(std::size_t message_count)
+{
+    agrpc::GrpcContext grpc_context{std::make_unique<grpc::CompletionQueue>()};
+    agrpc::Channel<std::size_t> channel{grpc_context, PIPELINE_BUFFER_SIZE};
+    channel.receive(AgrpcReceiver{channel, message_count});
+    channel.send(std::size_t{}, AgrpcSender{channel, 0, message_count});
+    bench::Stopwatch stopwatch{allocations(grpc_context)};
+    grpc_context.run();
+    return stopwatch.stop(allocations(grpc_context));
+}
+
+#ifdef AGRPC_BENCHMARK_HAS_ASIO_CHANNEL
+using AsioChannel = asio::experimental::concurrent_channel<void(test::ErrorCode, std::size_t)>;
+
+struct AsioReceiver
+{
+    AsioChannel& channel;
+    std::size_t remaining;
+
+    void operator()(const test::ErrorCode& ec, std::size_t)
+    {
+        if (!ec && --remaining != 0)
+        {
+            channel.async_receive(std::move(*this));
+        }
+    }
+};
+
+bench::Measurement asio_channel(std::size_t message_count)
+{
+    agrpc::GrpcContext grpc_context{std::make_unique<grpc::CompletionQueue>()};
+    AsioChannel channel{grpc_context, BUFFER_SIZE};
+    channel.async_receive(AsioReceiver{channel, message_count});
+    bench::Stopwatch stopwatch{allocations(grpc_context)};
+    auto producer = produce(message_count,
+                            [&](std::size_t i)
+                            {
+                                return channel.try_send(test::ErrorCode{}, i);
+                            });
+    grpc_context.run();
+    const auto measurement = stopwatch.stop(allocations(grpc_context));
+    producer.join();
+    return measurement;
+}
+
+using AsioPipelineChannel = asio::experimental::channel<agrpc::GrpcExecutor, void(test::ErrorCode, std::size_t)>;
+
+struct AsioPipelineReceiver
+{
+    AsioPipelineChannel& channel;
+
+    void operator()(const test::ErrorCode& ec, std::size_t)
+    {
+        if (!ec)
+        {
+            channel.async_receive(std::move(*this));
+        }
+    }
+};
+
+struct AsioPipelineSender
+{
+    AsioPipelineChannel& channel;
+    std::size_t next;
+    std::size_t message_count;
+
+    void operator()(const test::ErrorCode& ec)
+    {
+        if (!ec && ++next != message_count)
+        {
+            channel.async_send(test::ErrorCode{}, next, std::move(*this));
+        }
+        else
+        {
+            channel.close();
+        }
+    }
+};
+
+bench::Measurement asio_channel_pipeline(std::size_t message_count)
+{
+    agrpc::GrpcContext grpc_context{std::make_unique<grpc::CompletionQueue>()};
+    AsioPipelineChannel channel{grpc_context, PIPELINE_BUFFER_SIZE};
+    channel.async_receive(AsioPipelineReceiver{channel});
+    channel.async_send(test::ErrorCode{}, std::size_t{}, AsioPipelineSender{channel, 0, message_count});
+    bench::Stopwatch stopwatch{allocations(grpc_context)};
+    grpc_context.run();
+    return stopwatch.stop(allocations(grpc_context));
+}
+#endif
+}
+
+int main(int argc, char* argv[])
+{
+    const std::size_t message_count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    bench::report("cross-thread try_send/receive, agrpc::Channel", message_count, agrpc_channel(message_count));
+#ifdef AGRPC_BENCHMARK_HAS_ASIO_CHANNEL
+    bench::report("cross-thread try_send/receive, asio concurrent_channel", message_count,
+                  asio_channel(message_count));
+#endif
+    bench::report("generic-server pipeline, agrpc::Channel", message_count, agrpc_channel_pipeline(message_count));
+#ifdef AGRPC_BENCHMARK_HAS_ASIO_CHANNEL
+    bench::report("generic-server pipeline, asio channel", message_count, asio_channel_pipeline(message_count));
+#else
+    std::puts("asio::experimental::channel requires Asio 1.22 (Boost 1.78) or later");
+#endif
+}
@@ -0,0 +1,140 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compares a bidirectional read/process/write loop composed with asio::deferred when its operations are allocated from
+// the GrpcContext's local memory pool (the default) with the same loop allocating every operation from the heap.
+
+#include "benchmark/benchmark.hpp"
+#include "test/v1/test.grpc.pb.h"
+#include "utils/asio_forward.hpp"
+
+#include <agrpc/bind_allocator.hpp>
+#include <agrpc/grpc_context.hpp>
+#include <agrpc/rpc.hpp>
+#include <grpcpp/create_channel.h>
+#include <grpcpp/server.h>
+#include <grpcpp/server_builder.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <string>
+
+#ifdef AGRPC_TEST_ASIO_HAS_NEW_SPAWN
+namespace
+{
+constexpr std::size_t WARMUP_MESSAGES = 1000;
+
+void rethrow(std::exception_ptr ep)
+{
+    if (ep)
+    {
+        std::rethrow_exception(ep);
+    }
+}
+
+template <class Allocator>
+bench::Measurement read_process_write(std::size_t message_count, Allocator allocator, std::size_t& heap_allocations)
+{
+    grpc::ServerBuilder builder;
+    int port{};
+    builder.AddListeningPort("127.0.0.1:0", grpc::InsecureServerCredentials(), &port);
+    test::v1::Test::AsyncService service;
+    builder.RegisterService(&service);
+    agrpc::GrpcContext grpc_context{builder.AddCompletionQueue()};
+    auto server = builder.BuildAndStart();
+    auto stub = test::v1::Test::NewStub(
+        grpc::CreateChannel("127.0.0.1:" + std::to_string(port), grpc::InsecureChannelCredentials()));
+    const auto total_messages = WARMUP_MESSAGES + message_count;
+    const auto allocations = [&]
+    {
+        return bench::pool_upstream_allocations(grpc_context) + heap_allocations;
+    };
+    bench::Measurement measurement;
+    asio::spawn(
+        grpc_context,
+        [&](const asio::yield_context& yield)
+        {
+            grpc::ServerContext server_context;
+            grpc::ServerAsyncReaderWriter<test::msg::Response, test::msg::Request> reader_writer{&server_context};
+            agrpc::request(&test::v1::Test::AsyncService::RequestBidirectionalStreaming, service, server_context,
+                           reader_writer, yield);
+            test::msg::Request request;
+            test::msg::Response response;
+            for (std::size_t i{}; i != total_messages; ++i)
+            {
+                agrpc::read(reader_writer, request,
+                            agrpc::bind_allocator(allocator, test::ASIO_DEFERRED(
+                                                                 [&](bool)
+                                                                 {
+                                                                     response.set_integer(request.integer() * 2);
+                                                                     return agrpc::write(
+                                                                         reader_writer, response,
+                                                                         agrpc::bind_allocator(allocator,
+                                                                                               test::ASIO_DEFERRED));
+                                                                 })))(yield);
+            }
+            agrpc::finish(reader_writer, grpc::Status::OK, yield);
+        },
+        &rethrow);
+    asio::spawn(
+        grpc_context,
+        [&](const asio::yield_context& yield)
+        {
+            grpc::ClientContext client_context;
+            std::unique_ptr<grpc::ClientAsyncReaderWriter<test::msg::Request, test::msg::Response>> reader_writer;
+            agrpc::request(&test::v1::Test::Stub::PrepareAsyncBidirectionalStreaming, *stub, client_context,
+                           reader_writer, yield);
+            test::msg::Request request;
+            test::msg::Response response;
+            std::optional<bench::Stopwatch> stopwatch;
+            for (std::size_t i{}; i != total_messages; ++i)
+            {
+                if (WARMUP_MESSAGES == i)
+                {
+                    stopwatch.emplace(allocations());
+                }
+                request.set_integer(static_cast<int>(i));
+                asio::experimental::make_parallel_group(
+                    agrpc::write(reader_writer, request, asio::bind_executor(grpc_context, test::ASIO_DEFERRED)),
+                    agrpc::read(reader_writer, response, asio::bind_executor(grpc_context, test::ASIO_DEFERRED)))
+                    .async_wait(asio::experimental::wait_for_all(), yield);
+            }
+            measurement = stopwatch->stop(allocations());
+            agrpc::writes_done(reader_writer, yield);
+            grpc::Status status;
+            agrpc::finish(reader_writer, status, yield);
+        },
+        &rethrow);
+    grpc_context.run();
+    server->Shutdown();
+    return measurement;
+}
+}
+
+int main(int argc, char* argv[])
+{
+    const std::size_t message_count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+    std::size_t heap_allocations{};
+    bench::report("deferred read/process/write, GrpcContext pool", message_count,
+                  read_process_write(message_count, std::allocator<std::byte>{}, heap_allocations));
+    bench::report("deferred read/process/write, heap allocator", message_count,
+                  read_process_write(message_count, bench::CountingAllocator<>{heap_allocations}, heap_allocations));
+}
+#else
+int main() { std::puts("This benchmark requires Asio 1.24 (Boost 1.80) or later"); }
+#endif
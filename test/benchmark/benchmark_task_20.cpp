@@ -0,0 +1,160 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compares agrpc::Task with asio::awaitable in two scenarios: a coroutine that awaits a child coroutine which returns
+// immediately, measuring frame allocation and symmetric transfer, and one whose child additionally awaits
+// agrpc::yield, a round trip through the GrpcContext. Every allocation from the heap is counted.
+
+#include "benchmark/benchmark.hpp"
+#include "utils/asio_forward.hpp"
+
+#include <agrpc/grpc_context.hpp>
+#include <agrpc/task.hpp>
+#include <agrpc/yield.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <new>
+#include <optional>
+
+#if defined(AGRPC_HAS_STD_COROUTINE) && defined(AGRPC_ASIO_HAS_CO_AWAIT)
+namespace
+{
+constexpr std::size_t WARMUP_ITERATIONS = 1000;
+
+std::atomic_size_t heap_allocations{};
+}
+
+void* operator new(std::size_t size)
+{
+    heap_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+namespace
+{
+std::size_t allocations(agrpc::GrpcContext& grpc_context)
+{
+    return heap_allocations.load(std::memory_order_relaxed) + bench::pool_upstream_allocations(grpc_context);
+}
+
+void rethrow(std::exception_ptr ep)
+{
+    if (ep)
+    {
+        std::rethrow_exception(ep);
+    }
+}
+
+agrpc::Task<std::size_t> task_child(agrpc::GrpcContext& grpc_context, std::size_t i, bool wait)
+{
+    if (wait)
+    {
+        co_await agrpc::yield(grpc_context, agrpc::use_sender);
+    }
+    co_return i;
+}
+
+agrpc::Task<std::size_t> task_parent(agrpc::GrpcContext& grpc_context, std::size_t iterations, bool wait,
+                                     bench::Measurement& measurement)
+{
+    std::size_t sum{};
+    std::optional<bench::Stopwatch> stopwatch;
+    for (std::size_t i{}; i != WARMUP_ITERATIONS + iterations; ++i)
+    {
+        if (WARMUP_ITERATIONS == i)
+        {
+            stopwatch.emplace(allocations(grpc_context));
+        }
+        sum += co_await task_child(grpc_context, i, wait);
+    }
+    measurement = stopwatch->stop(allocations(grpc_context));
+    co_return sum;
+}
+
+asio::awaitable<std::size_t> awaitable_child(agrpc::GrpcContext& grpc_context, std::size_t i, bool wait)
+{
+    if (wait)
+    {
+        co_await agrpc::yield(grpc_context, asio::use_awaitable);
+    }
+    co_return i;
+}
+
+asio::awaitable<std::size_t> awaitable_parent(agrpc::GrpcContext& grpc_context, std::size_t iterations, bool wait,
+                                              bench::Measurement& measurement)
+{
+    std::size_t sum{};
+    std::optional<bench::Stopwatch> stopwatch;
+    for (std::size_t i{}; i != WARMUP_ITERATIONS + iterations; ++i)
+    {
+        if (WARMUP_ITERATIONS == i)
+        {
+            stopwatch.emplace(allocations(grpc_context));
+        }
+        sum += co_await awaitable_child(grpc_context, i, wait);
+    }
+    measurement = stopwatch->stop(allocations(grpc_context));
+    co_return sum;
+}
+
+bench::Measurement task(std::size_t iterations, bool wait)
+{
+    agrpc::GrpcContext grpc_context{std::make_unique<grpc::CompletionQueue>()};
+    bench::Measurement measurement;
+    agrpc::co_spawn(grpc_context, task_parent(grpc_context, iterations, wait, measurement),
+                    [](std::exception_ptr ep, std::size_t)
+                    {
+                        rethrow(ep);
+                    });
+    grpc_context.run();
+    return measurement;
+}
+
+bench::Measurement awaitable(std::size_t iterations, bool wait)
+{
+    agrpc::GrpcContext grpc_context{std::make_unique<grpc::CompletionQueue>()};
+    bench::Measurement measurement;
+    asio::co_spawn(grpc_context, awaitable_parent(grpc_context, iterations, wait, measurement),
+                   [](std::exception_ptr ep, std::size_t)
+                   {
+                       rethrow(ep);
+                   });
+    grpc_context.run();
+    return measurement;
+}
+}
+
+int main(int argc, char* argv[])
+{
+    const std::size_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    bench::report("await child coroutine, agrpc::Task", iterations, task(iterations, false));
+    bench::report("await child coroutine, asio::awaitable", iterations, awaitable(iterations, false));
+    bench::report("await child coroutine that yields, agrpc::Task", iterations, task(iterations, true));
+    bench::report("await child coroutine that yields, asio::awaitable", iterations, awaitable(iterations, true));
+}
+#else
+int main() { std::puts("This benchmark requires C++20 coroutines"); }
+#endif
@@ -0,0 +1,76 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "utils/asio_utils.hpp"
+#include "utils/doctest.hpp"
+#include "utils/grpc_context_test.hpp"
+
+#include <agrpc/any_executor.hpp>
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "AnyExecutor: dispatch runs inline when constructed from a GrpcExecutor")
+{
+    const agrpc::AnyExecutor executor{get_executor()};
+    CHECK_EQ(&grpc_context, executor.grpc_context());
+    CHECK_EQ(&grpc_context, &asio::query(executor, asio::execution::context));
+    bool posted{};
+    bool dispatched{};
+    test::post(grpc_context,
+               [&]
+               {
+                   asio::post(executor,
+                              [&]
+                              {
+                                  posted = true;
+                              });
+                   asio::dispatch(executor,
+                                  [&]
+                                  {
+                                      dispatched = true;
+                                  });
+                   CHECK_FALSE(posted);
+                   CHECK(dispatched);
+               });
+    grpc_context.run();
+    CHECK(posted);
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "AnyExecutor: outstanding_work.tracked is balanced across copies and moves")
+{
+    {
+        const auto tracked = asio::prefer(agrpc::AnyExecutor{get_executor()}, asio::execution::outstanding_work.tracked);
+        auto copy = tracked;
+        const agrpc::AnyExecutor moved{std::move(copy)};
+        CHECK_EQ(tracked, moved);
+        CHECK_NE(agrpc::AnyExecutor{get_executor()}, moved);
+        CHECK_FALSE(grpc_context.is_stopped());
+    }
+    CHECK(grpc_context.is_stopped());
+}
+
+TEST_CASE("AnyExecutor: falls back to type-erasure for other executors")
+{
+    asio::io_context io_context;
+    const agrpc::AnyExecutor executor{io_context.get_executor()};
+    CHECK_FALSE(executor.grpc_context());
+    CHECK_EQ(&io_context, &asio::query(executor, asio::execution::context));
+    CHECK_EQ(executor, agrpc::AnyExecutor{io_context.get_executor()});
+    bool invoked{};
+    asio::post(executor,
+               [&]
+               {
+                   invoked = true;
+               });
+    io_context.run();
+    CHECK(invoked);
+}
@@ -0,0 +1,52 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "utils/asio_utils.hpp"
+#include "utils/doctest.hpp"
+#include "utils/grpc_context_test.hpp"
+#include "utils/time.hpp"
+
+#include <agrpc/any_executor.hpp>
+#include <agrpc/wait.hpp>
+
+#include <exception>
+
+#ifdef AGRPC_ASIO_HAS_CO_AWAIT
+TEST_CASE_FIXTURE(test::GrpcContextTest, "AnyExecutor: co_spawn an awaitable that uses it as its executor")
+{
+    static constexpr asio::use_awaitable_t<agrpc::AnyExecutor> USE_AWAITABLE{};
+    bool completed{};
+    std::exception_ptr exception;
+    asio::co_spawn(
+        grpc_context,
+        [&]() -> asio::awaitable<int, agrpc::AnyExecutor>
+        {
+            const auto executor = co_await asio::this_coro::executor;
+            CHECK_EQ(&grpc_context, executor.grpc_context());
+            grpc::Alarm alarm;
+            const bool ok = co_await agrpc::wait(alarm, test::ten_milliseconds_from_now(), USE_AWAITABLE);
+            CHECK(ok);
+            co_await asio::post(executor, USE_AWAITABLE);
+            co_return 42;
+        },
+        [&](std::exception_ptr ep, int value)
+        {
+            exception = ep;
+            completed = 42 == value;
+        });
+    grpc_context.run();
+    CHECK_FALSE(exception);
+    CHECK(completed);
+}
+#endif
@@ -629,6 +629,92 @@ TEST_CASE_FIXTURE(test::GrpcClientServerTest,
     CHECK_GE(expected, tracked.bytes_allocated);
 }
 
+#ifdef AGRPC_TEST_ASIO_HAS_FIXED_DEFERRED
+TEST_CASE_FIXTURE(test::GrpcClientServerTest, "asio::deferred RPC operations only store their arguments")
+{
+    grpc::ServerAsyncReaderWriter<test::msg::Response, test::msg::Request> reader_writer{&server_context};
+    test::msg::Request request;
+    test::msg::Response response;
+    grpc::Alarm alarm;
+    auto read = agrpc::read(reader_writer, request, test::ASIO_DEFERRED);
+    auto write = agrpc::write(reader_writer, response, test::ASIO_DEFERRED);
+    auto finish = agrpc::finish(reader_writer, grpc::Status::OK, test::ASIO_DEFERRED);
+    auto wait = agrpc::wait(alarm, test::ten_milliseconds_from_now(), test::ASIO_DEFERRED);
+    const auto expected = sizeof(void*) * 4;
+    CHECK_GE(expected, sizeof(read));
+    CHECK_GE(expected, sizeof(write));
+    CHECK_GE(expected, sizeof(finish));
+    CHECK_GE(expected, sizeof(wait));
+    CHECK(std::is_nothrow_move_constructible_v<decltype(read)>);
+    CHECK(std::is_nothrow_move_constructible_v<decltype(write)>);
+    CHECK(std::is_nothrow_move_constructible_v<decltype(wait)>);
+}
+
+TEST_CASE_FIXTURE(test::GrpcClientServerTest, "asio::deferred read/process/write loop with make_parallel_group")
+{
+    static constexpr int MESSAGE_COUNT = 5;
+    const auto pool_upstream_allocations = [&]
+    {
+        return grpc_context.get_allocator().resource()->upstream_allocations();
+    };
+    std::size_t upstream_allocations_after_first_message{};
+    test::spawn_and_run(
+        grpc_context,
+        [&](const asio::yield_context& yield)
+        {
+            grpc::ServerAsyncReaderWriter<test::msg::Response, test::msg::Request> reader_writer{&server_context};
+            CHECK(agrpc::request(&test::v1::Test::AsyncService::RequestBidirectionalStreaming, service, server_context,
+                                 reader_writer, test::ASIO_DEFERRED)(yield));
+            test::msg::Request request;
+            test::msg::Response response;
+            for (int i{}; i != MESSAGE_COUNT; ++i)
+            {
+                CHECK(agrpc::read(reader_writer, request,
+                                  test::ASIO_DEFERRED(
+                                      [&](bool read_ok)
+                                      {
+                                          CHECK(read_ok);
+                                          response.set_integer(request.integer() * 2);
+                                          return agrpc::write(reader_writer, response, test::ASIO_DEFERRED);
+                                      }))(yield));
+                if (0 == i)
+                {
+                    upstream_allocations_after_first_message = pool_upstream_allocations();
+                }
+            }
+            // The operations use the default associated allocator and are therefore taken from the GrpcContext's
+            // pool. After the first message they are served from its free lists without allocating upstream.
+            CHECK_LT(0, upstream_allocations_after_first_message);
+            CHECK_EQ(upstream_allocations_after_first_message, pool_upstream_allocations());
+            CHECK(agrpc::finish(reader_writer, grpc::Status::OK, test::ASIO_DEFERRED)(yield));
+        },
+        [&](const asio::yield_context& yield)
+        {
+            std::unique_ptr<grpc::ClientAsyncReaderWriter<test::msg::Request, test::msg::Response>> reader_writer;
+            CHECK(agrpc::request(&test::v1::Test::Stub::PrepareAsyncBidirectionalStreaming, *stub, client_context,
+                                 reader_writer, yield));
+            test::msg::Request request;
+            test::msg::Response response;
+            for (int i{}; i != MESSAGE_COUNT; ++i)
+            {
+                request.set_integer(i + 1);
+                auto [completion_order, write_ok, read_ok] =
+                    asio::experimental::make_parallel_group(
+                        agrpc::write(reader_writer, request, asio::bind_executor(grpc_context, test::ASIO_DEFERRED)),
+                        agrpc::read(reader_writer, response, asio::bind_executor(grpc_context, test::ASIO_DEFERRED)))
+                        .async_wait(asio::experimental::wait_for_all(), yield);
+                CHECK(write_ok);
+                CHECK(read_ok);
+                CHECK_EQ((i + 1) * 2, response.integer());
+            }
+            CHECK(agrpc::writes_done(reader_writer, yield));
+            grpc::Status status;
+            CHECK(agrpc::finish(reader_writer, status, yield));
+            CHECK(status.ok());
+        });
+}
+#endif
+
 TEST_CASE_FIXTURE(test::GrpcClientServerTest, "RPC step after grpc_context stop")
 {
     std::optional<bool> ok;
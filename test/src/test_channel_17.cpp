@@ -0,0 +1,227 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "utils/asio_utils.hpp"
+#include "utils/doctest.hpp"
+#include "utils/grpc_context_test.hpp"
+
+#include <agrpc/channel.hpp>
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "Channel: try_send respects max_buffer_size")
+{
+    agrpc::Channel<int> channel{grpc_context, 2};
+    CHECK_EQ(2, channel.max_buffer_size());
+    CHECK(channel.try_send(1));
+    CHECK(channel.try_send(2));
+    int value{3};
+    CHECK_FALSE(channel.try_send(value));
+    std::vector<int> received;
+    channel.receive(
+        [&](bool ok, int value)
+        {
+            CHECK(ok);
+            received.push_back(value);
+            CHECK(channel.try_send(3));
+        });
+    grpc_context.run();
+    CHECK_EQ(std::vector{1}, received);
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "Channel: try_send from other threads wakes up the receiver")
+{
+    static constexpr int MESSAGES_PER_THREAD = 1000;
+    static constexpr int THREAD_COUNT = 4;
+    agrpc::Channel<int> channel{grpc_context, 4};
+    std::vector<std::thread> producers;
+    for (int i{}; i < THREAD_COUNT; ++i)
+    {
+        producers.emplace_back(
+            [&]
+            {
+                for (int message{1}; message <= MESSAGES_PER_THREAD; ++message)
+                {
+                    while (!channel.try_send(message))
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+    }
+    int count{};
+    long long sum{};
+    std::function<void()> receive = [&]
+    {
+        channel.receive(
+            [&](bool ok, int value)
+            {
+                if (!ok)
+                {
+                    return;
+                }
+                sum += value;
+                if (++count == MESSAGES_PER_THREAD * THREAD_COUNT)
+                {
+                    channel.close();
+                }
+                receive();
+            });
+    };
+    receive();
+    grpc_context.run();
+    for (auto& producer : producers)
+    {
+        producer.join();
+    }
+    CHECK_EQ(MESSAGES_PER_THREAD * THREAD_COUNT, count);
+    CHECK_EQ(THREAD_COUNT * MESSAGES_PER_THREAD * (MESSAGES_PER_THREAD + 1) / 2, sum);
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "Channel: can be destroyed right after receiving a value from another thread")
+{
+    for (int i{}; i < 1000; ++i)
+    {
+        std::optional<agrpc::Channel<int>> channel;
+        channel.emplace(grpc_context, 1);
+        std::thread producer{[&]
+                             {
+                                 CHECK(channel->try_send(i));
+                             }};
+        int received{-1};
+        channel->receive(
+            [&](bool ok, int value)
+            {
+                CHECK(ok);
+                received = value;
+            });
+        grpc_context.run();
+        channel.reset();
+        producer.join();
+        CHECK_EQ(i, received);
+    }
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "Channel: send waits for buffer space and close completes waiting senders")
+{
+    agrpc::Channel<std::unique_ptr<int>> channel{grpc_context, 1};
+    std::vector<bool> send_results;
+    for (int i{1}; i <= 3; ++i)
+    {
+        channel.send(std::make_unique<int>(i),
+                     [&](bool ok)
+                     {
+                         send_results.push_back(ok);
+                     });
+    }
+    std::vector<int> received;
+    std::function<void()> receive = [&]
+    {
+        channel.receive(
+            [&](bool ok, std::unique_ptr<int> value)
+            {
+                if (!ok)
+                {
+                    return;
+                }
+                received.push_back(*value);
+                if (received.size() == 1)
+                {
+                    // The value of the second send has been moved into the buffer, the third is still waiting.
+                    channel.close();
+                }
+                receive();
+            });
+    };
+    post(receive);
+    grpc_context.run();
+    CHECK_EQ(std::vector{1, 2}, received);
+    CHECK_EQ(std::vector{true, true, false}, send_results);
+}
+
+TEST_CASE("Channel: parked operations are destroyed when the GrpcContext shuts down")
+{
+    bool invoked{false};
+    auto handler_state = std::make_shared<int>();
+    std::optional<agrpc::GrpcContext> grpc_context{std::make_unique<grpc::CompletionQueue>()};
+    std::optional<agrpc::Channel<int>> channel;
+    channel.emplace(*grpc_context, 1);
+    SUBCASE("receive")
+    {
+        channel->receive(
+            [&, handler_state](bool, int)
+            {
+                invoked = true;
+            });
+    }
+    SUBCASE("send")
+    {
+        CHECK(channel->try_send(1));
+        channel->send(2,
+                      [&, handler_state](bool)
+                      {
+                          invoked = true;
+                      });
+    }
+    grpc_context->poll();
+    grpc_context.reset();
+    CHECK_FALSE(invoked);
+    CHECK_EQ(1, handler_state.use_count());
+    channel.reset();
+}
+
+TEST_CASE("Channel: can be owned by a completion handler that is destroyed when the GrpcContext shuts down")
+{
+    bool invoked{false};
+    std::optional<agrpc::GrpcContext> grpc_context{std::make_unique<grpc::CompletionQueue>()};
+    auto channel = std::make_shared<agrpc::Channel<int>>(*grpc_context, 1);
+    std::weak_ptr<agrpc::Channel<int>> weak_channel{channel};
+    auto& channel_ref = *channel;
+    SUBCASE("parked receiver")
+    {
+        channel_ref.receive(
+            [&, channel = std::move(channel)](bool, int)
+            {
+                invoked = true;
+            });
+        grpc_context->poll();
+    }
+    SUBCASE("receiver that has been woken up but not yet resumed")
+    {
+        channel_ref.receive(
+            [&, channel = std::move(channel)](bool, int)
+            {
+                invoked = true;
+            });
+        grpc_context->poll();
+        CHECK(channel_ref.try_send(1));
+    }
+    SUBCASE("waiting sender")
+    {
+        CHECK(channel_ref.try_send(1));
+        channel_ref.send(2,
+                         [&, channel = std::move(channel)](bool)
+                         {
+                             invoked = true;
+                         });
+        grpc_context->poll();
+    }
+    grpc_context.reset();
+    CHECK_FALSE(invoked);
+    CHECK(weak_channel.expired());
+}
@@ -0,0 +1,117 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "test/v1/test.grpc.pb.h"
+#include "utils/asio_utils.hpp"
+#include "utils/doctest.hpp"
+#include "utils/high_level_client.hpp"
+#include "utils/time.hpp"
+
+#include <agrpc/client_middleware.hpp>
+#include <agrpc/rpc.hpp>
+
+#include <string>
+#include <vector>
+
+namespace
+{
+struct AddMetadataInterceptor
+{
+    std::vector<std::string>* events;
+
+    void before(grpc::ClientContext& client_context)
+    {
+        events->emplace_back("metadata.before");
+        client_context.AddMetadata("test-key", "test-value");
+    }
+};
+
+struct RecordingInterceptor
+{
+    std::vector<std::string>* events;
+    std::string name;
+
+    void before(grpc::ClientContext&) { events->push_back(name + ".before"); }
+
+    void after(grpc::ClientContext&, const grpc::Status& status) noexcept
+    {
+        events->push_back(name + ".after:" + std::to_string(status.error_code()));
+    }
+};
+}
+
+TEST_CASE_FIXTURE(test::HighLevelClientTest<test::UnaryRPC>,
+                  "ClientMiddleware: interceptors run around unary request")
+{
+    std::vector<std::string> events;
+    const agrpc::ClientMiddleware client{*stub, RecordingInterceptor{&events, "outer"},
+                                         AddMetadataInterceptor{&events}, RecordingInterceptor{&events, "inner"}};
+    bool finish_with_error{false};
+    SUBCASE("ok") {}
+    SUBCASE("error") { finish_with_error = true; }
+    spawn_and_run(
+        [&](const asio::yield_context& yield)
+        {
+            CHECK(test_server.request_rpc(yield));
+            const auto& metadata = server_context.client_metadata();
+            REQUIRE_EQ(1, metadata.count("test-key"));
+            const auto value = metadata.find("test-key")->second;
+            CHECK_EQ("test-value", std::string(value.data(), value.size()));
+            if (finish_with_error)
+            {
+                CHECK(agrpc::finish_with_error(test_server.responder, grpc::Status::CANCELLED, yield));
+            }
+            else
+            {
+                test_server.response.set_integer(21);
+                CHECK(agrpc::finish(test_server.responder, test_server.response, grpc::Status::OK, yield));
+            }
+        },
+        [&](const asio::yield_context& yield)
+        {
+            const auto status = client.request<&test::v1::Test::Stub::PrepareAsyncUnary>(grpc_context, client_context,
+                                                                                         request, response, yield);
+            events.emplace_back("completion");
+            CHECK_EQ(finish_with_error, !status.ok());
+        });
+    const auto code = std::to_string(finish_with_error ? grpc::StatusCode::CANCELLED : grpc::StatusCode::OK);
+    const std::vector<std::string> expected{"outer.before",       "metadata.before",    "inner.before",
+                                            "inner.after:" + code, "outer.after:" + code, "completion"};
+    CHECK_EQ(expected, events);
+    if (!finish_with_error)
+    {
+        CHECK_EQ(21, response.integer());
+    }
+}
+
+TEST_CASE_FIXTURE(test::HighLevelClientTest<test::UnaryRPC>,
+                  "ClientMiddleware: after hooks run when the GrpcContext shuts down before the RPC has finished")
+{
+    std::vector<std::string> events;
+    const agrpc::ClientMiddleware client{*stub, RecordingInterceptor{&events, "outer"},
+                                         RecordingInterceptor{&events, "inner"}};
+    client_context.set_deadline(test::two_hundred_milliseconds_from_now());
+    client.request<&test::v1::Test::Stub::PrepareAsyncUnary>(grpc_context, client_context, request, response,
+                                                              [&](const grpc::Status&)
+                                                              {
+                                                                  events.emplace_back("completion");
+                                                              });
+    grpc_context.poll();
+    server->Shutdown();
+    grpc_context_lifetime.reset();
+    const auto code = std::to_string(grpc::StatusCode::CANCELLED);
+    const std::vector<std::string> expected{"outer.before", "inner.before", "inner.after:" + code,
+                                            "outer.after:" + code};
+    CHECK_EQ(expected, events);
+}
@@ -0,0 +1,107 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "utils/asio_utils.hpp"
+#include "utils/doctest.hpp"
+#include "utils/grpc_context_test.hpp"
+#include "utils/time.hpp"
+
+#include <agrpc/deadline_scheduler.hpp>
+
+#include <chrono>
+#include <optional>
+#include <thread>
+#include <vector>
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "DeadlineScheduler: runs ready work in earliest-deadline-first order")
+{
+    agrpc::DeadlineScheduler scheduler{grpc_context};
+    const auto now = test::now();
+    std::vector<int> order;
+    auto post = [&](std::chrono::seconds offset, int id)
+    {
+        asio::post(scheduler.get_executor(now + offset),
+                   [&, id]
+                   {
+                       order.push_back(id);
+                   });
+    };
+    asio::post(grpc_context,
+               [&]
+               {
+                   post(std::chrono::seconds(3), 0);
+                   post(std::chrono::seconds(1), 1);
+                   post(std::chrono::seconds(2), 2);
+                   post(std::chrono::seconds(1), 3);
+                   CHECK_EQ(4, scheduler.size());
+               });
+    grpc_context.run();
+    CHECK_EQ((std::vector{1, 3, 2, 0}), order);
+    CHECK_EQ(0, scheduler.size());
+    CHECK_EQ(0, scheduler.skipped_count());
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "DeadlineScheduler: work submitted from another thread")
+{
+    agrpc::DeadlineScheduler scheduler{grpc_context};
+    bool invoked{};
+    std::thread thread{[&]
+                       {
+                           asio::post(scheduler.get_executor(test::five_seconds_from_now()),
+                                      [&]
+                                      {
+                                          invoked = true;
+                                      });
+                       }};
+    thread.join();
+    grpc_context.run();
+    CHECK(invoked);
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "DeadlineScheduler: optionally skips expired work")
+{
+    agrpc::DeadlineScheduler scheduler{grpc_context, true};
+    const auto now = test::now();
+    std::vector<int> order;
+    asio::post(grpc_context,
+               [&]
+               {
+                   asio::post(scheduler.get_executor(now + std::chrono::seconds(5)),
+                              [&]
+                              {
+                                  order.push_back(0);
+                              });
+                   asio::post(scheduler.get_executor(now - std::chrono::seconds(1)),
+                              [&]
+                              {
+                                  order.push_back(1);
+                              });
+               });
+    grpc_context.run();
+    CHECK_EQ(std::vector{0}, order);
+    CHECK_EQ(1, scheduler.skipped_count());
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "DeadlineScheduler: pending work is destroyed on shutdown")
+{
+    std::optional<agrpc::DeadlineScheduler> scheduler{std::in_place, grpc_context};
+    bool invoked{};
+    asio::post(scheduler->get_executor(test::five_seconds_from_now()),
+               [&]
+               {
+                   invoked = true;
+               });
+    grpc_context_lifetime.reset();
+    CHECK_FALSE(invoked);
+}
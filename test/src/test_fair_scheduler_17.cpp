@@ -0,0 +1,119 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "utils/asio_utils.hpp"
+#include "utils/doctest.hpp"
+#include "utils/grpc_context_test.hpp"
+
+#include <agrpc/fair_scheduler.hpp>
+
+#include <cstddef>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+struct FairSchedulerTest : test::GrpcContextTest
+{
+    agrpc::FairScheduler scheduler{grpc_context, 3};
+    std::vector<std::size_t> order;
+
+    void post(std::size_t class_id)
+    {
+        asio::post(scheduler.get_executor(class_id),
+                   [&, class_id]
+                   {
+                       order.push_back(class_id);
+                   });
+    }
+};
+
+TEST_CASE_FIXTURE(FairSchedulerTest, "FairScheduler: a burst of one class does not starve the others")
+{
+    asio::post(grpc_context,
+               [&]
+               {
+                   for (int i{}; i < 4; ++i)
+                   {
+                       post(0);
+                   }
+                   post(1);
+                   post(2);
+                   CHECK_EQ(4, scheduler.size(0));
+                   CHECK_EQ(1, scheduler.size(1));
+               });
+    grpc_context.run();
+    CHECK_EQ((std::vector<std::size_t>{0, 1, 2, 0, 0, 0}), order);
+    CHECK_EQ(0, scheduler.size(0));
+}
+
+TEST_CASE_FIXTURE(FairSchedulerTest, "FairScheduler: classes run as many handlers per round as their weight")
+{
+    CHECK_EQ(3, scheduler.class_count());
+    scheduler.set_weight(0, 2);
+    CHECK_EQ(2, scheduler.weight(0));
+    CHECK_EQ(1, scheduler.weight(1));
+    asio::post(grpc_context,
+               [&]
+               {
+                   for (int i{}; i < 4; ++i)
+                   {
+                       post(0);
+                       post(1);
+                   }
+               });
+    grpc_context.run();
+    CHECK_EQ((std::vector<std::size_t>{0, 0, 1, 0, 0, 1, 1, 1}), order);
+}
+
+TEST_CASE_FIXTURE(FairSchedulerTest, "FairScheduler: work posted by a handler waits for the next round")
+{
+    asio::post(grpc_context,
+               [&]
+               {
+                   asio::post(scheduler.get_executor(0),
+                              [&]
+                              {
+                                  order.push_back(0);
+                                  post(0);
+                              });
+                   post(1);
+               });
+    grpc_context.run();
+    CHECK_EQ((std::vector<std::size_t>{0, 1, 0}), order);
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "FairScheduler: pending work is destroyed on shutdown")
+{
+    std::optional<agrpc::FairScheduler> scheduler{std::in_place, grpc_context, 1};
+    bool invoked{};
+    asio::post(grpc_context,
+               [&]
+               {
+                   asio::post(scheduler->get_executor(0),
+                              [&]
+                              {
+                                  invoked = true;
+                              });
+                   grpc_context.stop();
+               });
+    grpc_context.run();
+    CHECK_EQ(1, scheduler->size(0));
+    grpc_context_lifetime.reset();
+    CHECK_FALSE(invoked);
+}
+
+TEST_CASE_FIXTURE(FairSchedulerTest, "FairScheduler: get_executor throws for an unknown class id")
+{
+    CHECK_THROWS_AS(static_cast<void>(scheduler.get_executor(3)), std::out_of_range);
+}
@@ -0,0 +1,100 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "utils/doctest.hpp"
+#include "utils/high_level_client.hpp"
+
+#include <agrpc/generic_router.hpp>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+TEST_CASE("GenericRouter: generic_method_name")
+{
+    CHECK_EQ("/test.v1.Test/Unary", agrpc::generic_method_name<test::UnaryRPC>());
+    CHECK_EQ("/test.v1.Test/BidirectionalStreaming", agrpc::generic_method_name<test::BidirectionalStreamingRPC>());
+}
+
+TEST_CASE("GenericRouter: finds the handler of every route")
+{
+    for (std::size_t route_count : {0, 1, 2, 3, 17, 400})
+    {
+        std::vector<agrpc::GenericRouter<int>::route_type> routes;
+        for (std::size_t i{}; i < route_count; ++i)
+        {
+            routes.emplace_back("/test.v" + std::to_string(i % 3) + ".Test/Method" + std::to_string(i),
+                                static_cast<int>(i));
+        }
+        const agrpc::GenericRouter<int> router{routes, -1};
+        CHECK_EQ(route_count, router.size());
+        for (std::size_t i{}; i < route_count; ++i)
+        {
+            CHECK(router.contains(routes[i].first));
+            CHECK_EQ(static_cast<int>(i), router.find(routes[i].first));
+        }
+        CHECK_FALSE(router.contains("/test.v1.Test/Unknown"));
+        CHECK_FALSE(router.contains(""));
+        CHECK_EQ(-1, router.find("/test.v1.Test/Unknown"));
+    }
+}
+
+TEST_CASE("GenericRouter: reports duplicate method names and uses their first route")
+{
+    const agrpc::GenericRouter<int> router{{{"/test.v1.Test/Unary", 1},
+                                            {"/test.v1.Test/ClientStreaming", 2},
+                                            {"/test.v1.Test/Unary", 3},
+                                            {"/test.v1.Test/Unary", 4}},
+                                           -1};
+    CHECK_EQ(2, router.size());
+    CHECK_EQ(1, router.find("/test.v1.Test/Unary"));
+    CHECK_EQ(2, router.find("/test.v1.Test/ClientStreaming"));
+    CHECK_EQ(std::vector<std::string_view>{"/test.v1.Test/Unary", "/test.v1.Test/Unary"}, router.duplicate_methods());
+    const agrpc::GenericRouter<int> unique_router{{{"/test.v1.Test/Unary", 1}}, -1};
+    CHECK(unique_router.duplicate_methods().empty());
+}
+
+namespace
+{
+struct FakeServerContext
+{
+    std::string method_;
+
+    const std::string& method() const { return method_; }
+};
+
+struct FakeRPCContext
+{
+    FakeServerContext server_context_;
+
+    const FakeServerContext& server_context() const { return server_context_; }
+};
+
+std::string invoked_method;
+
+void record(FakeRPCContext&& context) { invoked_method = context.server_context().method(); }
+
+void record_unknown(FakeRPCContext&&) { invoked_method = "unknown"; }
+}
+
+TEST_CASE("GenericRouter: invokes the handler of the context's method")
+{
+    using Handler = void (*)(FakeRPCContext&&);
+    const agrpc::GenericRouter<Handler> router{
+        {{"/test.v1.Test/Unary", &record}, {"/test.v1.Test/ClientStreaming", &record}}, &record_unknown};
+    router(FakeRPCContext{{"/test.v1.Test/ClientStreaming"}});
+    CHECK_EQ("/test.v1.Test/ClientStreaming", invoked_method);
+    router(FakeRPCContext{{"/test.v1.Test/Other"}});
+    CHECK_EQ("unknown", invoked_method);
+}
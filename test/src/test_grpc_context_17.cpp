@@ -25,8 +25,12 @@
 #include <agrpc/grpc_context.hpp>
 #include <agrpc/grpc_executor.hpp>
 #include <agrpc/wait.hpp>
+#include <agrpc/yield.hpp>
 
+#include <algorithm>
+#include <chrono>
 #include <thread>
+#include <vector>
 
 TEST_CASE("GrpcExecutor fulfills Executor TS traits")
 {
@@ -527,6 +531,41 @@ TEST_CASE_FIXTURE(test::GrpcContextTest, "post large local allocation")
     CHECK(ok);
 }
 
+TEST_CASE_FIXTURE(test::GrpcContextTest, "local allocations reuse the GrpcContext's pool")
+{
+    static constexpr int POST_COUNT = 5;
+    const auto upstream_allocations = [&]
+    {
+        return grpc_context.get_allocator().resource()->upstream_allocations();
+    };
+    std::size_t upstream_allocations_after_first_local_post{};
+    int count{};
+    std::function<void()> repost;
+    repost = [&]
+    {
+        ++count;
+        // The first post happens before run() and does not use the local allocator
+        if (2 == count)
+        {
+            upstream_allocations_after_first_local_post = upstream_allocations();
+        }
+        if (POST_COUNT != count)
+        {
+            asio::post(grpc_context,
+                       [&, a = std::array<char, 64>{}]
+                       {
+                           (void)a;
+                           repost();
+                       });
+        }
+    };
+    post(repost);
+    grpc_context.run();
+    CHECK_EQ(POST_COUNT, count);
+    CHECK_LT(0, upstream_allocations_after_first_local_post);
+    CHECK_EQ(upstream_allocations_after_first_local_post, upstream_allocations());
+}
+
 TEST_CASE_FIXTURE(test::GrpcContextTest, "dispatch with allocator")
 {
     post(
@@ -770,6 +809,106 @@ TEST_CASE_FIXTURE(test::GrpcContextTest, "GrpcContext.run_while() runs until the
     CHECK(alarm1_finished);
 }
 
+TEST_CASE_FIXTURE(test::GrpcContextTest, "agrpc::yield completes through the completion queue")
+{
+    std::vector<int> order;
+    grpc::Alarm alarm1;
+    grpc::Alarm alarm2;
+    post(
+        [&]
+        {
+            // Alarms whose deadline has passed are placed into the completion queue immediately
+            const auto deadline = test::now() - std::chrono::seconds(1);
+            wait(alarm1, deadline,
+                 [&](bool)
+                 {
+                     order.push_back(0);
+                 });
+            wait(alarm2, deadline,
+                 [&](bool)
+                 {
+                     order.push_back(1);
+                 });
+            agrpc::yield(grpc_context,
+                         [&]
+                         {
+                             order.push_back(2);
+                         });
+            agrpc::yield(grpc_context,
+                         [&]
+                         {
+                             order.push_back(3);
+                         });
+            CHECK(order.empty());
+        });
+    CHECK(grpc_context.run());
+    // The order of the alarms relative to the yields is up to gRPC
+    REQUIRE_EQ(4, order.size());
+    const auto position = [&](int value)
+    {
+        return std::find(order.begin(), order.end(), value) - order.begin();
+    };
+    CHECK_LT(position(2), position(3));
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "agrpc::yield from another thread")
+{
+    bool invoked{};
+    std::thread{[&]
+                {
+                    agrpc::yield(grpc_context,
+                                 [&]
+                                 {
+                                     invoked = true;
+                                 });
+                }}
+        .join();
+    grpc_context.run();
+    CHECK(invoked);
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "GrpcContext.set_local_work_budget() polls the completion queue in between")
+{
+    std::size_t budget{};
+    std::vector<int> expected{0, 1, 2, 3};
+    SUBCASE("unlimited") {}
+    SUBCASE("budget")
+    {
+        budget = 2;
+        expected = {0, 1, 3, 2};
+    }
+    grpc_context.set_local_work_budget(budget);
+    CHECK_EQ(budget, grpc_context.local_work_budget());
+    std::vector<int> order;
+    grpc::Alarm alarm;
+    post(
+        [&]
+        {
+            post(
+                [&]
+                {
+                    order.push_back(0);
+                    wait(alarm, test::now() - std::chrono::seconds(1),
+                         [&](bool)
+                         {
+                             order.push_back(3);
+                         });
+                });
+            post(
+                [&]
+                {
+                    order.push_back(1);
+                });
+            post(
+                [&]
+                {
+                    order.push_back(2);
+                });
+        });
+    CHECK(grpc_context.run());
+    CHECK_EQ(expected, order);
+}
+
 #ifdef AGRPC_ASIO_HAS_SENDER_RECEIVER
 TEST_CASE_FIXTURE(test::GrpcContextTest, "asio GrpcExecutor::schedule")
 {
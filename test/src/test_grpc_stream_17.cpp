@@ -22,7 +22,9 @@
 #include <agrpc/wait.hpp>
 #include <doctest/doctest.h>
 
+#include <array>
 #include <cstddef>
+#include <vector>
 
 #ifdef AGRPC_ASIO_HAS_CANCELLATION_SLOT
 TEST_CASE_FIXTURE(test::GrpcContextTest, "CancelSafe: cancel wait for alarm and wait again")
@@ -65,6 +67,82 @@ TEST_CASE_TEMPLATE("CancelSafe: wait before initiate", T, bool, test::ErrorCode)
     CHECK(ok);
 }
 
+TEST_CASE_FIXTURE(test::GrpcContextTest, "CancelSafe: small completion handlers are stored without allocating")
+{
+    bool ok{};
+    agrpc::GrpcCancelSafe safe;
+    safe.wait(agrpc::bind_allocator(get_allocator(), asio::bind_executor(grpc_context,
+                                                                         [&](test::ErrorCode ec, bool)
+                                                                         {
+                                                                             ok = !ec;
+                                                                         })));
+    test::post(grpc_context,
+               [&]
+               {
+                   safe.token()(true);
+               });
+    grpc_context.run();
+    CHECK(ok);
+    CHECK_FALSE(allocator_has_been_used());
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "CancelSafe: completion handlers that do not fit are allocated")
+{
+    bool ok{};
+    agrpc::CancelSafe<void(bool), 1, 0> safe;
+    safe.wait(agrpc::bind_allocator(get_allocator(), asio::bind_executor(grpc_context,
+                                                                         [&](test::ErrorCode ec, bool)
+                                                                         {
+                                                                             ok = !ec;
+                                                                         })));
+    test::post(grpc_context,
+               [&]
+               {
+                   safe.token()(true);
+               });
+    grpc_context.run();
+    CHECK(ok);
+    CHECK(allocator_has_been_used());
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "CancelSafe: completion handlers that exceed the buffer are allocated")
+{
+    struct ThrowingMove
+    {
+        ThrowingMove() = default;
+        ThrowingMove(const ThrowingMove&) = default;
+        ThrowingMove(ThrowingMove&&) noexcept(false) {}
+    };
+    bool ok{};
+    agrpc::GrpcCancelSafe safe;
+    SUBCASE("too large")
+    {
+        safe.wait(agrpc::bind_allocator(
+            get_allocator(), asio::bind_executor(grpc_context,
+                                                 [&, padding = std::array<std::byte, 256>{}](test::ErrorCode ec, bool)
+                                                 {
+                                                     ok = !ec && padding.size() == 256;
+                                                 })));
+    }
+    SUBCASE("not nothrow move constructible")
+    {
+        safe.wait(agrpc::bind_allocator(get_allocator(), asio::bind_executor(grpc_context,
+                                                                             [&, t = ThrowingMove{}](test::ErrorCode ec,
+                                                                                                     bool)
+                                                                             {
+                                                                                 ok = !ec;
+                                                                             })));
+    }
+    test::post(grpc_context,
+               [&]
+               {
+                   safe.token()(true);
+               });
+    grpc_context.run();
+    CHECK(ok);
+    CHECK(allocator_has_been_used());
+}
+
 TEST_CASE_TEMPLATE("CancelSafe: wait for already completed operation", T, bool, test::ErrorCode)
 {
     agrpc::GrpcContext grpc_context;
@@ -225,4 +303,192 @@ TEST_CASE_FIXTURE(test::IoContextTest, "CancelSafe: can handle lots of completio
         });
     io_context.run();
 }
+
+TEST_CASE_FIXTURE(test::IoContextTest, "CancelSafe: buffers multiple results and delivers them in completion order")
+{
+    agrpc::CancelSafe<void(int), 3> safe;
+    CHECK_EQ(3, safe.capacity());
+    safe.token()(1);
+    safe.token()(2);
+    safe.token()(3);
+    CHECK_EQ(3, safe.completed_count());
+    std::vector<int> results;
+    const auto wait = [&](auto& self) -> void
+    {
+        safe.wait(asio::bind_executor(io_context,
+                                      [&](test::ErrorCode ec, int value)
+                                      {
+                                          CHECK_FALSE(ec);
+                                          results.push_back(value);
+                                          if (results.size() == 3)
+                                          {
+                                              safe.token()(4);
+                                          }
+                                          if (results.size() < 4)
+                                          {
+                                              self(self);
+                                          }
+                                      }));
+    };
+    wait(wait);
+    io_context.run();
+    CHECK_EQ(std::vector{1, 2, 3, 4}, results);
+    CHECK_EQ(0, safe.completed_count());
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "GrpcStream: multiple initiated operations complete in completion order")
+{
+    agrpc::BasicGrpcStream<agrpc::GrpcExecutor, 2> stream{grpc_context};
+    grpc::Alarm long_alarm;
+    grpc::Alarm short_alarm;
+    stream.initiate(agrpc::wait, long_alarm, test::five_seconds_from_now());
+    stream.initiate(agrpc::wait, short_alarm, test::ten_milliseconds_from_now());
+    CHECK_EQ(2, stream.running_count());
+    stream.next(asio::bind_executor(grpc_context,
+                                    [&](auto&& ec, bool ok)
+                                    {
+                                        CHECK_FALSE(ec);
+                                        CHECK(ok);
+                                        CHECK_EQ(1, stream.running_count());
+                                        long_alarm.Cancel();
+                                        stream.cleanup(asio::bind_executor(grpc_context,
+                                                                           [&](auto&& ec, bool ok)
+                                                                           {
+                                                                               CHECK_FALSE(ec);
+                                                                               CHECK_FALSE(ok);
+                                                                               CHECK_FALSE(stream.is_running());
+                                                                           }));
+                                    }));
+    grpc_context.run();
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "GrpcStream: has_capacity is false while all capacity is in use")
+{
+    agrpc::BasicGrpcStream<agrpc::GrpcExecutor, 2> stream{grpc_context};
+    grpc::Alarm first_alarm;
+    grpc::Alarm second_alarm;
+    stream.initiate(agrpc::wait, first_alarm, test::ten_milliseconds_from_now());
+    CHECK(stream.has_capacity());
+    stream.initiate(agrpc::wait, second_alarm, test::ten_milliseconds_from_now());
+    CHECK_FALSE(stream.has_capacity());
+    CHECK_EQ(2, stream.running_count());
+    bool is_cleaned_up{};
+    stream.cleanup(asio::bind_executor(grpc_context,
+                                       [&](auto&& ec, bool ok)
+                                       {
+                                           CHECK_FALSE(ec);
+                                           CHECK(ok);
+                                           is_cleaned_up = true;
+                                       }));
+    grpc_context.run();
+    CHECK(is_cleaned_up);
+    CHECK(stream.has_capacity());
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "GrpcStream: results that have not been obtained occupy capacity")
+{
+    agrpc::BasicGrpcStream<agrpc::GrpcExecutor, 2> stream{grpc_context};
+    grpc::Alarm first_alarm;
+    grpc::Alarm second_alarm;
+    grpc::Alarm third_alarm;
+    stream.initiate(agrpc::wait, first_alarm, test::ten_milliseconds_from_now());
+    stream.initiate(agrpc::wait, second_alarm, test::ten_milliseconds_from_now());
+    grpc_context.run();
+    CHECK_EQ(0, stream.running_count());
+    CHECK_FALSE(stream.has_capacity());
+    stream.next(asio::bind_executor(grpc_context,
+                                    [&](auto&& ec, bool ok)
+                                    {
+                                        CHECK_FALSE(ec);
+                                        CHECK(ok);
+                                        CHECK(stream.has_capacity());
+                                        stream.initiate(agrpc::wait, third_alarm, test::ten_milliseconds_from_now());
+                                        stream.cleanup([](auto&&, bool) {});
+                                    }));
+    grpc_context.run();
+    CHECK_FALSE(stream.is_running());
+    CHECK(stream.has_capacity());
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "GrpcStream: cleanup waits for all initiated operations")
+{
+    agrpc::BasicGrpcStream<agrpc::GrpcExecutor, 3> stream{grpc_context};
+    grpc::Alarm short_alarm;
+    grpc::Alarm medium_alarm;
+    grpc::Alarm long_alarm;
+    stream.initiate(agrpc::wait, short_alarm, test::ten_milliseconds_from_now());
+    stream.initiate(agrpc::wait, medium_alarm, test::hundred_milliseconds_from_now());
+    stream.initiate(agrpc::wait, long_alarm, test::five_seconds_from_now());
+    grpc::Alarm cancel_alarm;
+    agrpc::wait(cancel_alarm, test::hundred_milliseconds_from_now(),
+                asio::bind_executor(grpc_context,
+                                    [&](bool)
+                                    {
+                                        long_alarm.Cancel();
+                                    }));
+    bool is_cleaned_up{};
+    stream.cleanup(asio::bind_executor(grpc_context,
+                                       [&](auto&& ec, bool ok)
+                                       {
+                                           CHECK_FALSE(ec);
+                                           CHECK_FALSE(ok);
+                                           CHECK_FALSE(stream.is_running());
+                                           is_cleaned_up = true;
+                                       }));
+    grpc_context.run();
+    CHECK(is_cleaned_up);
+    CHECK(stream.has_capacity());
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "GrpcStream: cancel next while several results are pending")
+{
+    agrpc::BasicGrpcStream<agrpc::GrpcExecutor, 3> stream{grpc_context};
+    grpc::Alarm first_alarm;
+    grpc::Alarm second_alarm;
+    grpc::Alarm long_alarm;
+    stream.initiate(agrpc::wait, first_alarm, test::ten_milliseconds_from_now());
+    stream.initiate(agrpc::wait, second_alarm, test::ten_milliseconds_from_now());
+    stream.initiate(agrpc::wait, long_alarm, test::five_seconds_from_now());
+    asio::cancellation_signal signal;
+    bool is_aborted{};
+    stream.next(asio::bind_cancellation_slot(signal.slot(),
+                                             asio::bind_executor(grpc_context,
+                                                                 [&](auto&& ec, bool)
+                                                                 {
+                                                                     is_aborted = asio::error::operation_aborted == ec;
+                                                                 })));
+    signal.emit(asio::cancellation_type::terminal);
+    std::vector<bool> results;
+    grpc::Alarm alarm;
+    agrpc::wait(alarm, test::hundred_milliseconds_from_now(),
+                asio::bind_executor(grpc_context,
+                                    [&](bool)
+                                    {
+                                        // Both short alarms have completed while no next() was outstanding.
+                                        CHECK_EQ(1, stream.running_count());
+                                        CHECK_FALSE(stream.has_capacity());
+                                        const auto next = [&](auto& self) -> void
+                                        {
+                                            stream.next(asio::bind_executor(grpc_context,
+                                                                            [&, self](auto&& ec, bool ok)
+                                                                            {
+                                                                                CHECK_FALSE(ec);
+                                                                                results.push_back(ok);
+                                                                                if (results.size() < 2)
+                                                                                {
+                                                                                    self(self);
+                                                                                    return;
+                                                                                }
+                                                                                long_alarm.Cancel();
+                                                                                stream.cleanup([](auto&&, bool) {});
+                                                                            }));
+                                        };
+                                        next(next);
+                                    }));
+    grpc_context.run();
+    CHECK(is_aborted);
+    CHECK_EQ(std::vector<bool>{true, true}, results);
+    CHECK_FALSE(stream.is_running());
+    CHECK(stream.has_capacity());
+}
 #endif
@@ -17,11 +17,28 @@
 #include "utils/time.hpp"
 
 #include <agrpc/cancel_safe.hpp>
+#include <agrpc/detail/cancel_safe.hpp>
+#include <agrpc/detail/coroutine_traits.hpp>
 #include <agrpc/grpc_stream.hpp>
 #include <agrpc/wait.hpp>
 #include <doctest/doctest.h>
 
 #include <cstddef>
+#include <type_traits>
+
+#ifdef AGRPC_ASIO_HAS_CO_AWAIT
+namespace
+{
+using AwaitableHandler =
+    agrpc::detail::CompletionHandlerTypeT<asio::use_awaitable_t<asio::any_io_executor>, void(test::ErrorCode, bool)>;
+
+static_assert(!std::is_same_v<agrpc::detail::CompletionHandlerUnknown, AwaitableHandler>);
+static_assert(
+    agrpc::detail::CompletionHandlerBuffer<agrpc::detail::CANCEL_SAFE_DEFAULT_HANDLER_BUFFER_SIZE>::FITS<
+        agrpc::detail::WorkTrackingCompletionHandler<AwaitableHandler>>,
+    "The default handler buffer of CancelSafe must fit the completion handler of asio::use_awaitable");
+}
+#endif
 
 #if defined(AGRPC_ASIO_HAS_CANCELLATION_SLOT) && defined(AGRPC_ASIO_HAS_CO_AWAIT)
 #ifdef AGRPC_TEST_ASIO_HAS_FIXED_DEFERRED
@@ -0,0 +1,50 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "test/msg/message.pb.h"
+#include "utils/doctest.hpp"
+
+#include <agrpc/message_pool.hpp>
+#include <grpcpp/support/byte_buffer.h>
+
+TEST_CASE("MessagePool: returned messages are cleared and reused")
+{
+    agrpc::MessagePool<test::msg::Request> pool{1};
+    CHECK_EQ(1, pool.max_size());
+    const test::msg::Request* address;
+    {
+        auto message = pool.acquire();
+        message->set_integer(42);
+        address = message.get();
+        CHECK_EQ(1, pool.outstanding());
+    }
+    CHECK_EQ(0, pool.outstanding());
+    CHECK_EQ(1, pool.size());
+    auto message = pool.acquire();
+    CHECK_EQ(address, message.get());
+    CHECK_EQ(0, message->integer());
+    CHECK_EQ(0, pool.size());
+}
+
+TEST_CASE("MessagePool: messages returned to a full pool are deleted")
+{
+    agrpc::MessagePool<grpc::ByteBuffer> pool{1};
+    {
+        auto first = pool.acquire();
+        auto second = pool.acquire();
+        CHECK_EQ(2, pool.outstanding());
+    }
+    CHECK_EQ(0, pool.outstanding());
+    CHECK_EQ(1, pool.size());
+}
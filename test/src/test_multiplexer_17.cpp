@@ -0,0 +1,369 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "test/v1/test.grpc.pb.h"
+#include "utils/asio_utils.hpp"
+#include "utils/doctest.hpp"
+#include "utils/grpc_client_server_test.hpp"
+
+#include <agrpc/multiplexer.hpp>
+#include <agrpc/rpc.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <utility>
+#include <vector>
+
+// The correlation id is stored in the upper digits of `integer`.
+struct IntegerCorrelationTraits
+{
+    template <class Message>
+    static std::uint64_t get_id(const Message& message)
+    {
+        return static_cast<std::uint64_t>(message.integer() / 1000);
+    }
+
+    template <class Message>
+    static void set_id(Message& message, std::uint64_t id)
+    {
+        message.set_integer(static_cast<std::int32_t>(id) * 1000 + message.integer() % 1000);
+    }
+};
+
+using ClientMultiplexer =
+    agrpc::ClientMultiplexer<&test::v1::Test::Stub::PrepareAsyncBidirectionalStreaming, IntegerCorrelationTraits>;
+using ServerDemultiplexer =
+    agrpc::ServerDemultiplexer<test::msg::Request, test::msg::Response, IntegerCorrelationTraits>;
+
+struct MultiplexerTest : test::GrpcClientServerTest
+{
+    grpc::ServerAsyncReaderWriter<test::msg::Response, test::msg::Request> server_reader_writer{&server_context};
+
+    template <class RequestHandler>
+    void spawn_server(RequestHandler request_handler)
+    {
+        test::spawn(grpc_context,
+                    [&, request_handler](const asio::yield_context& yield)
+                    {
+                        CHECK(agrpc::request(&test::v1::Test::AsyncService::RequestBidirectionalStreaming, service,
+                                             server_context, server_reader_writer, yield));
+                        ServerDemultiplexer demultiplexer{grpc_context, server_reader_writer};
+                        demultiplexer.run(request_handler, yield);
+                        agrpc::finish(server_reader_writer, grpc::Status::OK, yield);
+                    });
+    }
+
+    // Accepts one stream with its own ServerContext. The request handler is invoked with the index of the stream.
+    template <class RequestHandler>
+    void serve(std::size_t index, RequestHandler& request_handler, const asio::yield_context& yield)
+    {
+        grpc::ServerContext context;
+        grpc::ServerAsyncReaderWriter<test::msg::Response, test::msg::Request> reader_writer{&context};
+        if (!agrpc::request(&test::v1::Test::AsyncService::RequestBidirectionalStreaming, service, context,
+                            reader_writer, yield))
+        {
+            return;
+        }
+        ServerDemultiplexer demultiplexer{grpc_context, reader_writer};
+        demultiplexer.run(
+            [&](test::msg::Request&& request, ServerDemultiplexer::Responder&& responder)
+            {
+                request_handler(index, context, request, std::move(responder));
+            },
+            yield);
+        agrpc::finish(reader_writer, grpc::Status::OK, yield);
+    }
+
+    template <class RequestHandler>
+    void spawn_concurrent_servers(std::size_t count, RequestHandler request_handler)
+    {
+        for (std::size_t i{}; i < count; ++i)
+        {
+            test::spawn(grpc_context,
+                        [&, i, request_handler](const asio::yield_context& yield) mutable
+                        {
+                            serve(i, request_handler, yield);
+                        });
+        }
+    }
+
+    template <class RequestHandler>
+    void spawn_sequential_servers(std::size_t count, RequestHandler request_handler)
+    {
+        test::spawn(grpc_context,
+                    [&, count, request_handler](const asio::yield_context& yield) mutable
+                    {
+                        for (std::size_t i{}; i < count; ++i)
+                        {
+                            serve(i, request_handler, yield);
+                        }
+                    });
+    }
+};
+
+void respond_doubled(const test::msg::Request& request, ServerDemultiplexer::Responder& responder)
+{
+    test::msg::Response response;
+    response.set_integer(request.integer() % 1000 * 2);
+    responder.send(response);
+}
+
+TEST_CASE_FIXTURE(MultiplexerTest, "Multiplexer: responses are matched to requests regardless of their order")
+{
+    std::vector<ServerDemultiplexer::Responder> responders;
+    std::vector<std::int32_t> payloads;
+    spawn_server(
+        [&](test::msg::Request&& request, ServerDemultiplexer::Responder&& responder)
+        {
+            payloads.push_back(request.integer() % 1000);
+            responders.push_back(std::move(responder));
+            if (responders.size() == 3)
+            {
+                for (auto i = responders.size(); i > 0; --i)
+                {
+                    test::msg::Response response;
+                    response.set_integer(payloads[i - 1] * 2);
+                    responders[i - 1].send(response);
+                }
+                responders.clear();
+            }
+        });
+    ClientMultiplexer multiplexer{grpc_context, *stub, 1, std::chrono::seconds(5)};
+    test::msg::Response responses[3];
+    int completed{};
+    for (std::int32_t i = 0; i < 3; ++i)
+    {
+        test::msg::Request request;
+        request.set_integer(i + 1);
+        multiplexer.request(request, responses[i],
+                            [&](grpc::Status status)
+                            {
+                                CHECK(status.ok());
+                                if (++completed == 3)
+                                {
+                                    CHECK_EQ(0, multiplexer.pending_count());
+                                    multiplexer.shutdown([] {});
+                                }
+                            });
+    }
+    CHECK_EQ(3, multiplexer.pending_count());
+    grpc_context.run();
+    CHECK_EQ(3, completed);
+    for (std::int32_t i = 0; i < 3; ++i)
+    {
+        CHECK_EQ((i + 1) * 2, responses[i].integer() % 1000);
+    }
+}
+
+TEST_CASE_FIXTURE(MultiplexerTest, "Multiplexer: unanswered request completes with DEADLINE_EXCEEDED")
+{
+    spawn_server([&](test::msg::Request&&, ServerDemultiplexer::Responder&&) {});
+    ClientMultiplexer multiplexer{grpc_context, *stub, 2, std::chrono::milliseconds(100)};
+    test::msg::Response response;
+    grpc::StatusCode status_code{};
+    bool is_shutdown{};
+    multiplexer.request(test::msg::Request{}, response,
+                        [&](grpc::Status status)
+                        {
+                            status_code = status.error_code();
+                            multiplexer.shutdown(
+                                [&]
+                                {
+                                    is_shutdown = true;
+                                });
+                        });
+    grpc_context.run();
+    CHECK_EQ(grpc::StatusCode::DEADLINE_EXCEEDED, status_code);
+    CHECK(is_shutdown);
+}
+
+TEST_CASE_FIXTURE(MultiplexerTest, "Multiplexer: the timeout alarm does not keep the GrpcContext running")
+{
+    spawn_server(
+        [&](test::msg::Request&& request, ServerDemultiplexer::Responder&& responder)
+        {
+            respond_doubled(request, responder);
+        });
+    ClientMultiplexer multiplexer{grpc_context, *stub, 1, std::chrono::seconds(10)};
+    test::msg::Request request;
+    request.set_integer(21);
+    test::msg::Response response;
+    bool ok{};
+    multiplexer.request(request, response,
+                        [&](grpc::Status status)
+                        {
+                            ok = status.ok();
+                            // Let the stream fail so that neither the stream nor the multiplexer has work left.
+                            server_context.TryCancel();
+                        });
+    const auto start = std::chrono::steady_clock::now();
+    grpc_context.run();
+    CHECK(ok);
+    CHECK_EQ(42, response.integer() % 1000);
+    CHECK_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+    CHECK_EQ(0, multiplexer.pending_count());
+    multiplexer.shutdown([] {});
+    grpc_context.run();
+}
+
+TEST_CASE_FIXTURE(MultiplexerTest, "Multiplexer: requests are spread over all streams")
+{
+    std::map<std::int32_t, std::size_t> stream_of_payload;
+    std::vector<std::pair<test::msg::Request, ServerDemultiplexer::Responder>> held;
+    spawn_concurrent_servers(2,
+                             [&](std::size_t index, grpc::ServerContext&, test::msg::Request& request,
+                                 ServerDemultiplexer::Responder&& responder)
+                             {
+                                 stream_of_payload[request.integer() % 1000] = index;
+                                 held.emplace_back(request, std::move(responder));
+                                 if (held.size() == 4)
+                                 {
+                                     for (auto& [held_request, held_responder] : held)
+                                     {
+                                         respond_doubled(held_request, held_responder);
+                                     }
+                                 }
+                             });
+    ClientMultiplexer multiplexer{grpc_context, *stub, 2, std::chrono::seconds(5)};
+    CHECK_EQ(2, multiplexer.stream_count());
+    test::msg::Response responses[4];
+    int completed{};
+    for (std::int32_t i = 0; i < 4; ++i)
+    {
+        test::msg::Request request;
+        request.set_integer(i + 1);
+        multiplexer.request(request, responses[i],
+                            [&](grpc::Status status)
+                            {
+                                CHECK(status.ok());
+                                if (++completed == 4)
+                                {
+                                    held.clear();
+                                    multiplexer.shutdown([] {});
+                                }
+                            });
+    }
+    grpc_context.run();
+    CHECK_EQ(4, completed);
+    REQUIRE_EQ(4, stream_of_payload.size());
+    CHECK_NE(stream_of_payload[1], stream_of_payload[2]);
+    CHECK_EQ(stream_of_payload[1], stream_of_payload[3]);
+    CHECK_EQ(stream_of_payload[2], stream_of_payload[4]);
+    for (std::int32_t i = 0; i < 4; ++i)
+    {
+        CHECK_EQ((i + 1) * 2, responses[i].integer() % 1000);
+    }
+}
+
+TEST_CASE_FIXTURE(MultiplexerTest, "Multiplexer: requests are assigned to the stream with the fewest outstanding requests")
+{
+    std::map<std::int32_t, std::size_t> stream_of_payload;
+    std::optional<std::pair<test::msg::Request, ServerDemultiplexer::Responder>> held;
+    spawn_concurrent_servers(2,
+                             [&](std::size_t index, grpc::ServerContext&, test::msg::Request& request,
+                                 ServerDemultiplexer::Responder&& responder)
+                             {
+                                 const auto payload = request.integer() % 1000;
+                                 stream_of_payload[payload] = index;
+                                 if (payload == 2)
+                                 {
+                                     held.emplace(request, std::move(responder));
+                                     return;
+                                 }
+                                 respond_doubled(request, responder);
+                                 if (payload == 3)
+                                 {
+                                     respond_doubled(held->first, held->second);
+                                 }
+                             });
+    ClientMultiplexer multiplexer{grpc_context, *stub, 2, std::chrono::seconds(5)};
+    test::msg::Response responses[3];
+    int completed{};
+    const auto on_complete = [&](grpc::Status status)
+    {
+        CHECK(status.ok());
+        if (++completed == 3)
+        {
+            held.reset();
+            multiplexer.shutdown([] {});
+        }
+    };
+    test::msg::Request request;
+    request.set_integer(1);
+    multiplexer.request(request, responses[0],
+                        [&](grpc::Status status)
+                        {
+                            // The stream of the first request has no outstanding requests anymore.
+                            test::msg::Request request;
+                            request.set_integer(3);
+                            multiplexer.request(request, responses[2], on_complete);
+                            on_complete(status);
+                        });
+    request.set_integer(2);
+    multiplexer.request(request, responses[1], on_complete);
+    grpc_context.run();
+    CHECK_EQ(3, completed);
+    REQUIRE_EQ(3, stream_of_payload.size());
+    CHECK_NE(stream_of_payload[1], stream_of_payload[2]);
+    CHECK_EQ(stream_of_payload[1], stream_of_payload[3]);
+    CHECK_EQ(6, responses[2].integer() % 1000);
+}
+
+TEST_CASE_FIXTURE(MultiplexerTest, "Multiplexer: a failed stream completes its requests and is restarted")
+{
+    spawn_sequential_servers(2,
+                             [&](std::size_t index, grpc::ServerContext& context, test::msg::Request& request,
+                                 ServerDemultiplexer::Responder&& responder)
+                             {
+                                 if (index == 0)
+                                 {
+                                     context.TryCancel();
+                                     return;
+                                 }
+                                 respond_doubled(request, responder);
+                             });
+    ClientMultiplexer multiplexer{grpc_context, *stub, 1, std::chrono::seconds(5)};
+    test::msg::Response responses[4];
+    int failed{};
+    bool restarted_ok{};
+    for (std::int32_t i = 0; i < 3; ++i)
+    {
+        test::msg::Request request;
+        request.set_integer(i + 1);
+        multiplexer.request(request, responses[i],
+                            [&](grpc::Status status)
+                            {
+                                CHECK_FALSE(status.ok());
+                                if (++failed != 3)
+                                {
+                                    return;
+                                }
+                                test::msg::Request request;
+                                request.set_integer(4);
+                                multiplexer.request(request, responses[3],
+                                                    [&](grpc::Status status)
+                                                    {
+                                                        restarted_ok = status.ok();
+                                                        multiplexer.shutdown([] {});
+                                                    });
+                            });
+    }
+    grpc_context.run();
+    CHECK_EQ(3, failed);
+    CHECK(restarted_ok);
+    CHECK_EQ(8, responses[3].integer() % 1000);
+}
@@ -0,0 +1,268 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "utils/asio_utils.hpp"
+#include "utils/doctest.hpp"
+#include "utils/grpc_context_test.hpp"
+
+#include <agrpc/bind_allocator.hpp>
+#include <agrpc/offload.hpp>
+
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "offload: runs function on executor and completes on GrpcContext")
+{
+    asio::thread_pool thread_pool{1};
+    const auto grpc_context_thread = std::this_thread::get_id();
+    std::thread::id function_thread;
+    int result{};
+    agrpc::offload(
+        grpc_context, thread_pool.get_executor(),
+        [&]
+        {
+            function_thread = std::this_thread::get_id();
+            return 42;
+        },
+        [&](std::exception_ptr ep, int value)
+        {
+            CHECK_FALSE(ep);
+            CHECK_EQ(grpc_context_thread, std::this_thread::get_id());
+            result = value;
+        });
+    grpc_context.run();
+    thread_pool.join();
+    CHECK_NE(grpc_context_thread, function_thread);
+    CHECK_EQ(42, result);
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "offload: function returning void and move-only result")
+{
+    asio::thread_pool thread_pool{1};
+    bool invoked{};
+    int result{};
+    agrpc::offload(grpc_context, thread_pool.get_executor(), [] {},
+                   [&](std::exception_ptr ep)
+                   {
+                       CHECK_FALSE(ep);
+                       invoked = true;
+                       agrpc::offload(
+                           grpc_context, thread_pool.get_executor(),
+                           [ptr = std::make_unique<int>(3)]() mutable
+                           {
+                               return std::move(ptr);
+                           },
+                           [&](std::exception_ptr, std::unique_ptr<int> ptr)
+                           {
+                               result = *ptr;
+                           });
+                   });
+    grpc_context.run();
+    thread_pool.join();
+    CHECK(invoked);
+    CHECK_EQ(3, result);
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "offload: exception thrown by function is delivered to the completion handler")
+{
+    asio::thread_pool thread_pool{1};
+    std::exception_ptr exception;
+    int result{-1};
+    agrpc::offload(
+        grpc_context, thread_pool.get_executor(),
+        []() -> int
+        {
+            throw std::runtime_error{"offload"};
+        },
+        [&](std::exception_ptr ep, int value)
+        {
+            exception = std::move(ep);
+            result = value;
+        });
+    grpc_context.run();
+    thread_pool.join();
+    REQUIRE(exception);
+    CHECK_THROWS_WITH_AS(std::rethrow_exception(exception), "offload", std::runtime_error);
+    CHECK_EQ(0, result);
+}
+
+namespace
+{
+struct Allocation
+{
+    const std::byte* begin{};
+    const std::byte* end{};
+
+    [[nodiscard]] bool contains(const Allocation& other) const noexcept
+    {
+        return begin <= other.begin && other.end <= end;
+    }
+};
+
+// Records the memory of the offload operation
+template <class T = std::byte>
+struct RecordingAllocator
+{
+    using value_type = T;
+
+    explicit RecordingAllocator(Allocation& allocation) noexcept : allocation_(&allocation) {}
+
+    template <class U>
+    RecordingAllocator(const RecordingAllocator<U>& other) noexcept : allocation_(other.allocation_)
+    {
+    }
+
+    T* allocate(std::size_t n)
+    {
+        auto* ptr = std::allocator<T>{}.allocate(n);
+        const auto* bytes = reinterpret_cast<const std::byte*>(ptr);
+        *allocation_ = {bytes, bytes + n * sizeof(T)};
+        return ptr;
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept { std::allocator<T>{}.deallocate(p, n); }
+
+    template <class U>
+    friend bool operator==(const RecordingAllocator& lhs, const RecordingAllocator<U>& rhs) noexcept
+    {
+        return lhs.allocation_ == rhs.allocation_;
+    }
+
+    template <class U>
+    friend bool operator!=(const RecordingAllocator& lhs, const RecordingAllocator<U>& rhs) noexcept
+    {
+        return lhs.allocation_ != rhs.allocation_;
+    }
+
+    Allocation* allocation_;
+};
+
+// Posts functions to a thread_pool after allocating them with the allocator that was required of it, like Asio's
+// executors do, and records that allocation.
+template <class Allocator = std::allocator<void>>
+struct AllocationRecordingExecutor
+{
+    asio::thread_pool* thread_pool_;
+    Allocation* allocation_;
+    Allocator allocator_{};
+
+    [[nodiscard]] asio::execution_context& query(asio::execution::context_t) const noexcept { return *thread_pool_; }
+
+    static constexpr auto query(asio::execution::blocking_t) noexcept { return asio::execution::blocking.never; }
+
+    [[nodiscard]] AllocationRecordingExecutor require(asio::execution::blocking_t::never_t) const noexcept
+    {
+        return *this;
+    }
+
+    template <class OtherAllocator>
+    [[nodiscard]] AllocationRecordingExecutor<OtherAllocator> require(
+        asio::execution::allocator_t<OtherAllocator> allocator) const noexcept
+    {
+        return {thread_pool_, allocation_, allocator.value()};
+    }
+
+    template <class Function>
+    void execute(Function function) const
+    {
+        using Alloc = typename std::allocator_traits<Allocator>::template rebind_alloc<Function>;
+        Alloc alloc{allocator_};
+        auto* ptr = std::allocator_traits<Alloc>::allocate(alloc, 1);
+        const auto* bytes = reinterpret_cast<const std::byte*>(ptr);
+        *allocation_ = {bytes, bytes + sizeof(Function)};
+        ::new (static_cast<void*>(ptr)) Function(std::move(function));
+        asio::post(*thread_pool_,
+                   [alloc, ptr]() mutable
+                   {
+                       Function local{std::move(*ptr)};
+                       ptr->~Function();
+                       std::allocator_traits<Alloc>::deallocate(alloc, ptr, 1);
+                       local();
+                   });
+    }
+
+    friend bool operator==(const AllocationRecordingExecutor& lhs, const AllocationRecordingExecutor& rhs) noexcept
+    {
+        return lhs.thread_pool_ == rhs.thread_pool_;
+    }
+
+    friend bool operator!=(const AllocationRecordingExecutor& lhs, const AllocationRecordingExecutor& rhs) noexcept
+    {
+        return lhs.thread_pool_ != rhs.thread_pool_;
+    }
+};
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "offload: function object submitted to the executor is part of the operation")
+{
+    asio::thread_pool thread_pool{1};
+    Allocation operation;
+    Allocation function;
+    bool invoked{};
+    agrpc::offload(grpc_context, AllocationRecordingExecutor<>{&thread_pool, &function}, [] {},
+                   agrpc::bind_allocator(RecordingAllocator<>{operation},
+                                         [&](std::exception_ptr)
+                                         {
+                                             invoked = true;
+                                         }));
+    grpc_context.run();
+    thread_pool.join();
+    CHECK(invoked);
+    REQUIRE(function.begin);
+    CHECK(operation.contains(function));
+}
+
+#ifdef AGRPC_ASIO_HAS_CANCELLATION_SLOT
+TEST_CASE_FIXTURE(test::GrpcContextTest, "offload: cancellation prevents function from being invoked")
+{
+    asio::thread_pool thread_pool{1};
+    std::promise<void> unblock;
+    asio::post(thread_pool,
+               [future = unblock.get_future()]() mutable
+               {
+                   future.wait();
+               });
+    asio::cancellation_signal signal;
+    bool function_invoked{};
+    std::exception_ptr exception;
+    agrpc::offload(grpc_context, thread_pool.get_executor(),
+                   [&]
+                   {
+                       function_invoked = true;
+                   },
+                   asio::bind_cancellation_slot(signal.slot(),
+                                                [&](std::exception_ptr ep)
+                                                {
+                                                    exception = std::move(ep);
+                                                }));
+    signal.emit(asio::cancellation_type::terminal);
+    unblock.set_value();
+    grpc_context.run();
+    thread_pool.join();
+    CHECK_FALSE(function_invoked);
+    REQUIRE(exception);
+    try
+    {
+        std::rethrow_exception(exception);
+    }
+    catch (const agrpc::detail::OffloadSystemError& error)
+    {
+        CHECK_EQ(test::ErrorCode{asio::error::operation_aborted}, error.code());
+    }
+}
+#endif
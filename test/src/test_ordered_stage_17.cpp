@@ -0,0 +1,245 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "utils/asio_utils.hpp"
+#include "utils/doctest.hpp"
+#include "utils/grpc_context_test.hpp"
+
+#include <agrpc/ordered_stage.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "OrderedStage: results are obtained in submission order")
+{
+    asio::thread_pool thread_pool{4};
+    auto stage = agrpc::make_ordered_stage<int>(grpc_context, thread_pool.get_executor(), 3);
+    CHECK_EQ(3, stage.max_in_flight());
+    std::vector<int> results;
+    std::function<void(std::exception_ptr, bool, int)> on_next = [&](std::exception_ptr ep, bool ok, int result)
+    {
+        CHECK_FALSE(ep);
+        if (ok)
+        {
+            results.push_back(result);
+            stage.next(on_next);
+        }
+    };
+    test::spawn_and_run(grpc_context,
+                        [&](const asio::yield_context& yield)
+                        {
+                            stage.next(on_next);
+                            for (int i{}; i < 50; ++i)
+                            {
+                                stage.submit(
+                                    [i]
+                                    {
+                                        // Let earlier functions complete last.
+                                        std::this_thread::sleep_for(std::chrono::microseconds((50 - i) % 4 * 100));
+                                        return i;
+                                    },
+                                    yield);
+                                CHECK_LE(stage.size(), 3);
+                            }
+                            stage.close();
+                            CHECK(stage.is_closed());
+                        });
+    thread_pool.join();
+    REQUIRE_EQ(50, results.size());
+    for (int i{}; i < 50; ++i)
+    {
+        CHECK_EQ(i, results[i]);
+    }
+    CHECK_EQ(0, stage.size());
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "OrderedStage: submit waits until the oldest result has been obtained")
+{
+    asio::thread_pool thread_pool{1};
+    auto stage = agrpc::make_ordered_stage<std::unique_ptr<int>>(grpc_context, thread_pool.get_executor(), 1);
+    bool second_submitted{};
+    stage.submit(
+        []
+        {
+            return std::make_unique<int>(1);
+        },
+        [&](bool ok)
+        {
+            CHECK(ok);
+            stage.submit(
+                []
+                {
+                    return std::make_unique<int>(2);
+                },
+                [&](bool ok)
+                {
+                    CHECK(ok);
+                    second_submitted = true;
+                });
+            stage.next(
+                [&](std::exception_ptr, bool ok, std::unique_ptr<int> result)
+                {
+                    CHECK(ok);
+                    CHECK_EQ(1, *result);
+                    CHECK_FALSE(second_submitted);
+                    stage.next(
+                        [&](std::exception_ptr, bool ok, std::unique_ptr<int> result)
+                        {
+                            CHECK(ok);
+                            CHECK(second_submitted);
+                            CHECK_EQ(2, *result);
+                            stage.close();
+                        });
+                });
+        });
+    grpc_context.run();
+    thread_pool.join();
+    CHECK(second_submitted);
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "OrderedStage: close completes a waiting submit with false")
+{
+    asio::thread_pool thread_pool{1};
+    auto stage = agrpc::make_ordered_stage<int>(grpc_context, thread_pool.get_executor(), 1);
+    bool second_ok{true};
+    bool second_ran{};
+    stage.submit(
+        []
+        {
+            return 1;
+        },
+        [&](bool ok)
+        {
+            CHECK(ok);
+            stage.submit(
+                [&]
+                {
+                    second_ran = true;
+                    return 2;
+                },
+                [&](bool ok)
+                {
+                    second_ok = ok;
+                    stage.next(
+                        [&](std::exception_ptr, bool ok, int result)
+                        {
+                            CHECK(ok);
+                            CHECK_EQ(1, result);
+                        });
+                });
+            asio::post(grpc_context,
+                       [&]
+                       {
+                           stage.close();
+                       });
+        });
+    grpc_context.run();
+    thread_pool.join();
+    CHECK_FALSE(second_ok);
+    CHECK_FALSE(second_ran);
+    CHECK_EQ(0, stage.size());
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "OrderedStage: exception thrown by a function is delivered in order")
+{
+    asio::thread_pool thread_pool{2};
+    auto stage = agrpc::make_ordered_stage<int>(grpc_context, thread_pool.get_executor(), 3);
+    std::vector<int> results;
+    std::vector<bool> exceptions;
+    std::function<void(std::exception_ptr, bool, int)> on_next = [&](std::exception_ptr ep, bool ok, int result)
+    {
+        if (ok)
+        {
+            results.push_back(result);
+            exceptions.push_back(bool{ep});
+            if (ep)
+            {
+                CHECK_THROWS_AS(std::rethrow_exception(ep), std::runtime_error);
+            }
+            stage.next(on_next);
+        }
+    };
+    stage.next(on_next);
+    for (int i{}; i < 3; ++i)
+    {
+        stage.submit(
+            [i]
+            {
+                if (i == 1)
+                {
+                    throw std::runtime_error{"test"};
+                }
+                return i;
+            },
+            test::NoOp{});
+    }
+    asio::post(grpc_context,
+               [&]
+               {
+                   stage.close();
+               });
+    grpc_context.run();
+    thread_pool.join();
+    CHECK_EQ(std::vector<int>{0, 0, 2}, results);
+    CHECK_EQ(std::vector<bool>{false, true, false}, exceptions);
+}
+
+TEST_CASE("OrderedStage: parked operations are destroyed when the GrpcContext shuts down")
+{
+    asio::thread_pool thread_pool{1};
+    bool invoked{false};
+    auto handler_state = std::make_shared<int>();
+    std::optional<agrpc::GrpcContext> grpc_context{std::make_unique<grpc::CompletionQueue>()};
+    std::optional<agrpc::BasicOrderedStage<int, asio::thread_pool::executor_type>> stage;
+    stage.emplace(*grpc_context, thread_pool.get_executor(), 1);
+    SUBCASE("submit")
+    {
+        stage->submit(
+            []
+            {
+                return 1;
+            },
+            test::NoOp{});
+        stage->submit(
+            []
+            {
+                return 2;
+            },
+            [&, handler_state](bool)
+            {
+                invoked = true;
+            });
+    }
+    SUBCASE("next")
+    {
+        stage->next(
+            [&, handler_state](std::exception_ptr, bool, int)
+            {
+                invoked = true;
+            });
+    }
+    grpc_context->poll();
+    thread_pool.join();
+    grpc_context.reset();
+    CHECK_FALSE(invoked);
+    CHECK_EQ(1, handler_state.use_count());
+    stage.reset();
+}
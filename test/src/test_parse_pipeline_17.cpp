@@ -0,0 +1,153 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "test/v1/test.grpc.pb.h"
+#include "utils/asio_utils.hpp"
+#include "utils/doctest.hpp"
+#include "utils/grpc_context_test.hpp"
+
+#include <agrpc/parse_pipeline.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <thread>
+
+namespace
+{
+grpc::ByteBuffer serialize(std::int32_t integer)
+{
+    test::msg::Request request;
+    request.set_integer(integer);
+    grpc::ByteBuffer buffer;
+    bool own_buffer;
+    CHECK(grpc::SerializationTraits<test::msg::Request>::Serialize(request, &buffer, &own_buffer).ok());
+    return buffer;
+}
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "ParsePipeline: parses and processes messages on the executor")
+{
+    asio::thread_pool thread_pool{2};
+    const auto grpc_context_thread = std::this_thread::get_id();
+    std::atomic_int sum{};
+    std::atomic_int failed_parses{};
+    std::atomic_bool ran_on_grpc_context_thread{};
+    auto pipeline = agrpc::make_parse_pipeline<test::msg::Request>(
+        grpc_context, thread_pool.get_executor(), 2,
+        [&](const grpc::Status& status, test::msg::Request& request) noexcept
+        {
+            if (grpc_context_thread == std::this_thread::get_id())
+            {
+                ran_on_grpc_context_thread = true;
+            }
+            if (!status.ok())
+            {
+                ++failed_parses;
+                return;
+            }
+            sum += request.integer();
+        });
+    CHECK_EQ(2, pipeline.max_depth());
+    test::spawn_and_run(grpc_context,
+                        [&](const asio::yield_context& yield)
+                        {
+                            int expected{};
+                            for (int i{}; i < 100; ++i)
+                            {
+                                auto buffer = serialize(i);
+                                pipeline.submit(buffer, yield);
+                                CHECK_EQ(0, buffer.Length());
+                                CHECK_LE(pipeline.in_flight(), 2);
+                                expected += i;
+                            }
+                            grpc::Slice slice{"\xff\xff\xff", 3};
+                            grpc::ByteBuffer invalid{&slice, 1};
+                            pipeline.submit(invalid, yield);
+                            pipeline.wait_idle(yield);
+                            CHECK_EQ(grpc_context_thread, std::this_thread::get_id());
+                            CHECK_EQ(0, pipeline.in_flight());
+                            CHECK_EQ(expected, sum);
+                            CHECK_EQ(1, failed_parses);
+                        });
+    thread_pool.join();
+    CHECK_FALSE(ran_on_grpc_context_thread);
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "ParsePipeline: try_submit fails when max depth is reached")
+{
+    asio::thread_pool thread_pool{1};
+    std::atomic_bool release{};
+    auto pipeline = agrpc::make_parse_pipeline<test::msg::Request>(
+        grpc_context, thread_pool.get_executor(), 1,
+        [&](const grpc::Status&, test::msg::Request&) noexcept
+        {
+            while (!release)
+            {
+                std::this_thread::yield();
+            }
+        });
+    auto first = serialize(1);
+    auto second = serialize(2);
+    CHECK(pipeline.try_submit(first));
+    CHECK_FALSE(pipeline.try_submit(second));
+    CHECK_LT(0, second.Length());
+    release = true;
+    bool idle{};
+    pipeline.wait_idle(
+        [&]
+        {
+            idle = true;
+        });
+    grpc_context.run();
+    CHECK(idle);
+    CHECK(pipeline.try_submit(second));
+    pipeline.wait_idle(test::NoOp{});
+    grpc_context.run();
+    thread_pool.join();
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "ParsePipeline: can be destroyed right after wait_idle")
+{
+    struct Function
+    {
+        std::atomic_int* sum;
+
+        void operator()(const grpc::Status&, test::msg::Request& request) const noexcept { *sum += request.integer(); }
+    };
+    asio::thread_pool thread_pool{4};
+    std::atomic_int sum{};
+    int expected{};
+    for (int i{}; i < 1000; ++i)
+    {
+        std::optional<agrpc::BasicParsePipeline<test::msg::Request, asio::thread_pool::executor_type, Function>>
+            pipeline;
+        pipeline.emplace(grpc_context, thread_pool.get_executor(), 4, Function{&sum});
+        for (int j{}; j < 4; ++j)
+        {
+            auto buffer = serialize(j);
+            CHECK(pipeline->try_submit(buffer));
+            expected += j;
+        }
+        pipeline->wait_idle(
+            [&]
+            {
+                pipeline.reset();
+            });
+        grpc_context.run();
+        CHECK_FALSE(pipeline);
+    }
+    thread_pool.join();
+    CHECK_EQ(expected, sum);
+}
@@ -0,0 +1,95 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "test/v1/test.grpc.pb.h"
+#include "utils/asio_utils.hpp"
+#include "utils/doctest.hpp"
+#include "utils/grpc_client_server_test.hpp"
+#include "utils/time.hpp"
+
+#include <agrpc/propagation_context.hpp>
+#include <agrpc/rpc.hpp>
+
+#include <chrono>
+
+TEST_CASE("PropagationContext: infinite deadline is not shortened")
+{
+    grpc::ServerContext server_context;
+    agrpc::PropagationContext context{server_context, std::chrono::seconds(1)};
+    agrpc::PropagatedClientContext child{context};
+    CHECK_EQ(std::chrono::system_clock::time_point::max(), context.deadline());
+    CHECK_EQ(std::chrono::system_clock::time_point::max(), child.client_context().deadline());
+}
+
+TEST_CASE_FIXTURE(test::GrpcClientServerTest, "PropagationContext: propagates deadline and cancellation")
+{
+    bool server_finished{};
+    grpc::Status downstream_status;
+    client_context.set_deadline(test::five_seconds_from_now());
+    test::spawn_and_run(
+        grpc_context,
+        [&](const asio::yield_context& yield)
+        {
+            test::msg::Request request;
+            grpc::ServerAsyncResponseWriter<test::msg::Response> writer{&server_context};
+            CHECK(agrpc::request(&test::v1::Test::AsyncService::RequestUnary, service, server_context, request, writer,
+                                 yield));
+            agrpc::PropagationContext context{server_context, std::chrono::seconds(1)};
+            {
+                agrpc::PropagatedClientContext child{context};
+                CHECK_EQ(server_context.deadline() - std::chrono::seconds(1), child.client_context().deadline());
+                const auto reader = agrpc::request(&test::v1::Test::Stub::AsyncUnary, *stub, child.client_context(),
+                                                   request, grpc_context);
+                test::msg::Response response;
+                test::post(grpc_context,
+                           [&]
+                           {
+                               context.cancel();
+                           });
+                CHECK(agrpc::finish(reader, response, downstream_status, yield));
+            }
+            CHECK(context.is_cancelled());
+            server_finished = agrpc::finish(writer, test::msg::Response{}, grpc::Status::OK, yield);
+        },
+        [&](const asio::yield_context& yield)
+        {
+            test::msg::Request request;
+            const auto reader =
+                agrpc::request(&test::v1::Test::Stub::AsyncUnary, *stub, client_context, request, grpc_context);
+            test::msg::Response response;
+            grpc::Status status;
+            CHECK(agrpc::finish(reader, response, status, yield));
+            CHECK(status.ok());
+        });
+    CHECK(server_finished);
+    CHECK_EQ(grpc::StatusCode::CANCELLED, downstream_status.error_code());
+}
+
+#ifdef AGRPC_ASIO_HAS_CANCELLATION_SLOT
+TEST_CASE("PropagationContext: cancellation slot triggers cancel")
+{
+    grpc::ServerContext server_context;
+    asio::cancellation_signal signal;
+    {
+        agrpc::PropagationContext context{server_context};
+        context.cancel_on(signal.slot());
+        agrpc::PropagatedClientContext child{context};
+        CHECK(signal.slot().has_handler());
+        CHECK_FALSE(context.is_cancelled());
+        signal.emit(asio::cancellation_type::terminal);
+        CHECK(context.is_cancelled());
+    }
+    CHECK_FALSE(signal.slot().has_handler());
+}
+#endif
@@ -0,0 +1,174 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "test/v1/test.grpc.pb.h"
+#include "utils/asio_utils.hpp"
+#include "utils/doctest.hpp"
+#include "utils/grpc_client_server_test.hpp"
+#include "utils/time.hpp"
+
+#include <agrpc/request_all.hpp>
+#include <agrpc/rpc.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+struct RequestAllTest : test::GrpcClientServerTest
+{
+    std::vector<test::msg::Request> requests;
+
+    explicit RequestAllTest(std::size_t count = 3)
+    {
+        for (std::size_t i{}; i < count; ++i)
+        {
+            requests.emplace_back().set_integer(static_cast<std::int32_t>(i));
+        }
+    }
+
+    template <class Handler>
+    void spawn_server(std::size_t count, Handler handler)
+    {
+        test::spawn(grpc_context,
+                    [&, count, handler](const asio::yield_context& yield)
+                    {
+                        for (std::size_t i{}; i < count; ++i)
+                        {
+                            grpc::ServerContext server_context;
+                            grpc::ServerAsyncResponseWriter<test::msg::Response> writer{&server_context};
+                            test::msg::Request request;
+                            CHECK(agrpc::request(&test::v1::Test::AsyncService::RequestUnary, service, server_context,
+                                                 request, writer, yield));
+                            test::msg::Response response;
+                            const auto status = handler(request, response);
+                            if (status.ok())
+                            {
+                                CHECK(agrpc::finish(writer, response, status, yield));
+                            }
+                            else
+                            {
+                                CHECK(agrpc::finish_with_error(writer, status, yield));
+                            }
+                        }
+                    });
+    }
+};
+
+TEST_CASE_FIXTURE(RequestAllTest, "request_all: results are in the order of the requests")
+{
+    spawn_server(requests.size(),
+                 [](const test::msg::Request& request, test::msg::Response& response)
+                 {
+                     response.set_integer(request.integer() * 2);
+                     return grpc::Status::OK;
+                 });
+    std::vector<agrpc::UnaryResult<test::msg::Response>> results;
+    agrpc::request_all(grpc_context, &test::v1::Test::Stub::PrepareAsyncUnary, *stub, requests,
+                       {test::five_seconds_from_now()},
+                       [&](std::vector<agrpc::UnaryResult<test::msg::Response>> local_results)
+                       {
+                           results = std::move(local_results);
+                       });
+    grpc_context.run();
+    REQUIRE_EQ(requests.size(), results.size());
+    for (std::size_t i{}; i < results.size(); ++i)
+    {
+        CHECK(results[i].status.ok());
+        CHECK_EQ(requests[i].integer() * 2, results[i].response.integer());
+    }
+}
+
+TEST_CASE_FIXTURE(RequestAllTest, "request_each: first error cancels the remaining requests")
+{
+    spawn_server(1,
+                 [](const test::msg::Request&, test::msg::Response&)
+                 {
+                     return grpc::Status{grpc::StatusCode::NOT_FOUND, ""};
+                 });
+    std::vector<grpc::StatusCode> status_codes(requests.size(), grpc::StatusCode::OK);
+    std::size_t result_count{};
+    grpc::StatusCode final_status_code{};
+    agrpc::request_each(
+        grpc_context, &test::v1::Test::Stub::PrepareAsyncUnary, *stub, requests,
+        {test::five_seconds_from_now(), true},
+        [&](std::size_t index, grpc::Status&& status, test::msg::Response&&)
+        {
+            status_codes[index] = status.error_code();
+            ++result_count;
+        },
+        [&](grpc::Status status)
+        {
+            final_status_code = status.error_code();
+        });
+    grpc_context.run();
+    CHECK_EQ(requests.size(), result_count);
+    CHECK_EQ(grpc::StatusCode::NOT_FOUND, final_status_code);
+    CHECK_EQ(1, std::count(status_codes.begin(), status_codes.end(), grpc::StatusCode::NOT_FOUND));
+    CHECK_EQ(requests.size() - 1, std::count(status_codes.begin(), status_codes.end(), grpc::StatusCode::CANCELLED));
+}
+
+TEST_CASE_FIXTURE(RequestAllTest, "request_each: an exception thrown by on_result does not prevent completion")
+{
+    spawn_server(requests.size(),
+                 [](const test::msg::Request&, test::msg::Response&)
+                 {
+                     return grpc::Status::OK;
+                 });
+    std::size_t result_count{};
+    bool completed{};
+    agrpc::request_each(
+        grpc_context, &test::v1::Test::Stub::PrepareAsyncUnary, *stub, requests, {test::five_seconds_from_now()},
+        [&](std::size_t, grpc::Status&&, test::msg::Response&&)
+        {
+            ++result_count;
+            throw std::runtime_error{"on_result"};
+        },
+        [&](grpc::Status status)
+        {
+            CHECK(status.ok());
+            completed = true;
+        });
+    std::size_t exception_count{};
+    for (;;)
+    {
+        try
+        {
+            grpc_context.run();
+            break;
+        }
+        catch (const std::runtime_error&)
+        {
+            ++exception_count;
+        }
+    }
+    CHECK_EQ(requests.size(), result_count);
+    CHECK_EQ(requests.size(), exception_count);
+    CHECK(completed);
+}
+
+TEST_CASE_FIXTURE(test::GrpcClientServerTest, "request_all: empty range completes immediately")
+{
+    bool invoked{};
+    agrpc::request_all(grpc_context, &test::v1::Test::Stub::PrepareAsyncUnary, *stub,
+                       std::vector<test::msg::Request>{}, {},
+                       asio::bind_executor(grpc_context,
+                                           [&](std::vector<agrpc::UnaryResult<test::msg::Response>> results)
+                                           {
+                                               invoked = results.empty();
+                                           }));
+    grpc_context.run();
+    CHECK(invoked);
+}
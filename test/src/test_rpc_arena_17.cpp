@@ -0,0 +1,81 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "utils/asio_utils.hpp"
+#include "utils/doctest.hpp"
+#include "utils/grpc_context_test.hpp"
+#include "utils/time.hpp"
+
+#include <agrpc/bind_allocator.hpp>
+#include <agrpc/rpc_arena.hpp>
+#include <agrpc/wait.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "RPCArena: allocations are aligned and grow beyond the initial chunk")
+{
+    agrpc::RPCArena arena{grpc_context, 64};
+    CHECK_EQ(0, arena.used_bytes());
+    void* const first = arena.allocate(1, 1);
+    void* const second = arena.allocate(16, 16);
+    CHECK_NE(first, second);
+    CHECK_EQ(0, reinterpret_cast<std::uintptr_t>(second) % 16);
+    {
+        using Allocator = std::allocator_traits<agrpc::RPCArena::allocator_type>::rebind_alloc<int>;
+        std::vector<int, Allocator> vector{Allocator{arena.get_allocator()}};
+        for (int i{}; i < 1000; ++i)
+        {
+            vector.push_back(i);
+        }
+        CHECK_EQ(999, vector.back());
+        CHECK_LT(1000 * sizeof(int), arena.used_bytes());
+    }
+    arena.release();
+    CHECK_EQ(0, arena.used_bytes());
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "RPCArena: operations allocate from the arena")
+{
+    agrpc::RPCArena arena{grpc_context};
+    grpc::Alarm alarm;
+    bool ok{};
+    agrpc::wait(alarm, test::ten_milliseconds_from_now(),
+                asio::bind_executor(grpc_context, agrpc::bind_allocator(arena.get_allocator(),
+                                                                        [&](bool wait_ok)
+                                                                        {
+                                                                            ok = wait_ok;
+                                                                        })));
+    CHECK_LT(0, arena.used_bytes());
+    grpc_context.run();
+    CHECK(ok);
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "RPCArena: chunks are recycled by the GrpcContext's pool")
+{
+    const auto* const resource = grpc_context.get_allocator().resource();
+    const auto allocate_and_release = [&]
+    {
+        agrpc::RPCArena arena{grpc_context, 1000};
+        for (int i{}; i < 1000; ++i)
+        {
+            (void)arena.allocate(100);
+        }
+    };
+    allocate_and_release();
+    const auto upstream_allocations = resource->upstream_allocations();
+    allocate_and_release();
+    CHECK_EQ(upstream_allocations, resource->upstream_allocations());
+}
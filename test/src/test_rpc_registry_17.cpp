@@ -0,0 +1,124 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "test/v1/test.grpc.pb.h"
+#include "utils/asio_utils.hpp"
+#include "utils/doctest.hpp"
+#include "utils/grpc_client_server_test.hpp"
+#include "utils/time.hpp"
+
+#include <agrpc/rpc.hpp>
+#include <agrpc/rpc_registry.hpp>
+
+#include <optional>
+
+TEST_CASE("RPCRegistry: registrations link and unlink themselves")
+{
+    agrpc::RPCRegistry registry;
+    grpc::ServerContext server_context;
+    grpc::ClientContext client_context;
+    client_context.set_deadline(test::five_seconds_from_now());
+    {
+        agrpc::RPCRegistration server_registration{registry, server_context, "/test.v1.Test/Unary"};
+        std::optional<agrpc::RPCRegistration> client_registration;
+        client_registration.emplace(registry, client_context, "/test.v1.Test/ServerStreaming");
+        CHECK_EQ(2, registry.size());
+        const auto snapshot = registry.snapshot();
+        REQUIRE_EQ(2, snapshot.size());
+        CHECK_EQ(&server_context, snapshot[0].server_context);
+        CHECK_FALSE(snapshot[0].client_context);
+        CHECK_EQ("/test.v1.Test/Unary", snapshot[0].method);
+        CHECK_EQ(std::chrono::system_clock::time_point::max(), snapshot[0].deadline);
+        CHECK_EQ(&client_context, snapshot[1].client_context);
+        CHECK_EQ(client_context.deadline(), snapshot[1].deadline);
+        client_registration.reset();
+        CHECK_EQ(1, registry.size());
+    }
+    CHECK(registry.empty());
+}
+
+TEST_CASE("RPCRegistry: start time is the time of the last tick")
+{
+    agrpc::RPCRegistry registry;
+    const auto first_tick = std::chrono::system_clock::time_point{} + std::chrono::hours(1);
+    const auto second_tick = first_tick + std::chrono::seconds(10);
+    grpc::ClientContext client_context1;
+    grpc::ClientContext client_context2;
+    registry.tick(first_tick);
+    agrpc::RPCRegistration registration1{registry, client_context1};
+    registry.tick(second_tick);
+    agrpc::RPCRegistration registration2{registry, client_context2};
+    CHECK_EQ(first_tick, registration1.start_time());
+    CHECK_EQ(second_tick, registration2.start_time());
+    CHECK_EQ(second_tick, registry.now());
+    CHECK_EQ(1, registry.cancel_if(
+                    [&](const agrpc::RPCRegistration& registration)
+                    {
+                        return registration.start_time() < registry.now() - std::chrono::seconds(5);
+                    }));
+}
+
+TEST_CASE("RPCRegistry: cancel_if only cancels matching RPCs")
+{
+    agrpc::RPCRegistry registry;
+    grpc::ClientContext client_context1;
+    grpc::ClientContext client_context2;
+    grpc::ClientContext client_context3;
+    agrpc::RPCRegistration registration1{registry, client_context1, "tenant-a"};
+    agrpc::RPCRegistration registration2{registry, client_context2, "tenant-b"};
+    agrpc::RPCRegistration registration3{registry, client_context3, "tenant-a"};
+    std::size_t visited{};
+    registry.for_each(
+        [&](const agrpc::RPCRegistration&)
+        {
+            ++visited;
+        });
+    CHECK_EQ(3, visited);
+    CHECK_EQ(2, registry.cancel_if(
+                    [](const agrpc::RPCRegistration& registration)
+                    {
+                        return registration.method() == "tenant-a";
+                    }));
+}
+
+TEST_CASE_FIXTURE(test::GrpcClientServerTest, "RPCRegistry: cancel_if cancels a server-side RPC")
+{
+    agrpc::RPCRegistry registry;
+    grpc::Status status;
+    test::spawn_and_run(
+        grpc_context,
+        [&](const asio::yield_context& yield)
+        {
+            test::msg::Request request;
+            grpc::ServerAsyncResponseWriter<test::msg::Response> writer{&server_context};
+            CHECK(agrpc::request(&test::v1::Test::AsyncService::RequestUnary, service, server_context, request, writer,
+                                 yield));
+            agrpc::RPCRegistration registration{registry, server_context};
+            CHECK_EQ(1, registry.cancel_if(
+                            [&](const agrpc::RPCRegistration& entry)
+                            {
+                                return entry.start_time() <= std::chrono::system_clock::now();
+                            }));
+            agrpc::finish(writer, test::msg::Response{}, grpc::Status::OK, yield);
+        },
+        [&](const asio::yield_context& yield)
+        {
+            test::msg::Request request;
+            const auto reader =
+                agrpc::request(&test::v1::Test::Stub::AsyncUnary, *stub, client_context, request, grpc_context);
+            test::msg::Response response;
+            CHECK(agrpc::finish(reader, response, status, yield));
+        });
+    CHECK_EQ(grpc::StatusCode::CANCELLED, status.error_code());
+}
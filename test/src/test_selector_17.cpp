@@ -0,0 +1,86 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "utils/grpc_context_test.hpp"
+#include "utils/time.hpp"
+
+#include <agrpc/selector.hpp>
+#include <agrpc/wait.hpp>
+#include <doctest/doctest.h>
+
+#include <cstddef>
+#include <vector>
+
+#ifdef AGRPC_ASIO_HAS_CANCELLATION_SLOT
+TEST_CASE_FIXTURE(test::GrpcContextTest, "Selector: cleanup on a newly constructed selector completes immediately")
+{
+    bool invoked{};
+    agrpc::Selector<2> selector{grpc_context};
+    CHECK_FALSE(selector.is_running());
+    selector.cleanup(asio::bind_executor(grpc_context,
+                                         [&](auto&&, std::size_t, bool)
+                                         {
+                                             invoked = true;
+                                         }));
+    grpc_context.run();
+    CHECK(invoked);
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "Selector: reports the index of the operation that completed first")
+{
+    agrpc::Selector<3> selector{grpc_context};
+    grpc::Alarm slow_alarm;
+    grpc::Alarm fast_alarm;
+    grpc::Alarm medium_alarm;
+    selector.initiate(0, agrpc::wait, slow_alarm, test::five_seconds_from_now())
+        .initiate(1, agrpc::wait, fast_alarm, test::ten_milliseconds_from_now())
+        .initiate(2, agrpc::wait, medium_alarm, test::hundred_milliseconds_from_now());
+    CHECK_EQ(3, selector.running_count());
+    std::vector<std::size_t> completion_order;
+    int fast_completions{};
+    const auto next = [&](auto& self) -> void
+    {
+        selector.next(asio::bind_executor(grpc_context,
+                                          [&](auto&& ec, std::size_t index, bool ok)
+                                          {
+                                              CHECK_FALSE(ec);
+                                              completion_order.push_back(index);
+                                              if (1 == index && ++fast_completions < 3)
+                                              {
+                                                  // Re-arm only the winner, the others remain armed.
+                                                  CHECK(ok);
+                                                  selector.initiate(1, agrpc::wait, fast_alarm,
+                                                                    test::ten_milliseconds_from_now());
+                                              }
+                                              else if (2 == index)
+                                              {
+                                                  CHECK(ok);
+                                                  slow_alarm.Cancel();
+                                              }
+                                              else if (0 == index)
+                                              {
+                                                  CHECK_FALSE(ok);
+                                              }
+                                              if (selector.is_running())
+                                              {
+                                                  self(self);
+                                              }
+                                          }));
+    };
+    next(next);
+    grpc_context.run();
+    CHECK_FALSE(selector.is_running());
+    CHECK_EQ(std::vector<std::size_t>{1, 1, 1, 2, 0}, completion_order);
+}
+#endif
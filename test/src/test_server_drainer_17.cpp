@@ -0,0 +1,81 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "test/v1/test.grpc.pb.h"
+#include "utils/asio_utils.hpp"
+#include "utils/doctest.hpp"
+#include "utils/grpc_client_server_test.hpp"
+#include "utils/time.hpp"
+
+#include <agrpc/repeatedly_request.hpp>
+#include <agrpc/server_drainer.hpp>
+
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+
+TEST_CASE_FIXTURE(test::GrpcClientServerTest, "ServerDrainer: waits for in-flight RPCs and completes repeatedly_request")
+{
+    agrpc::ServerDrainer drainer{*server, grpc_context};
+    bool repeatedly_request_completed{};
+    agrpc::repeatedly_request(&test::v1::Test::AsyncService::RequestUnary, service,
+                              asio::bind_executor(grpc_context, test::NoOp{}),
+                              asio::bind_executor(grpc_context,
+                                                  [&]
+                                                  {
+                                                      repeatedly_request_completed = true;
+                                                  }));
+    std::optional<agrpc::ServerDrainer::InFlightGuard> guard{drainer.track(grpc_context)};
+    CHECK_EQ(1, drainer.in_flight_count(grpc_context));
+    grpc::Alarm alarm;
+    wait(alarm, test::hundred_milliseconds_from_now(),
+         [&](bool)
+         {
+             CHECK(drainer.is_draining());
+             guard.reset();
+         });
+    bool drained{};
+    std::thread drain_thread{[&]
+                             {
+                                 drained = drainer.drain(test::five_seconds_from_now());
+                             }};
+    grpc_context.run();
+    drain_thread.join();
+    CHECK(drained);
+    CHECK(repeatedly_request_completed);
+    CHECK_EQ(0, drainer.in_flight_count());
+}
+
+TEST_CASE_FIXTURE(test::GrpcClientServerTest, "ServerDrainer: drain of an idle server does not wait for the deadline")
+{
+    agrpc::ServerDrainer drainer{*server, grpc_context};
+    const auto start = std::chrono::steady_clock::now();
+    std::thread drain_thread{[&]
+                             {
+                                 CHECK(drainer.drain(test::five_seconds_from_now()));
+                             }};
+    grpc_context.run();
+    drain_thread.join();
+    CHECK_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+}
+
+TEST_CASE_FIXTURE(test::GrpcClientServerTest, "ServerDrainer: unknown GrpcContext is rejected")
+{
+    agrpc::ServerDrainer drainer{*server, grpc_context};
+    agrpc::GrpcContext other_grpc_context{std::make_unique<grpc::CompletionQueue>()};
+    CHECK_THROWS_AS((void)drainer.track(other_grpc_context), std::invalid_argument);
+    CHECK_THROWS_AS((void)drainer.in_flight_count(other_grpc_context), std::invalid_argument);
+    CHECK_EQ(0, drainer.in_flight_count());
+}
@@ -0,0 +1,123 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "test/v1/test.grpc.pb.h"
+#include "utils/asio_utils.hpp"
+#include "utils/doctest.hpp"
+#include "utils/grpc_client_server_test.hpp"
+#include "utils/rpc.hpp"
+
+#include <agrpc/repeatedly_request.hpp>
+#include <agrpc/rpc.hpp>
+#include <agrpc/server_middleware.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef AGRPC_ASIO_HAS_CO_AWAIT
+namespace
+{
+struct RecordingInterceptor
+{
+    std::vector<std::string>* events;
+    std::string name;
+
+    void before(grpc::ServerContext&) { events->push_back(name + ".before"); }
+
+    void after(grpc::ServerContext&) noexcept { events->push_back(name + ".after"); }
+};
+
+struct RejectingInterceptor
+{
+    std::vector<std::string>* events;
+    const bool* reject;
+
+    grpc::Status before(grpc::ServerContext&)
+    {
+        events->push_back("reject.before");
+        return *reject ? grpc::Status::CANCELLED : grpc::Status::OK;
+    }
+
+    void after(grpc::ServerContext&) noexcept { events->push_back("reject.after"); }
+};
+
+struct BeforeOnlyInterceptor
+{
+    std::vector<std::string>* events;
+
+    void before(grpc::ServerContext&) { events->push_back("before_only.before"); }
+};
+
+struct ThrowingInterceptor
+{
+    std::vector<std::string>* events;
+
+    void before(grpc::ServerContext&)
+    {
+        events->push_back("throw.before");
+        throw std::runtime_error{"test"};
+    }
+
+    void after(grpc::ServerContext&) noexcept { events->push_back("throw.after"); }
+};
+}
+
+TEST_CASE_FIXTURE(test::GrpcClientServerTest, "ServerMiddleware: interceptors run around awaitable request handler")
+{
+    std::vector<std::string> events;
+    bool reject{false};
+    agrpc::repeatedly_request(
+        &test::v1::Test::AsyncService::RequestUnary, service,
+        agrpc::ServerMiddleware{
+            asio::bind_executor(get_executor(),
+                                [&](grpc::ServerContext&, test::msg::Request& request,
+                                    grpc::ServerAsyncResponseWriter<test::msg::Response>& writer)
+                                    -> asio::awaitable<void>
+                                {
+                                    CHECK_EQ(42, request.integer());
+                                    events.emplace_back("handler");
+                                    test::msg::Response response;
+                                    response.set_integer(21);
+                                    co_await agrpc::finish(writer, response, grpc::Status::OK);
+                                }),
+            RecordingInterceptor{&events, "outer"}, RejectingInterceptor{&events, &reject},
+            BeforeOnlyInterceptor{&events}});
+    test::spawn(grpc_context,
+                [&](const asio::yield_context& yield)
+                {
+                    test::client_perform_unary_success(grpc_context, *stub, yield);
+                    reject = true;
+                    test::client_perform_unary_success(grpc_context, *stub, yield, {true});
+                    server->Shutdown();
+                });
+    grpc_context.run();
+    const std::vector<std::string> expected{
+        "outer.before", "reject.before", "before_only.before", "handler",      "reject.after",
+        "outer.after",  "outer.before",  "reject.before",      "reject.after", "outer.after"};
+    CHECK_EQ(expected, events);
+}
+
+TEST_CASE("ServerMiddleware: after hook is not invoked when before hook throws")
+{
+    std::vector<std::string> events;
+    agrpc::detail::ServerInterceptorChain<RecordingInterceptor, ThrowingInterceptor> chain{
+        RecordingInterceptor{&events, "outer"}, ThrowingInterceptor{&events}};
+    grpc::ServerContext server_context;
+    CHECK_THROWS_AS(chain.before(server_context), std::runtime_error);
+    chain.after(server_context);
+    const std::vector<std::string> expected{"outer.before", "throw.before", "outer.after"};
+    CHECK_EQ(expected, events);
+}
+#endif
@@ -0,0 +1,166 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "test/v1/test.grpc.pb.h"
+#include "utils/asio_utils.hpp"
+#include "utils/doctest.hpp"
+#include "utils/grpc_client_server_test.hpp"
+#include "utils/grpc_context_test.hpp"
+#include "utils/time.hpp"
+#include "utils/tracking_allocator.hpp"
+
+#include <agrpc/asio_grpc.hpp>
+
+#include <exception>
+#include <memory>
+#include <thread>
+
+struct StdexecTest : virtual test::GrpcContextTest
+{
+    template <class... Sender>
+    void run(Sender&&... sender)
+    {
+        const auto work_finished = [&]
+        {
+            grpc_context.work_finished();
+        };
+        grpc_context.work_started();
+        stdexec::sync_wait(stdexec::when_all(
+            stdexec::upon_stopped(
+                stdexec::then(stdexec::when_all(std::forward<Sender>(sender)...), work_finished), work_finished),
+            stdexec::then(stdexec::just(),
+                          [&]
+                          {
+                              grpc_context.run();
+                          })));
+    }
+};
+
+TEST_CASE("stdexec asio-grpc fulfills std::execution concepts")
+{
+    CHECK(stdexec::scheduler<agrpc::GrpcExecutor>);
+    using UseSender = decltype(agrpc::use_sender(std::declval<agrpc::GrpcExecutor>()));
+    using GrpcSender =
+        decltype(agrpc::wait(std::declval<grpc::Alarm&>(), std::declval<std::chrono::system_clock::time_point>(),
+                             std::declval<UseSender>()));
+    CHECK(stdexec::sender<GrpcSender>);
+    CHECK(std::is_same_v<stdexec::completion_signatures<stdexec::set_value_t(bool),
+                                                        stdexec::set_error_t(std::exception_ptr),
+                                                        stdexec::set_stopped_t()>,
+                         stdexec::completion_signatures_of_t<GrpcSender>>);
+
+    using ScheduleSender = decltype(stdexec::schedule(std::declval<agrpc::GrpcExecutor>()));
+    CHECK(stdexec::sender<ScheduleSender>);
+    CHECK(std::is_same_v<agrpc::GrpcExecutor,
+                         decltype(stdexec::get_completion_scheduler<stdexec::set_value_t>(
+                             stdexec::get_env(std::declval<ScheduleSender>())))>);
+}
+
+TEST_CASE("stdexec agrpc::bind_allocator makes the allocator available through the receiver's environment")
+{
+    struct Receiver
+    {
+        using receiver_concept = stdexec::receiver_t;
+
+        void set_value(bool) noexcept {}
+        void set_error(std::exception_ptr) noexcept {}
+        void set_stopped() noexcept {}
+    };
+    test::TrackedAllocation tracked;
+    const test::TrackingAllocator<> allocator{tracked};
+    const auto receiver = agrpc::bind_allocator(allocator, Receiver{});
+    CHECK_EQ(allocator, stdexec::get_allocator(stdexec::get_env(receiver)));
+}
+
+TEST_CASE_FIXTURE(StdexecTest, "stdexec GrpcExecutor::schedule from different thread")
+{
+    std::thread::id invoked_thread_id;
+    exec::single_thread_context ctx;
+    run(stdexec::let_value(stdexec::schedule(ctx.get_scheduler()),
+                           [&]
+                           {
+                               return stdexec::then(stdexec::schedule(get_executor()),
+                                                    [&]
+                                                    {
+                                                        invoked_thread_id = std::this_thread::get_id();
+                                                    });
+                           }));
+    CHECK_EQ(std::this_thread::get_id(), invoked_thread_id);
+}
+
+TEST_CASE_FIXTURE(StdexecTest, "stdexec agrpc::wait")
+{
+    bool ok{false};
+    grpc::Alarm alarm;
+    run(stdexec::then(agrpc::wait(alarm, test::ten_milliseconds_from_now(), use_sender()),
+                      [&](bool wait_ok)
+                      {
+                          ok = wait_ok;
+                      }));
+    CHECK(ok);
+}
+
+TEST_CASE_FIXTURE(StdexecTest, "stdexec cancel agrpc::wait through when_all stop token")
+{
+    bool ok{true};
+    grpc::Alarm alarm;
+    const auto start = std::chrono::system_clock::now();
+    run(stdexec::let_value(stdexec::schedule(get_executor()),
+                           [&]
+                           {
+                               return stdexec::when_all(
+                                   stdexec::then(agrpc::wait(alarm, test::five_seconds_from_now(), use_sender()),
+                                                 [&](bool wait_ok)
+                                                 {
+                                                     ok = wait_ok;
+                                                 }),
+                                   stdexec::just_stopped());
+                           }));
+    CHECK_FALSE(ok);
+    CHECK_LT(std::chrono::system_clock::now() - start, std::chrono::seconds(5));
+}
+
+struct StdexecClientServerTest : StdexecTest, test::GrpcClientServerTest
+{
+    test::msg::Request server_request;
+    test::msg::Response server_response;
+    grpc::ServerAsyncResponseWriter<test::msg::Response> writer{&server_context};
+    test::msg::Response client_response;
+    grpc::Status status;
+    std::unique_ptr<grpc::ClientAsyncResponseReader<test::msg::Response>> reader;
+};
+
+TEST_CASE_FIXTURE(StdexecClientServerTest, "stdexec unary RPC composed with when_all and let_value")
+{
+    run(stdexec::let_value(agrpc::request(&test::v1::Test::AsyncService::RequestUnary, service, server_context,
+                                          server_request, writer, use_sender()),
+                           [&](bool ok)
+                           {
+                               CHECK(ok);
+                               CHECK_EQ(42, server_request.integer());
+                               server_response.set_integer(24);
+                               return agrpc::finish(writer, server_response, grpc::Status::OK, use_sender());
+                           }),
+        stdexec::let_value(stdexec::just(),
+                           [&]
+                           {
+                               test::msg::Request request;
+                               request.set_integer(42);
+                               reader = agrpc::request(&test::v1::Test::Stub::AsyncUnary, *stub, client_context,
+                                                       request, grpc_context);
+                               return agrpc::finish(*reader, client_response, status, use_sender());
+                           }));
+    CHECK(status.ok());
+    CHECK_EQ(24, client_response.integer());
+}
@@ -0,0 +1,199 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "utils/asio_utils.hpp"
+#include "utils/doctest.hpp"
+#include "utils/grpc_context_test.hpp"
+#include "utils/time.hpp"
+
+#include <agrpc/alarm.hpp>
+#include <agrpc/task.hpp>
+
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+
+#ifdef AGRPC_HAS_STD_COROUTINE
+namespace
+{
+agrpc::Task<int> wait_and_double(agrpc::GrpcContext& grpc_context, int value)
+{
+    agrpc::Alarm alarm{grpc_context};
+    const bool ok = co_await alarm.wait(test::ten_milliseconds_from_now(), agrpc::use_sender);
+    CHECK(ok);
+    co_return value * 2;
+}
+
+agrpc::Task<void> wait_and_throw(agrpc::GrpcContext& grpc_context)
+{
+    auto [ok, alarm] = co_await agrpc::Alarm{grpc_context}.wait(test::ten_milliseconds_from_now(), agrpc::use_sender);
+    CHECK(ok);
+    throw std::runtime_error{"test"};
+}
+
+agrpc::Task<void> do_nothing() { co_return; }
+
+// The GrpcContext that a Task's frame has been allocated from, nullptr if it has been allocated from the heap
+template <class T>
+agrpc::GrpcContext* frame_grpc_context(const agrpc::Task<T>& task)
+{
+    auto* const frame = static_cast<std::byte*>(agrpc::detail::TaskAccess::handle(task).address());
+    return *reinterpret_cast<agrpc::GrpcContext**>(frame - agrpc::detail::TaskFrameAllocator::HEADER_SIZE);
+}
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "Task: co_spawn nested Tasks that await Alarms")
+{
+    std::exception_ptr exception;
+    int result{};
+    agrpc::co_spawn(
+        grpc_context,
+        [](agrpc::GrpcContext& grpc_context) -> agrpc::Task<int>
+        {
+            int sum{};
+            for (int i = 1; i <= 3; ++i)
+            {
+                sum += co_await wait_and_double(grpc_context, i);
+            }
+            bool caught{false};
+            try
+            {
+                co_await wait_and_throw(grpc_context);
+            }
+            catch (const std::runtime_error&)
+            {
+                caught = true;
+            }
+            CHECK(caught);
+            co_return sum;
+        }(grpc_context),
+        [&](std::exception_ptr ep, int value)
+        {
+            exception = ep;
+            result = value;
+        });
+    grpc_context.run();
+    CHECK_FALSE(exception);
+    CHECK_EQ(12, result);
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "Task: exception is passed to the completion handler of co_spawn")
+{
+    std::exception_ptr exception;
+    agrpc::co_spawn(get_executor(), wait_and_throw(grpc_context),
+                    [&](std::exception_ptr ep)
+                    {
+                        exception = ep;
+                    });
+    grpc_context.run();
+    CHECK_THROWS_AS(std::rethrow_exception(exception), std::runtime_error);
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "Task: co_spawn a Task whose result is not default constructible")
+{
+    struct Result
+    {
+        explicit Result(int value) : value_(value) {}
+
+        int value_;
+    };
+    std::optional<Result> result;
+    bool thrown{};
+    const auto make_task = [](agrpc::GrpcContext& grpc_context, bool should_throw) -> agrpc::Task<Result>
+    {
+        if (should_throw)
+        {
+            co_await wait_and_throw(grpc_context);
+        }
+        co_return Result{co_await wait_and_double(grpc_context, 21)};
+    };
+    agrpc::co_spawn(grpc_context, make_task(grpc_context, false),
+                    [&](std::exception_ptr ep, std::optional<Result> value)
+                    {
+                        CHECK_FALSE(ep);
+                        result = value;
+                    });
+    agrpc::co_spawn(grpc_context, make_task(grpc_context, true),
+                    [&](std::exception_ptr ep, std::optional<Result> value)
+                    {
+                        thrown = static_cast<bool>(ep);
+                        CHECK_FALSE(value);
+                    });
+    grpc_context.run();
+    REQUIRE(result);
+    CHECK_EQ(42, result->value_);
+    CHECK(thrown);
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "Task: frames are allocated from the GrpcContext's pool on its thread only")
+{
+    const auto off_thread = do_nothing();
+    CHECK_EQ(nullptr, frame_grpc_context(off_thread));
+    std::optional<agrpc::Task<void>> on_thread;
+    std::size_t upstream_allocations{};
+    std::size_t upstream_allocations_after_warmup{};
+    asio::post(grpc_context,
+               [&]
+               {
+                   const auto* const resource = grpc_context.get_allocator().resource();
+                   on_thread.emplace(do_nothing());
+                   static_cast<void>(do_nothing());
+                   upstream_allocations = resource->upstream_allocations();
+                   for (int i{}; i < 100; ++i)
+                   {
+                       const auto task = do_nothing();
+                       CHECK_EQ(&grpc_context, frame_grpc_context(task));
+                   }
+                   upstream_allocations_after_warmup = resource->upstream_allocations();
+               });
+    grpc_context.run();
+    REQUIRE(on_thread);
+    CHECK_EQ(&grpc_context, frame_grpc_context(*on_thread));
+    CHECK_EQ(upstream_allocations, upstream_allocations_after_warmup);
+    std::thread{[&]
+                {
+                    const auto other_thread = do_nothing();
+                    CHECK_EQ(nullptr, frame_grpc_context(other_thread));
+                }}
+        .join();
+}
+
+TEST_CASE("Task: destructing the GrpcContext destroys a suspended Task")
+{
+    auto tracker = std::make_shared<int>();
+    bool invoked{false};
+    {
+        agrpc::GrpcContext grpc_context{std::make_unique<grpc::CompletionQueue>()};
+        agrpc::co_spawn(
+            grpc_context,
+            [](agrpc::GrpcContext& grpc_context, std::shared_ptr<int>) -> agrpc::Task<void>
+            {
+                agrpc::Alarm alarm{grpc_context};
+                co_await alarm.wait(test::five_seconds_from_now(), agrpc::use_sender);
+                CHECK(false);
+            }(grpc_context, tracker),
+            [&](std::exception_ptr)
+            {
+                invoked = true;
+            });
+        grpc_context.run_until(test::hundred_milliseconds_from_now());
+        CHECK_EQ(2, tracker.use_count());
+    }
+    CHECK_EQ(1, tracker.use_count());
+    CHECK_FALSE(invoked);
+}
+#endif
@@ -0,0 +1,178 @@
+// Copyright 2022 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "test/v1/test.grpc.pb.h"
+#include "utils/asio_utils.hpp"
+#include "utils/doctest.hpp"
+#include "utils/grpc_client_server_test.hpp"
+#include "utils/time.hpp"
+
+#include <agrpc/detail/grpc_context_implementation.hpp>
+#include <agrpc/rpc.hpp>
+#include <agrpc/use_sender.hpp>
+#include <agrpc/with_timeout.hpp>
+
+#include <chrono>
+#include <memory>
+
+struct WithTimeoutTest : test::GrpcClientServerTest
+{
+    grpc::ServerAsyncReaderWriter<test::msg::Response, test::msg::Request> server_reader_writer{&server_context};
+    std::unique_ptr<grpc::ClientAsyncReaderWriter<test::msg::Request, test::msg::Response>> client_reader_writer;
+    test::msg::Response client_response;
+
+    template <class ServerFunction, class ClientFunction>
+    void spawn_and_run(ServerFunction server_function, ClientFunction client_function)
+    {
+        test::spawn_and_run(
+            grpc_context,
+            [&](const asio::yield_context& yield)
+            {
+                CHECK(agrpc::request(&test::v1::Test::AsyncService::RequestBidirectionalStreaming, service,
+                                     server_context, server_reader_writer, yield));
+                server_function(yield);
+            },
+            [&](const asio::yield_context& yield)
+            {
+                CHECK(agrpc::request(&test::v1::Test::Stub::PrepareAsyncBidirectionalStreaming, *stub, client_context,
+                                     client_reader_writer, yield));
+                client_function(yield);
+            });
+    }
+};
+
+TEST_CASE_FIXTURE(WithTimeoutTest, "with_timeout: RPC step that completes before the deadline")
+{
+    spawn_and_run(
+        [&](const asio::yield_context& yield)
+        {
+            test::msg::Request request;
+            CHECK(agrpc::with_timeout(
+                grpc_context, server_context, test::five_seconds_from_now(),
+                [&](auto&& token)
+                {
+                    return agrpc::read(server_reader_writer, request, std::move(token));
+                },
+                yield));
+            CHECK_EQ(42, request.integer());
+            CHECK(agrpc::finish(server_reader_writer, grpc::Status::OK, yield));
+        },
+        [&](const asio::yield_context& yield)
+        {
+            test::msg::Request request;
+            request.set_integer(42);
+            CHECK(agrpc::write(client_reader_writer, request, yield));
+            CHECK(agrpc::writes_done(client_reader_writer, yield));
+            grpc::Status status;
+            CHECK(agrpc::finish(client_reader_writer, status, yield));
+            CHECK(status.ok());
+        });
+}
+
+TEST_CASE_FIXTURE(WithTimeoutTest, "with_timeout: expired deadline cancels the RPC")
+{
+    const auto not_to_exceed = test::five_seconds_from_now();
+    spawn_and_run(
+        [&](const asio::yield_context& yield)
+        {
+            test::msg::Request request;
+            CHECK_FALSE(agrpc::read(server_reader_writer, request, yield));
+            agrpc::finish(server_reader_writer, grpc::Status::OK, yield);
+        },
+        [&](const asio::yield_context& yield)
+        {
+            test::msg::Response response;
+            CHECK_FALSE(agrpc::with_timeout(
+                grpc_context, client_context, test::hundred_milliseconds_from_now(),
+                [&](auto&& token)
+                {
+                    return agrpc::read(client_reader_writer, response, std::move(token));
+                },
+                yield));
+            grpc::Status status;
+            CHECK(agrpc::finish(client_reader_writer, status, yield));
+            CHECK_EQ(grpc::StatusCode::CANCELLED, status.error_code());
+        });
+    CHECK_GT(not_to_exceed, test::now());
+}
+
+TEST_CASE_FIXTURE(WithTimeoutTest, "with_timeout: steps with a duration reuse the alarm of the previous step")
+{
+    const auto& alarm_pool = agrpc::detail::GrpcContextImplementation::alarm_pool(grpc_context);
+    spawn_and_run(
+        [&](const asio::yield_context& yield)
+        {
+            test::msg::Request request;
+            for (int i{}; i != 2; ++i)
+            {
+                CHECK(agrpc::with_timeout(
+                    grpc_context, server_context, std::chrono::seconds(5),
+                    [&](auto&& token)
+                    {
+                        return agrpc::read(server_reader_writer, request, std::move(token));
+                    },
+                    yield));
+                CHECK_EQ(i, request.integer());
+                CHECK_EQ(1, alarm_pool.size());
+            }
+            CHECK(agrpc::finish(server_reader_writer, grpc::Status::OK, yield));
+        },
+        [&](const asio::yield_context& yield)
+        {
+            test::msg::Request request;
+            for (int i{}; i != 2; ++i)
+            {
+                request.set_integer(i);
+                CHECK(agrpc::write(client_reader_writer, request, yield));
+            }
+            CHECK(agrpc::writes_done(client_reader_writer, yield));
+            grpc::Status status;
+            CHECK(agrpc::finish(client_reader_writer, status, yield));
+            CHECK(status.ok());
+        });
+}
+
+#ifdef AGRPC_ASIO_HAS_SENDER_RECEIVER
+TEST_CASE_FIXTURE(WithTimeoutTest, "with_timeout: use_sender with an expired timeout cancels the RPC")
+{
+    const auto not_to_exceed = test::five_seconds_from_now();
+    bool completed{};
+    bool read_ok{true};
+    spawn_and_run(
+        [&](const asio::yield_context& yield)
+        {
+            test::msg::Request request;
+            CHECK_FALSE(agrpc::read(server_reader_writer, request, yield));
+            agrpc::finish(server_reader_writer, grpc::Status::OK, yield);
+        },
+        [&](const asio::yield_context&)
+        {
+            auto sender = agrpc::with_timeout(
+                grpc_context, client_context, std::chrono::milliseconds(100),
+                [&](auto&& token)
+                {
+                    return agrpc::read(client_reader_writer, client_response, std::move(token));
+                },
+                agrpc::use_sender);
+            asio::execution::submit(std::move(sender), test::FunctionAsReceiver{[&](bool ok)
+                                                                                {
+                                                                                    completed = true;
+                                                                                    read_ok = ok;
+                                                                                }});
+        });
+    CHECK(completed);
+    CHECK_FALSE(read_ok);
+    CHECK_GT(not_to_exceed, test::now());
+}
+#endif
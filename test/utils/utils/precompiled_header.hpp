@@ -125,6 +125,10 @@
 #if !UNIFEX_NO_COROUTINES
 #include <unifex/task.hpp>
 #endif
+#elif defined(AGRPC_STDEXEC)
+#include <exec/inline_scheduler.hpp>
+#include <exec/single_thread_context.hpp>
+#include <stdexec/execution.hpp>
 #endif
 
 #include <array>